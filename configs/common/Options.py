@@ -184,6 +184,13 @@ def addCommonOptions(parser):
     parser.add_option("-s", "--standard-switch", action="store", type="int",
         default=None,
         help="switch from timing to Detailed CPU after warmup period of <N>")
+    parser.add_option("--smarts", action="store", type="string",
+        default=None,
+        help="""<period,warmup,length> Sample the detailed CPU every
+                <period> instructions: simulate <warmup> instructions to
+                warm up its pipeline and measure the CPI of the next
+                <length>. Caches, TLBs and the branch predictor are kept
+                warm with the atomic CPU in between.""")
     parser.add_option("-p", "--prog-interval", type="str",
         help="CPU Progress Interval")
 
@@ -199,6 +206,16 @@ def addCommonOptions(parser):
     parser.add_option("-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
                 --checkpoint-restore or --take-checkpoint.""")
+    parser.add_option("--take-simpoint-checkpoints", action="store",
+        type="string", default=None,
+        help="""<simpoint file,weight file,interval-length,warmup-length>
+                Take a checkpoint warmup-length instructions ahead of each
+                SimPoint in one run.""")
+    parser.add_option("--restore-simpoint-checkpoint", action="store_true",
+        default=False,
+        help="""Restore the SimPoint checkpoint given by
+                --checkpoint-restore, simulate its warmup, reset the stats
+                and simulate its interval.""")
     parser.add_option("--at-instruction", action="store_true", default=False,
         help="""Treat value of --checkpoint-restore or --take-checkpoint as a
                 number of instructions.""")
@@ -78,7 +78,7 @@ def setCPUClass(options):
         if options.restore_with_cpu != options.cpu_type:
             CPUClass = TmpClass
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
-    elif options.fast_forward:
+    elif options.fast_forward or options.smarts:
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
@@ -129,7 +129,26 @@ def findCptDir(options, cptdir, testsys):
         fatal("checkpoint dir %s does not exist!", cptdir)
 
     cpt_starttick = 0
-    if options.at_instruction or options.simpoint:
+    if options.restore_simpoint_checkpoint:
+        cpts = listSimpointCheckpoints(cptdir)
+        cpt_num = options.checkpoint_restore
+        if cpt_num > len(cpts):
+            fatal('SimPoint checkpoint %d not found', cpt_num)
+
+        (checkpoint_dir, index, start_inst, weight, interval_length,
+         warmup_length) = cpts[cpt_num - 1]
+        print "Restoring SimPoint %d (start inst %d, weight %f)" % \
+            (index, start_inst, weight)
+
+        # Exit after the warmup and again at the end of the interval;
+        # the instructions are counted by whichever CPU runs them
+        simpoint_start_insts = [warmup_length,
+                                warmup_length + interval_length]
+        testsys.cpu[0].simpoint_start_insts = simpoint_start_insts
+        if hasattr(testsys, 'switch_cpus'):
+            testsys.switch_cpus[0].simpoint_start_insts = \
+                simpoint_start_insts
+    elif options.at_instruction or options.simpoint:
         inst = options.checkpoint_restore
         if options.simpoint:
             # assume workload 0 has the simpoint
@@ -160,6 +179,120 @@ def findCptDir(options, cptdir, testsys):
 
     return cpt_starttick, checkpoint_dir
 
+def listSimpointCheckpoints(cptdir):
+    """Returns the SimPoint checkpoints in cptdir, sorted by index.
+
+    Each entry is a tuple of (directory, index, start instruction,
+    weight, interval length, warmup length) parsed from the directory
+    name written by takeSimpointCheckpoints.
+    """
+
+    from os import listdir
+    import re
+
+    expr = re.compile('cpt\.simpoint_(\d+)_inst_(\d+)_weight_([\d\.e\-]+)'
+                      '_interval_(\d+)_warmup_(\d+)$')
+    cpts = []
+    for dir in listdir(cptdir):
+        match = expr.match(dir)
+        if match:
+            cpts.append((joinpath(cptdir, dir), int(match.group(1)),
+                         int(match.group(2)), float(match.group(3)),
+                         int(match.group(4)), int(match.group(5))))
+
+    cpts.sort(key=lambda cpt: cpt[1])
+    return cpts
+
+def parseSimpointAnalysisFile(options, testsys):
+    """Reads the SimPoint analysis output and sets up the CPU to exit
+    at the start of each checkpoint.
+
+    The simpoint file holds one "<interval> <cluster>" pair per line
+    and the weight file one "<weight> <cluster>" pair per line, as
+    written by the SimPoint tool. Each checkpoint is taken warmup
+    instructions ahead of its interval so that a restored run can warm
+    up the microarchitectural state first.
+    """
+
+    import re
+
+    simpoint_filename, weight_filename, interval_length, warmup_length = \
+        options.take_simpoint_checkpoints.split(",", 3)
+    interval_length = int(interval_length)
+    warmup_length = int(warmup_length)
+
+    expr = re.compile('([\d\.e\-]+)\s+(\d+)')
+    intervals = {}
+    for line in open(simpoint_filename):
+        match = expr.match(line)
+        if match:
+            intervals[int(match.group(2))] = int(match.group(1))
+
+    weights = {}
+    for line in open(weight_filename):
+        match = expr.match(line)
+        if match:
+            weights[int(match.group(2))] = float(match.group(1))
+
+    if not intervals:
+        fatal("No SimPoints found in %s", simpoint_filename)
+    if sorted(intervals.keys()) != sorted(weights.keys()):
+        fatal("SimPoints in %s and weights in %s do not match",
+              simpoint_filename, weight_filename)
+
+    simpoints = []
+    for cluster, interval in intervals.iteritems():
+        start_inst = interval * interval_length
+        actual_warmup = min(warmup_length, start_inst)
+        simpoints.append((interval, weights[cluster],
+                          start_inst - actual_warmup, actual_warmup))
+    simpoints.sort(key=lambda simpoint: simpoint[2])
+
+    # Every start schedules an exit, so SimPoints that share a start once
+    # the warmup is subtracted must only be listed once
+    testsys.cpu[0].simpoint_start_insts = \
+        sorted(set(simpoint[2] for simpoint in simpoints))
+
+    return simpoints, interval_length
+
+def takeSimpointCheckpoints(simpoints, interval_length, cptdir):
+    num_checkpoints = 0
+    last_start_inst = -1
+    exit_event = None
+    for index, simpoint in enumerate(simpoints):
+        interval, weight, start_inst, actual_warmup = simpoint
+
+        # SimPoints close to the start of the program may share a
+        # checkpoint position once the warmup is subtracted
+        if start_inst != last_start_inst:
+            exit_event = m5.simulate()
+            while exit_event.getCause() == "checkpoint":
+                exit_event = m5.simulate()
+
+            if exit_event.getCause() != "simpoint starting point found":
+                break
+
+        m5.checkpoint(joinpath(cptdir,
+            "cpt.simpoint_%02d_inst_%d_weight_%f_interval_%d_warmup_%d" %
+            (index, start_inst, weight, interval_length, actual_warmup)))
+        print "Checkpoint #%d written. start inst:%d weight:%f" % \
+            (num_checkpoints, start_inst, weight)
+        num_checkpoints += 1
+        last_start_inst = start_inst
+
+    print "%d SimPoint checkpoints taken" % num_checkpoints
+    return exit_event
+
+def restoreSimpointCheckpoint():
+    exit_event = m5.simulate()
+    if exit_event.getCause() == "simpoint starting point found":
+        print "Warmed up, resetting stats"
+        m5.stats.reset()
+
+        exit_event = m5.simulate()
+
+    return exit_event
+
 def scriptCheckpoints(options, maxtick, cptdir):
     if options.at_instruction or options.simpoint:
         checkpoint_inst = int(options.take_checkpoints)
@@ -259,6 +392,79 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
             exit_event = m5.simulate(maxtick - m5.curTick())
             return exit_event
 
+def simulateSkipCheckpoints(maxtick):
+    exit_event = m5.simulate(maxtick - m5.curTick())
+    while exit_event.getCause() == "checkpoint":
+        exit_event = m5.simulate(maxtick - m5.curTick())
+    return exit_event
+
+def smartsSample(testsys, options, maxtick):
+    """Periodically samples the CPI of the detailed CPUs.
+
+    The atomic CPUs run between the samples and keep the caches, TLBs
+    and branch predictors warm, so each sample only needs a short
+    detailed warmup for the pipeline state. Samples are taken every
+    period instructions of CPU 0 until the workload ends.
+    """
+
+    import math
+
+    period, warmup, length = [int(x) for x in options.smarts.split(",")]
+    if length <= 0 or warmup + length >= period:
+        fatal("--smarts needs 0 < warmup + length < period")
+
+    np = options.num_cpus
+    warm_cpus = [testsys.cpu[i] for i in xrange(np)]
+    detailed_cpus = [testsys.switch_cpus[i] for i in xrange(np)]
+    to_detailed = [(warm_cpus[i], detailed_cpus[i]) for i in xrange(np)]
+    to_warm = [(detailed_cpus[i], warm_cpus[i]) for i in xrange(np)]
+    clock = m5.ticks.fromSeconds(
+        1.0 / m5.util.convert.toFrequency(options.cpu_clock))
+
+    cause = "sample point reached"
+    cpis = []
+    while True:
+        warm_cpus[0].scheduleInstStop(0, period - warmup - length, cause)
+        exit_event = simulateSkipCheckpoints(maxtick)
+        if exit_event.getCause() != cause:
+            break
+
+        m5.switchCpus(testsys, to_detailed, verbose=False)
+        if warmup:
+            detailed_cpus[0].scheduleInstStop(0, warmup, cause)
+            exit_event = simulateSkipCheckpoints(maxtick)
+            if exit_event.getCause() != cause:
+                break
+
+        start = m5.curTick()
+        detailed_cpus[0].scheduleInstStop(0, length, cause)
+        exit_event = simulateSkipCheckpoints(maxtick)
+        if exit_event.getCause() != cause:
+            break
+        cpis.append(float(m5.curTick() - start) / clock / length)
+
+        m5.switchCpus(testsys, to_warm, verbose=False)
+
+    n = len(cpis)
+    if n < 2:
+        warn("Only %d SMARTS samples taken, no CPI estimate", n)
+        return exit_event
+
+    mean = sum(cpis) / n
+    stddev = math.sqrt(sum((cpi - mean) ** 2 for cpi in cpis) / (n - 1))
+    cov = stddev / mean
+    print "SMARTS: %d samples, CPI %f +/- %f (95%% confidence)" % \
+        (n, mean, 1.96 * stddev / math.sqrt(n))
+    print "SMARTS: coefficient of variation %f, %d samples needed for " \
+        "+/-3%% at 99.7%% confidence" % (cov, math.ceil((cov / 0.01) ** 2))
+
+    samples = open(joinpath(m5.options.outdir, "smarts.txt"), "w")
+    for cpi in cpis:
+        print >>samples, cpi
+    samples.close()
+
+    return exit_event
+
 def run(options, root, testsys, cpu_class):
     if options.checkpoint_dir:
         cptdir = options.checkpoint_dir
@@ -279,6 +485,28 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.take_simpoint_checkpoints and \
+            (options.checkpoint_restore != None or options.take_checkpoints):
+        fatal("Can't specify --take-simpoint-checkpoints with " \
+              "--checkpoint-restore or --take-checkpoints")
+
+    if options.take_simpoint_checkpoints and options.num_cpus > 1:
+        fatal("SimPoint checkpoints are only supported with one CPU")
+
+    if options.restore_simpoint_checkpoint and \
+            options.checkpoint_restore == None:
+        fatal("--restore-simpoint-checkpoint requires --checkpoint-restore")
+
+    if options.smarts:
+        if options.fast_forward or options.standard_switch or \
+                options.repeat_switch or options.take_checkpoints:
+            fatal("Can't specify --smarts with --fast-forward, " \
+                  "--standard-switch, --repeat-switch or --take-checkpoints")
+        if options.fastmem or not options.caches:
+            fatal("--smarts needs caches to warm and can't use --fastmem")
+        if not isinstance(testsys.cpu[0], AtomicSimpleCPU):
+            fatal("--smarts warms up with the atomic CPU")
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -306,6 +534,9 @@ def run(options, root, testsys, cpu_class):
             # Add checker cpu if selected
             if options.checker:
                 switch_cpus[i].addCheckerCpu()
+            # Train the detailed CPU's branch predictor while warming
+            if options.smarts:
+                testsys.cpu[i].branchPred = switch_cpus[i].branchPred
 
         testsys.switch_cpus = switch_cpus
         switch_cpu_list = [(testsys.cpu[i], switch_cpus[i]) for i in xrange(np)]
@@ -411,6 +642,10 @@ def run(options, root, testsys, cpu_class):
             for i in xrange(np):
                 testsys.cpu[i].max_insts_any_thread = offset
 
+    if options.take_simpoint_checkpoints != None:
+        simpoints, interval_length = parseSimpointAnalysisFile(options,
+                                                               testsys)
+
     checkpoint_dir = None
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
@@ -451,7 +686,7 @@ def run(options, root, testsys, cpu_class):
         fatal("Bad maxtick (%d) specified: " \
               "Checkpoint starts starts from tick: %d", maxtick, cpt_starttick)
 
-    if options.standard_switch or cpu_class:
+    if (options.standard_switch or cpu_class) and not options.smarts:
         if options.standard_switch:
             print "Switch at instruction count:%s" % \
                     str(testsys.cpu[0].max_insts_any_thread)
@@ -491,7 +726,12 @@ def run(options, root, testsys, cpu_class):
         else:
             cptdir = getcwd()
 
-    if options.take_checkpoints != None :
+    if options.take_simpoint_checkpoints != None:
+        exit_event = takeSimpointCheckpoints(simpoints, interval_length,
+                                             cptdir)
+    elif options.restore_simpoint_checkpoint:
+        exit_event = restoreSimpointCheckpoint()
+    elif options.take_checkpoints != None :
         # Checkpoints being taken via the command line at <when> and at
         # subsequent periods of <period>.  Checkpoint instructions
         # received from the benchmark running are ignored and skipped in
@@ -504,7 +744,9 @@ def run(options, root, testsys, cpu_class):
 
         # If checkpoints are being taken, then the checkpoint instruction
         # will occur in the benchmark code it self.
-        if options.repeat_switch and maxtick > options.repeat_switch:
+        if options.smarts:
+            exit_event = smartsSample(testsys, options, maxtick)
+        elif options.repeat_switch and maxtick > options.repeat_switch:
             exit_event = repeatSwitch(testsys, repeat_switch_cpu_list,
                                       maxtick, options.repeat_switch)
         else:
@@ -136,8 +136,14 @@ for ruby_port in system.ruby._cpu_ports:
 root = Root( full_system = False, system = system )
 root.system.mem_mode = 'timing'
 
-# Not much point in this being higher than the L1 latency
-m5.ticks.setGlobalFrequency('1ns')
+# Not much point in this being higher than the L1 latency. Parallel
+# network regions need a quantum below one Ruby cycle, so they keep the
+# default resolution.
+if not options.network_parallel:
+    m5.ticks.setGlobalFrequency('1ns')
+
+if options.network_parallel:
+    root.sim_quantum = Ruby.network_sim_quantum(options)
 
 # instantiate configuration
 m5.instantiate()
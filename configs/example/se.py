@@ -261,4 +261,8 @@ else:
     MemConfig.config_mem(options, system)
 
 root = Root(full_system = False, system = system)
+# The quantum also delays the end of the simulation, so partitioned
+# networks get it whether they run in parallel or not
+if options.ruby and (options.network_regions > 1 or options.network_parallel):
+    root.sim_quantum = Ruby.network_sim_quantum(options)
 Simulation.run(options, root, system, FutureClass)
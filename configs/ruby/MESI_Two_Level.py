@@ -103,6 +103,7 @@ def create_system(options, system, dma_ports, ruby_system):
                                 icache = l1i_cache,
                                 dcache = l1d_cache,
                                 clk_domain=system.cpu[i].clk_domain,
+                                fast_load_hits = True,
                                 ruby_system = ruby_system)
 
         l1_cntrl.sequencer = cpu_seq
@@ -89,6 +89,8 @@ def create_system(options, system, dma_ports, ruby_system):
                                 icache = cache,
                                 dcache = cache,
                                 clk_domain=system.cpu[i].clk_domain,
+                                fast_load_hits = True,
+                                fast_store_hits = True,
                                 ruby_system = ruby_system)
 
         l1_cntrl.sequencer = cpu_seq
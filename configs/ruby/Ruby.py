@@ -43,7 +43,7 @@ import math
 import m5
 from m5.objects import *
 from m5.defines import buildEnv
-from m5.util import addToPath, fatal
+from m5.util import addToPath, convert, fatal
 
 addToPath('../topologies')
 
@@ -69,6 +69,12 @@ def define_options(parser):
                       choices=['fixed', 'flexible'], help="'fixed'|'flexible'")
     parser.add_option("--network-fault-model", action="store_true", default=False,
                       help="enable network fault model: see src/mem/ruby/network/fault_model/")
+    parser.add_option("--network-regions", type="int", default=1,
+                      help="split the routers of a fixed garnet network into \
+                            this many regions of consecutive router ids")
+    parser.add_option("--network-parallel", action="store_true",
+                      default=False,
+                      help="simulate each network region on its own thread")
 
     # ruby mapping options
     parser.add_option("--numa-high-bit", type="int", default=0,
@@ -87,10 +93,28 @@ def define_options(parser):
 
     parser.add_option("--ruby_stats", type="string", default="ruby.stats")
 
+    parser.add_option("--ruby-warmup-traces", type="string", default="",
+                      help="comma-separated packet traces, one per cpu, \
+                            e.g. from CommMonitors in an atomic-mode run, \
+                            to warm up the caches with at startup")
+
     protocol = buildEnv['PROTOCOL']
     exec "import %s" % protocol
     eval("%s.define_options(parser)" % protocol)
 
+def network_sim_quantum(options):
+    """ Returns the simulation quantum, in ticks, for simulating the
+        network regions in parallel. Links between regions take at
+        least one Ruby cycle, which is the lookahead between them, and
+        the quantum has to be shorter than the lookahead.
+    """
+    ruby_cycle = int(round(m5.ticks.tps *
+                           convert.anyToLatency(options.ruby_clock)))
+    if ruby_cycle < 2:
+        fatal("A Ruby cycle of %d ticks is too short for a quantum "
+              "below it" % ruby_cycle)
+    return ruby_cycle - 1
+
 def create_topology(controllers, options):
     """ Called from create_system in configs/ruby/<protocol>.py
         Must return an object which is a subclass of BaseTopology
@@ -168,6 +192,18 @@ def create_system(options, system, piobus = None, dma_ports = []):
         network.enable_fault_model = True
         network.fault_model = FaultModel()
 
+    if options.network_regions > 1 or options.network_parallel:
+        if options.garnet_network != "fixed":
+            fatal("Network regions need the fixed garnet network")
+        num_routers = len(network.routers)
+        for (i, router) in enumerate(network.routers):
+            region = i * options.network_regions / num_routers
+            router.region = region
+            # Controllers and network interfaces stay on event queue 0
+            # with the routers of region 0
+            if options.network_parallel:
+                router.eventq_index = region
+
     # Loop through the directory controlers.
     # Determine the total memory size of the ruby system and verify it is equal
     # to physmem.  However, if Ruby memory is using sparse memory in SE
@@ -205,6 +241,14 @@ def create_system(options, system, piobus = None, dma_ports = []):
             if buildEnv['TARGET_ISA'] == "x86":
                 cpu_seq.pio_slave_port = piobus.master
 
+    if options.ruby_warmup_traces:
+        traces = options.ruby_warmup_traces.split(",")
+        if len(traces) > len(cpu_sequencers):
+            fatal("Got %d warmup traces for %d cpu sequencers" %
+                  (len(traces), len(cpu_sequencers)))
+        for (cpu_seq, trace) in zip(cpu_sequencers, traces):
+            cpu_seq.warmup_trace = trace
+
     ruby._cpu_ports = cpu_sequencers
     ruby.num_of_sequencers = len(cpu_sequencers)
     ruby.random_seed    = options.random_seed
@@ -42,6 +42,7 @@
  *          Steve Reinhardt
  */
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -366,6 +367,12 @@ TLB::takeOverFrom(BaseTLB *_otlb)
         stage2Req = otlb->stage2Req;
         bootUncacheability = otlb->bootUncacheability;
 
+        // Carry the translations over, most recently used first, so
+        // that the TLB does not have to be warmed up again after
+        // every CPU switch
+        int entries = std::min(size, otlb->size);
+        std::copy(otlb->table, otlb->table + entries, table);
+
         /* Sync the stage2 MMU if they exist in both
          * the old CPU and the new
          */
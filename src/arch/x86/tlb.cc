@@ -38,6 +38,7 @@
  */
 
 #include <cstring>
+#include <map>
 
 #include "arch/generic/mmapped_ipr.hh"
 #include "arch/x86/insts/microldstop.hh"
@@ -142,6 +143,27 @@ TLB::flushAll()
     }
 }
 
+void
+TLB::takeOverFrom(BaseTLB *_otlb)
+{
+    TLB *otlb = dynamic_cast<TLB *>(_otlb);
+    if (!otlb)
+        panic("Incompatible TLB type!");
+
+    // Carry the translations over, oldest first so that the LRU order
+    // survives, so that the TLB does not have to be warmed up again
+    // after every CPU switch
+    std::map<uint64_t, TlbEntry *> entries;
+    for (unsigned i = 0; i < otlb->size; i++) {
+        if (otlb->tlb[i].trieHandle)
+            entries[otlb->tlb[i].lruSeq] = &otlb->tlb[i];
+    }
+
+    std::map<uint64_t, TlbEntry *>::iterator it;
+    for (it = entries.begin(); it != entries.end(); ++it)
+        insert(it->second->vaddr, *it->second);
+}
+
 void
 TLB::setConfigAddress(uint32_t addr)
 {
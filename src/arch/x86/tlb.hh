@@ -75,7 +75,7 @@ namespace X86ISA
         typedef X86TLBParams Params;
         TLB(const Params *p);
 
-        void takeOverFrom(BaseTLB *otlb) {}
+        void takeOverFrom(BaseTLB *otlb);
 
         TlbEntry *lookup(Addr va, bool update_lru = true);
 
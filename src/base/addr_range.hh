@@ -174,6 +174,11 @@ class AddrRange
      */
     Addr start() const { return _start; }
 
+    /**
+     * Get the end address of the range.
+     */
+    Addr end() const { return _end; }
+
     /**
      * Get a string representation of the range. This could
      * alternatively be implemented as a operator<<, but at the moment
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_ADDR_RANGE_DECODER_HH__
+#define __BASE_ADDR_RANGE_DECODER_HH__
+
+#include <algorithm>
+#include <vector>
+
+#include "base/addr_range_map.hh"
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+/**
+ * A flat, precomputed decode structure on top of an AddrRangeMap,
+ * turning the O(log n) interval tree walk into a short, fixed-depth
+ * radix table walk.
+ *
+ * The address space is split in 1 GB regions, each of which is
+ * either empty, entirely mapped to a single range, entirely mapped to
+ * a group of interleaved ranges, or subdivided in 512 smaller
+ * regions, down to 4 kB pages. Interleaved groups are decoded by
+ * extracting the interleaving bits from the address. The few pages
+ * that contain range boundaries at sub-page granularity, and any
+ * address beyond the covered part of the address space, fall back to
+ * the interval tree.
+ *
+ * The decoder keeps iterators into the map, and therefore has to be
+ * rebuilt whenever the map changes.
+ */
+template <typename V>
+class AddrRangeDecoder
+{
+  public:
+    typedef typename AddrRangeMap<V>::const_iterator const_iterator;
+
+    AddrRangeDecoder(const AddrRangeMap<V> &_map)
+        : map(_map), capped(false)
+    { }
+
+    /**
+     * Rebuild the decode tables from the current contents of the map.
+     */
+    void
+    build()
+    {
+        root.clear();
+        nodes.clear();
+        targets.clear();
+        groups.clear();
+        capped = false;
+
+        std::vector<Span> spans;
+        for (const_iterator r = map.begin(); r != map.end(); ++r) {
+            // all the stripes of an interleaved range are adjacent
+            // in the map and make up one group
+            if (r->first.interleaved()) {
+                if (spans.empty() || !spans.back().interleaved ||
+                    !r->first.mergesWith(spans.back().first->first)) {
+                    spans.push_back(Span(r, groups.size()));
+                    groups.push_back(IntlvGroup(r->first, map.end()));
+                }
+                addStripe(groups.back(), r);
+            } else {
+                spans.push_back(Span(r, targets.size()));
+                targets.push_back(r);
+            }
+        }
+
+        if (spans.empty())
+            return;
+
+        Addr max_end = 0;
+        for (const auto &s : spans)
+            max_end = std::max(max_end, s.end);
+
+        Addr num_regions = (max_end >> rootShift) + 1;
+        if (num_regions > maxRootEntries) {
+            num_regions = maxRootEntries;
+            capped = true;
+        }
+
+        root.resize(num_regions);
+        size_t first = 0;
+        for (Addr i = 0; i < num_regions; ++i) {
+            Addr lo = i << rootShift;
+            root[i] = buildEntry(spans, lo, rootShift, first);
+        }
+    }
+
+    /**
+     * Find the range containing an address.
+     *
+     * @param a Address to look up
+     * @return Iterator to the range in the map, or the end of the map
+     */
+    const_iterator
+    find(Addr a) const
+    {
+        Addr slot = a >> rootShift;
+        if (slot >= root.size())
+            return capped ? map.find(a) : map.end();
+
+        const Entry *e = &root[slot];
+        unsigned shift = rootShift;
+        while (e->kind == Node) {
+            shift -= nodeBits;
+            e = &nodes[(e->index << nodeBits) + ((a >> shift) & nodeMask)];
+        }
+
+        switch (e->kind) {
+          case Direct:
+            return targets[e->index];
+          case Interleaved: {
+              const IntlvGroup &g = groups[e->index];
+              return g.stripes[(a >> g.shift) & g.mask];
+          }
+          case Fallback:
+            return map.find(a);
+          default:
+            return map.end();
+        }
+    }
+
+  private:
+    static const unsigned rootShift = 30;
+    static const unsigned nodeBits = 9;
+    static const unsigned nodeMask = (1 << nodeBits) - 1;
+    static const unsigned leafShift = rootShift - 2 * nodeBits;
+    /** Ranges above 1 TB are left to the interval tree. */
+    static const Addr maxRootEntries = ULL(1) << 10;
+
+    enum Kind { Empty, Direct, Interleaved, Node, Fallback };
+
+    /** A decode table entry, the index depends on the kind. */
+    struct Entry {
+        uint32_t kind;
+        uint32_t index;
+        Entry(Kind _kind = Empty, uint32_t _index = 0)
+            : kind(_kind), index(_index)
+        { }
+    };
+
+    /** The stripes of a group of interleaved ranges. */
+    struct IntlvGroup {
+        unsigned shift;
+        Addr mask;
+        std::vector<const_iterator> stripes;
+        IntlvGroup(const AddrRange &r, const_iterator none)
+            : shift(floorLog2(r.granularity())), mask(r.stripes() - 1),
+              stripes(r.stripes(), none)
+        { }
+    };
+
+    /**
+     * A contiguous part of the address space, covered either by a
+     * single range or by a group of interleaved ranges.
+     */
+    struct Span {
+        Addr start;
+        Addr end;
+        const_iterator first;
+        bool interleaved;
+        uint32_t index;
+        Span(const_iterator r, uint32_t _index)
+            : start(r->first.start()), end(r->first.end()), first(r),
+              interleaved(r->first.interleaved()), index(_index)
+        { }
+    };
+
+    /**
+     * Work out which stripe of its group an interleaved range is, by
+     * probing the first address of the range with each interleaving
+     * value. The start of the range need not be aligned to a set of
+     * stripes, so the stripes are laid out from the aligned base
+     * below it, and a stripe that ends before the start is probed in
+     * the next set.
+     */
+    void
+    addStripe(IntlvGroup &g, const_iterator r)
+    {
+        const AddrRange &range = r->first;
+        Addr stripe_size = ULL(1) << g.shift;
+        Addr set_size = (g.mask + 1) << g.shift;
+        Addr base = range.start() & ~(set_size - 1);
+        for (Addr k = 0; k <= g.mask; ++k) {
+            Addr a = base + (k << g.shift);
+            if (a + stripe_size <= range.start())
+                a += set_size;
+            else
+                a = std::max(a, range.start());
+            if (a >= range.start() && range.contains(a)) {
+                g.stripes[k] = r;
+                return;
+            }
+        }
+    }
+
+    /**
+     * Create the entry for the region of size 1 << shift starting at
+     * lo. The spans are sorted and do not overlap, and first is the
+     * first span that ends at or after lo; it is advanced past the
+     * spans that end within the region.
+     */
+    Entry
+    buildEntry(const std::vector<Span> &spans, Addr lo, unsigned shift,
+               size_t &first)
+    {
+        Addr hi = lo + (ULL(1) << shift) - 1;
+
+        while (first < spans.size() && spans[first].end < lo)
+            ++first;
+
+        size_t last = first;
+        while (last < spans.size() && spans[last].start <= hi)
+            ++last;
+
+        if (first == last)
+            return Entry(Empty);
+
+        const Span &s = spans[first];
+        if (last - first == 1 && s.start <= lo && s.end >= hi)
+            return Entry(s.interleaved ? Interleaved : Direct, s.index);
+
+        if (shift == leafShift)
+            return Entry(Fallback);
+
+        uint32_t node = nodes.size() >> nodeBits;
+        nodes.resize(nodes.size() + (1 << nodeBits));
+        Addr child_shift = shift - nodeBits;
+        for (Addr c = 0; c <= nodeMask; ++c) {
+            Entry e = buildEntry(spans, lo + (c << child_shift), child_shift,
+                                 first);
+            nodes[(node << nodeBits) + c] = e;
+        }
+        return Entry(Node, node);
+    }
+
+    const AddrRangeMap<V> &map;
+
+    /** Entries for the 1 GB regions. */
+    std::vector<Entry> root;
+
+    /** The subdivided regions, 512 entries each. */
+    std::vector<Entry> nodes;
+
+    /** Ranges that entirely cover a region. */
+    std::vector<const_iterator> targets;
+
+    /** Groups of interleaved ranges that entirely cover a region. */
+    std::vector<IntlvGroup> groups;
+
+    /** The map has ranges beyond the part covered by the root. */
+    bool capped;
+};
+
+#endif //__BASE_ADDR_RANGE_DECODER_HH__
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_CIRCULAR_QUEUE_HH__
+#define __BASE_CIRCULAR_QUEUE_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "base/intmath.hh"
+
+/**
+ * A FIFO of elements kept in a circular buffer, meant as a
+ * replacement for std::list where elements are only added at the
+ * back, and removed at the front or the back.
+ *
+ * Every element is identified by a monotonically increasing index
+ * that never changes while the element is in the queue, and the
+ * iterators are nothing more than a queue and an index. Iterators
+ * therefore stay valid across insertions and removals of other
+ * elements, just like for a list, but without any per-element
+ * allocation, and with the elements contiguous in memory.
+ *
+ * The buffer is allocated up front with the given capacity (rounded
+ * up to a power of two). Should it fill up, the capacity is doubled,
+ * which keeps all indices and iterators valid.
+ *
+ * Removed elements are overwritten with a default-constructed
+ * element, so that reference-counted pointers are released as soon
+ * as they leave the queue.
+ */
+template <class T>
+class CircularQueue
+{
+  public:
+
+    class iterator
+        : public std::iterator<std::bidirectional_iterator_tag, T>
+    {
+      private:
+
+        CircularQueue* queue;
+        uint64_t idx;
+
+      public:
+
+        iterator() : queue(nullptr), idx(0) { }
+
+        iterator(CircularQueue* _queue, uint64_t _idx)
+            : queue(_queue), idx(_idx) { }
+
+        T& operator*() const { return (*queue)[idx]; }
+        T* operator->() const { return &(*queue)[idx]; }
+
+        iterator& operator++() { ++idx; return *this; }
+        iterator operator++(int) { iterator it(*this); ++idx; return it; }
+        iterator& operator--() { --idx; return *this; }
+        iterator operator--(int) { iterator it(*this); --idx; return it; }
+
+        bool operator==(const iterator& other) const
+        { return queue == other.queue && idx == other.idx; }
+
+        bool operator!=(const iterator& other) const
+        { return !(*this == other); }
+
+        /** The index of the element, stable for its lifetime */
+        uint64_t index() const { return idx; }
+    };
+
+  private:
+
+    std::vector<T> buf;
+    uint64_t mask;
+
+    /** Index of the first element */
+    uint64_t head;
+
+    /** Index one past the last element */
+    uint64_t tail;
+
+    void grow()
+    {
+        std::vector<T> new_buf(buf.size() * 2);
+        uint64_t new_mask = new_buf.size() - 1;
+        for (uint64_t i = head; i != tail; ++i)
+            new_buf[i & new_mask] = buf[i & mask];
+        buf.swap(new_buf);
+        mask = new_mask;
+    }
+
+  public:
+
+    explicit CircularQueue(size_t capacity = 1)
+        : buf(capacity > 1 ? 1ULL << ceilLog2(capacity) : 1),
+          mask(buf.size() - 1), head(0), tail(0)
+    { }
+
+    size_t capacity() const { return buf.size(); }
+    size_t size() const { return tail - head; }
+    bool empty() const { return head == tail; }
+    bool full() const { return size() == capacity(); }
+
+    iterator begin() { return iterator(this, head); }
+    iterator end() { return iterator(this, tail); }
+
+    /** Is the element at the given index still in the queue */
+    bool contains(uint64_t idx) const { return idx >= head && idx < tail; }
+
+    T& operator[](uint64_t idx)
+    {
+        assert(contains(idx));
+        return buf[idx & mask];
+    }
+
+    T& front() { assert(!empty()); return buf[head & mask]; }
+    T& back() { assert(!empty()); return buf[(tail - 1) & mask]; }
+
+    void push_back(const T& elem)
+    {
+        if (full())
+            grow();
+        buf[tail++ & mask] = elem;
+    }
+
+    void pop_front()
+    {
+        assert(!empty());
+        buf[head++ & mask] = T();
+    }
+
+    void pop_back()
+    {
+        assert(!empty());
+        buf[--tail & mask] = T();
+    }
+
+    /**
+     * Remove the given element and everything after it, i.e. squash
+     * the youngest elements of the queue.
+     */
+    void truncate(iterator it)
+    {
+        assert(it.index() >= head && it.index() <= tail);
+        while (tail != it.index())
+            pop_back();
+    }
+
+    void clear()
+    {
+        while (!empty())
+            pop_front();
+    }
+};
+
+#endif // __BASE_CIRCULAR_QUEUE_HH__
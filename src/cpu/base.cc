@@ -373,10 +373,6 @@ BaseCPU::switchOut()
     _switchedOut = true;
     if (profileEvent && profileEvent->scheduled())
         deschedule(profileEvent);
-
-    // Flush all TLBs in the CPU to avoid having stale translations if
-    // it gets switched in later.
-    flushTLBs();
 }
 
 void
@@ -501,6 +497,11 @@ BaseCPU::takeOverFrom(BaseCPU *oldCPU)
     BaseSlavePort &data_peer_port = oldCPU->getDataPort().getSlavePort();
     oldCPU->getDataPort().unbind();
     getDataPort().bind(data_peer_port);
+
+    // The translations have been handed over to the new CPU, so flush
+    // the old CPU's TLBs to avoid having stale translations if it
+    // gets switched in later.
+    oldCPU->flushTLBs();
 }
 
 void
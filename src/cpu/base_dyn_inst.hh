@@ -52,6 +52,7 @@
 #include <queue>
 
 #include "arch/utility.hh"
+#include "base/circular_queue.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
@@ -89,7 +90,7 @@ class BaseDynInst : public ExecContext, public RefCounted
     typedef RefCountingPtr<BaseDynInst<Impl> > BaseDynInstPtr;
 
     // The list of instructions iterator type.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename CircularQueue<DynInstPtr>::iterator ListIt;
 
     enum {
         MaxInstSrcRegs = TheISA::MaxInstSrcRegs,        /// Max source regs
@@ -235,6 +236,9 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** Store queue index. */
     int16_t sqIdx;
 
+    /** Position in the instruction queue's list of its thread. */
+    uint64_t iqIdx;
+
 
     /////////////////////// TLB Miss //////////////////////
     /**
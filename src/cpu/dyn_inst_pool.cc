@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/dyn_inst_pool.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+#include "base/misc.hh"
+
+DynInstPool::DynInstPool(unsigned chunks_per_slab)
+    : objSize(0), chunksPerSlab(chunks_per_slab), freeList(NULL),
+      numLive(0), numPeak(0), orphaned(false)
+{
+    fatal_if(chunksPerSlab == 0, "Dynamic instruction slabs cannot be "
+             "empty\n");
+}
+
+DynInstPool::~DynInstPool()
+{
+    if (numLive == 0) {
+        for (auto s : slabs)
+            ::operator delete(s);
+        return;
+    }
+
+    // Instructions may outlive the CPU that created them, e.g. when
+    // they are still referenced by other objects being torn down.
+    // Hand the storage over to a pool of its own, and point the
+    // chunks at it, so that it goes away with the last instruction.
+    DynInstPool *heir = new DynInstPool(chunksPerSlab);
+    heir->objSize = objSize;
+    heir->slabs.swap(slabs);
+    heir->freeList = freeList;
+    heir->numLive = numLive;
+    heir->numPeak = numPeak;
+    heir->orphaned = true;
+
+    size_t chunk_size = alignedChunkSize();
+    for (auto slab : heir->slabs) {
+        for (unsigned i = 0; i < chunksPerSlab; ++i)
+            reinterpret_cast<Header*>(slab + i * chunk_size)->pool = heir;
+    }
+}
+
+size_t
+DynInstPool::alignedChunkSize() const
+{
+    // round the chunks up so that each header stays aligned
+    return (chunkSize(objSize) + sizeof(Header) - 1) / sizeof(Header) *
+        sizeof(Header);
+}
+
+void
+DynInstPool::grow()
+{
+    size_t chunk_size = alignedChunkSize();
+
+    char *slab = static_cast<char*>(::operator new(chunk_size *
+                                                   chunksPerSlab));
+    slabs.push_back(slab);
+
+    // thread the new chunks onto the free list in address order
+    for (unsigned i = chunksPerSlab; i > 0; --i) {
+        Header *hdr = reinterpret_cast<Header*>(slab + (i - 1) * chunk_size);
+        hdr->pool = this;
+        FreeChunk *chunk = reinterpret_cast<FreeChunk*>(hdr + 1);
+        chunk->next = freeList;
+        freeList = chunk;
+    }
+}
+
+void *
+DynInstPool::allocate(size_t size)
+{
+    if (objSize == 0)
+        objSize = std::max(size, sizeof(FreeChunk));
+    panic_if(size > objSize, "Dynamic instruction of %d bytes allocated "
+             "from a pool of %d byte instructions\n", size, objSize);
+
+    if (!freeList)
+        grow();
+
+    FreeChunk *chunk = freeList;
+    freeList = chunk->next;
+
+    if (++numLive > numPeak)
+        numPeak = numLive;
+
+    return chunk;
+}
+
+void *
+DynInstPool::allocateHeap(size_t size)
+{
+    Header *hdr = static_cast<Header*>(::operator new(chunkSize(size)));
+    hdr->pool = NULL;
+    return hdr + 1;
+}
+
+void
+DynInstPool::release(void *obj)
+{
+    if (!obj)
+        return;
+
+    Header *hdr = static_cast<Header*>(obj) - 1;
+    DynInstPool *pool = hdr->pool;
+
+    if (!pool) {
+        ::operator delete(hdr);
+        return;
+    }
+
+    assert(pool->numLive != 0);
+    --pool->numLive;
+
+    FreeChunk *chunk = static_cast<FreeChunk*>(obj);
+    chunk->next = pool->freeList;
+    pool->freeList = chunk;
+
+    // the owner of an orphaned pool is gone, so the last instruction
+    // takes the storage with it
+    if (pool->orphaned && pool->numLive == 0)
+        delete pool;
+}
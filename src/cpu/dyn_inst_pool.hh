@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_DYN_INST_POOL_HH__
+#define __CPU_DYN_INST_POOL_HH__
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * A slab allocator for the dynamic instructions of a CPU. Dynamic
+ * instructions are created for every fetched instruction, including
+ * the ones on the wrong path, and are freed as soon as they commit or
+ * get squashed. Rather than going to the heap for every one of them,
+ * the pool hands out fixed-size chunks carved out of large slabs, and
+ * keeps released chunks on a free list for reuse.
+ *
+ * Each chunk starts with a small header recording the pool it came
+ * from, so that an instruction can be released without knowing which
+ * CPU created it. Instructions created outside of any pool (e.g. the
+ * Minor bubble instruction) come from the heap, and have a NULL pool
+ * in their header.
+ *
+ * The pool is meant to be used through class-specific operator new
+ * and delete, see BaseO3DynInst and MinorDynInst.
+ */
+class DynInstPool
+{
+  private:
+
+    /** Chunk header, padded to keep the object suitably aligned */
+    union Header
+    {
+        DynInstPool *pool;
+        long double align;
+    };
+
+    /** Released chunks are linked through their object storage */
+    struct FreeChunk
+    {
+        FreeChunk *next;
+    };
+
+    /** Object size of the chunks, set by the first allocation */
+    size_t objSize;
+
+    /** Chunks allocated at once when the free list runs dry */
+    const unsigned chunksPerSlab;
+
+    std::vector<char*> slabs;
+
+    FreeChunk *freeList;
+
+    /** Number of chunks currently handed out */
+    unsigned numLive;
+
+    /** Highest number of chunks handed out at any one time */
+    unsigned numPeak;
+
+    /**
+     * Set for a pool that took over the storage of a destroyed pool
+     * with live instructions, and deletes itself with the last one.
+     */
+    bool orphaned;
+
+    /** Carve another slab into chunks and put them on the free list */
+    void grow();
+
+    /** Size of the chunks, including the header and alignment */
+    size_t alignedChunkSize() const;
+
+    static size_t chunkSize(size_t obj_size)
+    { return sizeof(Header) + obj_size; }
+
+  public:
+
+    DynInstPool(unsigned chunks_per_slab = 256);
+
+    ~DynInstPool();
+
+    /**
+     * Allocate storage for an instruction from the pool.
+     *
+     * @param size Size of the instruction, the same for all allocations
+     * @return Storage for the instruction
+     */
+    void *allocate(size_t size);
+
+    /**
+     * Allocate storage for an instruction outside of any pool.
+     */
+    static void *allocateHeap(size_t size);
+
+    /**
+     * Release the storage of an instruction, either back to the pool
+     * it came from or to the heap. If the pool has been destroyed in
+     * the meantime, the storage is freed with the last instruction.
+     */
+    static void release(void *obj);
+
+    /** Number of instructions currently allocated from the pool */
+    unsigned live() const { return numLive; }
+
+    /** Highest number of instructions allocated at any one time */
+    unsigned peak() const { return numPeak; }
+
+    /** Number of instructions the pool can hold without growing */
+    size_t capacity() const { return slabs.size() * chunksPerSlab; }
+};
+
+#endif // __CPU_DYN_INST_POOL_HH__
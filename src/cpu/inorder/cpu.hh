@@ -62,7 +62,6 @@
 #include "cpu/inorder/pipeline_traits.hh"
 #include "cpu/inorder/reg_dep_map.hh"
 #include "cpu/inorder/thread_state.hh"
-#include "cpu/o3/dep_graph.hh"
 #include "cpu/o3/rename_map.hh"
 #include "cpu/activity.hh"
 #include "cpu/base.hh"
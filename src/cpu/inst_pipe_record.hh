@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_INST_PIPE_RECORD_HH__
+#define __CPU_INST_PIPE_RECORD_HH__
+
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/static_inst_fwd.hh"
+
+/**
+ * The pipeline timeline of an instruction, handed to the listeners of
+ * a CPU's PipeRecord probe point when the instruction leaves the
+ * pipeline. A stage tick is 0 if the instruction never reached the
+ * stage, either because it was squashed or because the CPU model has
+ * no such stage.
+ */
+struct InstPipeRecord
+{
+    ThreadID tid;
+    InstSeqNum seqNum;
+    Addr pc;
+    MicroPC upc;
+    StaticInstPtr staticInst;
+
+    Tick fetch;
+    Tick decode;
+    Tick rename;
+    Tick dispatch;
+    Tick issue;
+    Tick complete;
+    Tick commit;
+    /** Tick the store of a committed store instruction completed. */
+    Tick store;
+
+    InstPipeRecord()
+        : tid(0), seqNum(0), pc(0), upc(0), fetch(0), decode(0),
+          rename(0), dispatch(0), issue(0), complete(0), commit(0),
+          store(0)
+    {}
+};
+
+#endif // __CPU_INST_PIPE_RECORD_HH__
@@ -125,10 +125,18 @@ void
 MinorCPU::regStats()
 {
     BaseCPU::regStats();
-    stats.regStats(name(), *this);
+    stats.regStats(name(), *this, instPool);
     pipeline->regStats();
 }
 
+void
+MinorCPU::regProbePoints()
+{
+    BaseCPU::regProbePoints();
+    ppPipeRecord = new ProbePointArg<InstPipeRecord>(getProbeManager(),
+                                                     "PipeRecord");
+}
+
 void
 MinorCPU::serializeThread(std::ostream &os, ThreadID thread_id)
 {
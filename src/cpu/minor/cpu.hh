@@ -49,8 +49,10 @@
 #include "cpu/minor/activity.hh"
 #include "cpu/minor/stats.hh"
 #include "cpu/base.hh"
+#include "cpu/inst_pipe_record.hh"
 #include "cpu/simple_thread.hh"
 #include "params/MinorCPU.hh"
+#include "sim/probe/probe.hh"
 
 namespace Minor
 {
@@ -139,9 +141,18 @@ class MinorCPU : public BaseCPU
     /** Processor-specific statistics */
     Minor::MinorStats stats;
 
+    /** Storage for the dynamic instructions of this CPU */
+    DynInstPool instPool;
+
     /** Stats interface from SimObject (by way of BaseCPU) */
     void regStats();
 
+    /** Notified with the timeline of each committed instruction */
+    ProbePointArg<InstPipeRecord> *ppPipeRecord;
+
+    /** Probe point interface from SimObject */
+    void regProbePoints();
+
     /** Simple inst count interface from BaseCPU */
     Counter totalInsts() const;
     Counter totalOps() const;
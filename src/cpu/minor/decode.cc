@@ -169,10 +169,11 @@ Decode::evaluate()
                     static_micro_inst =
                         static_inst->fetchMicroop(microopPC.microPC());
 
-                    output_inst = new MinorDynInst(inst->id);
+                    output_inst = new (cpu.instPool) MinorDynInst(inst->id);
                     output_inst->pc = microopPC;
                     output_inst->staticInst = static_micro_inst;
                     output_inst->fault = NoFault;
+                    output_inst->fetchTick = inst->fetchTick;
 
                     /* Allow a predicted next address only on the last
                      *  microop */
@@ -216,6 +217,7 @@ Decode::evaluate()
 
                 /* Set execSeqNum of output_inst */
                 output_inst->id.execSeqNum = execSeqNum;
+                output_inst->decodeTick = curTick();
                 /* Add tracing */
 #if TRACING_ON
                 dynInstAddTracing(output_inst, parent_static_inst, cpu);
@@ -52,6 +52,7 @@
 
 #include "base/refcnt.hh"
 #include "cpu/minor/buffers.hh"
+#include "cpu/dyn_inst_pool.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/static_inst.hh"
 #include "cpu/timing_expr.hh"
@@ -224,6 +225,12 @@ class MinorDynInst : public RefCounted
     /** Effective address as set by ExecContext::setEA */
     Addr ea;
 
+    /** Ticks the instruction was fetched, decoded and issued at for the
+     *  CPU's PipeRecord probe point, 0 until it gets there */
+    Tick fetchTick;
+    Tick decodeTick;
+    Tick issueTick;
+
   public:
     MinorDynInst(InstId id_ = InstId(), Fault fault_ = NoFault) :
         staticInst(NULL), id(id_), traceData(NULL),
@@ -233,7 +240,7 @@ class MinorDynInst : public RefCounted
         canEarlyIssue(false),
         instToWaitFor(0), extraCommitDelay(Cycles(0)),
         extraCommitDelayExpr(NULL), minimumCommitCycle(Cycles(0)),
-        ea(0)
+        ea(0), fetchTick(0), decodeTick(0), issueTick(0)
     { }
 
   public:
@@ -271,6 +278,20 @@ class MinorDynInst : public RefCounted
     void reportData(std::ostream &os) const;
 
     ~MinorDynInst();
+
+    /** Allocate an instruction from the instruction pool of a CPU */
+    static void *operator new(size_t size, DynInstPool &pool)
+    { return pool.allocate(size); }
+
+    /** Allocate an instruction outside of any instruction pool */
+    static void *operator new(size_t size)
+    { return DynInstPool::allocateHeap(size); }
+
+    static void operator delete(void *p, DynInstPool &pool)
+    { DynInstPool::release(p); }
+
+    static void operator delete(void *p)
+    { DynInstPool::release(p); }
 };
 
 /** Print a summary of the instruction */
@@ -765,6 +765,8 @@ Execute::issue(bool only_issue_microops)
                 inst->traceData->setWhen(curTick());
             }
 
+            inst->issueTick = curTick();
+
             if (issued_mem_ref)
                 num_mem_insts_issued++;
 
@@ -853,6 +855,23 @@ Execute::doInstCommitAccounting(MinorDynInstPtr inst)
     /* Set the CP SeqNum to the numOps commit number */
     if (inst->traceData)
         inst->traceData->setCPSeq(thread->numOp);
+
+    /* Hand the instruction's timeline to any PipeRecord listeners.  Minor
+     *  has no rename or dispatch stages and commits as it completes */
+    if (cpu.ppPipeRecord->hasListeners()) {
+        InstPipeRecord record;
+        record.tid = inst->id.threadId;
+        record.seqNum = inst->id.execSeqNum;
+        record.pc = inst->pc.instAddr();
+        record.upc = inst->pc.microPC();
+        record.staticInst = inst->staticInst;
+        record.fetch = inst->fetchTick;
+        record.decode = inst->decodeTick;
+        record.issue = inst->issueTick;
+        record.complete = curTick();
+        record.commit = curTick();
+        cpu.ppPipeRecord->notify(record);
+    }
 }
 
 bool
@@ -335,7 +335,7 @@ Fetch2::evaluate()
 
                 /* Make a new instruction and pick up the line, stream,
                  *  prediction, thread ids from the incoming line */
-                dyn_inst = new MinorDynInst(line_in->id);
+                dyn_inst = new (cpu.instPool) MinorDynInst(line_in->id);
 
                 /* Fetch and prediction sequence numbers originate here */
                 dyn_inst->id.fetchSeqNum = fetchSeqNum;
@@ -375,7 +375,7 @@ Fetch2::evaluate()
                 if (decoder->instReady()) {
                     /* Make a new instruction and pick up the line, stream,
                      *  prediction, thread ids from the incoming line */
-                    dyn_inst = new MinorDynInst(line_in->id);
+                    dyn_inst = new (cpu.instPool) MinorDynInst(line_in->id);
 
                     /* Fetch and prediction sequence numbers originate here */
                     dyn_inst->id.fetchSeqNum = fetchSeqNum;
@@ -389,6 +389,7 @@ Fetch2::evaluate()
                      *  decode */
                     StaticInstPtr decoded_inst = decoder->decode(pc);
                     dyn_inst->staticInst = decoded_inst;
+                    dyn_inst->fetchTick = curTick();
 
                     dyn_inst->pc = pc;
 
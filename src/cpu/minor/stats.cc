@@ -46,7 +46,8 @@ MinorStats::MinorStats()
 { }
 
 void
-MinorStats::regStats(const std::string &name, BaseCPU &baseCpu)
+MinorStats::regStats(const std::string &name, BaseCPU &baseCpu,
+    DynInstPool &instPool)
 {
     numInsts
         .name(name + ".committedInsts")
@@ -82,6 +83,11 @@ MinorStats::regStats(const std::string &name, BaseCPU &baseCpu)
         .desc("IPC: instructions per cycle")
         .precision(6);
     ipc = numInsts / baseCpu.numCycles;
+
+    peakLiveInsts
+        .method(&instPool, &DynInstPool::peak)
+        .name(name + ".peakLiveInsts")
+        .desc("Peak number of dynamic instructions alive at once");
 }
 
 };
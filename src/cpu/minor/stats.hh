@@ -48,6 +48,7 @@
 
 #include "base/statistics.hh"
 #include "cpu/base.hh"
+#include "cpu/dyn_inst_pool.hh"
 #include "sim/ticked_object.hh"
 
 namespace Minor
@@ -76,11 +77,15 @@ class MinorStats
     Stats::Formula cpi;
     Stats::Formula ipc;
 
+    /** Peak number of dynamic instructions alive at once */
+    Stats::Value peakLiveInsts;
+
   public:
     MinorStats();
 
   public:
-    void regStats(const std::string &name, BaseCPU &baseCpu);
+    void regStats(const std::string &name, BaseCPU &baseCpu,
+        DynInstPool &instPool);
 };
 
 }
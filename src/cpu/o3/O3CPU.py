@@ -63,6 +63,11 @@ class DerivO3CPU(BaseCPU):
     fetchBufferSize = Param.Unsigned(64, "Fetch buffer size in bytes")
     fetchQueueSize = Param.Unsigned(32, "Fetch queue size in micro-ops "
                                     "per-thread")
+    ftqSize = Param.Unsigned(0, "Fetch target queue size in fetch buffer "
+                             "blocks per-thread, 0 to couple prediction "
+                             "and fetch")
+    fetchTargetTableSize = Param.Unsigned(1024, "Number of entries of the "
+                                          "next fetch block predictor")
 
     renameToDecodeDelay = Param.Cycles(1, "Rename to decode delay")
     iewToDecodeDelay = Param.Cycles(1, "Issue/Execute/Writeback to decode "
@@ -62,7 +62,6 @@
 #include "debug/CommitRate.hh"
 #include "debug/Drain.hh"
 #include "debug/ExecFaulting.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/faults.hh"
 #include "sim/full_system.hh"
@@ -1305,11 +1304,7 @@ DefaultCommit<Impl>::commitHead(DynInstPtr &head_inst, unsigned inst_num)
     // Finally clear the head ROB entry.
     rob->retireHead(tid);
 
-#if TRACING_ON
-    if (DTRACE(O3PipeView)) {
-        head_inst->commitTick = curTick() - head_inst->fetchTick;
-    }
-#endif
+    head_inst->commitTick = curTick() - head_inst->fetchTick;
 
     // If this was a store, record it for this cycle.
     if (head_inst->isStore())
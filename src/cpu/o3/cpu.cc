@@ -99,6 +99,13 @@ FullO3CPU<Impl>::IcachePort::recvTimingResp(PacketPtr pkt)
     return true;
 }
 
+template<class Impl>
+void
+FullO3CPU<Impl>::IcachePort::recvTimingSnoopReq(PacketPtr pkt)
+{
+    fetch->recvTimingSnoopReq(pkt);
+}
+
 template<class Impl>
 void
 FullO3CPU<Impl>::IcachePort::recvRetry()
@@ -156,6 +163,9 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
 #ifndef NDEBUG
       instcount(0),
 #endif
+      // leave room for the instructions in the front end on top of
+      // the ones in the ROB, the list grows if this is not enough
+      instList(2 * params->numROBEntries),
       removeInstsThisCycle(false),
       fetch(this, params),
       decode(this, params),
@@ -407,6 +417,8 @@ FullO3CPU<Impl>::regProbePoints()
 {
     ppInstAccessComplete = new ProbePointArg<PacketPtr>(getProbeManager(), "InstAccessComplete");
     ppDataAccessComplete = new ProbePointArg<std::pair<DynInstPtr, PacketPtr> >(getProbeManager(), "DataAccessComplete");
+    ppPipeRecord = new ProbePointArg<InstPipeRecord>(getProbeManager(),
+                                                     "PipeRecord");
     fetch.regProbePoints();
     iew.regProbePoints();
     commit.regProbePoints();
@@ -523,6 +535,11 @@ FullO3CPU<Impl>::regStats()
         .name(name() + ".misc_regfile_writes")
         .desc("number of misc regfile writes")
         .prereq(miscRegfileWrites);
+
+    peakLiveInsts
+        .method(&instPool, &DynInstPool::peak)
+        .name(name() + ".peak_live_insts")
+        .desc("Peak number of dynamic instructions alive at once");
 }
 
 template <class Impl>
@@ -1521,7 +1538,7 @@ FullO3CPU<Impl>::removeInstsUntil(const InstSeqNum &seq_num, ThreadID tid)
             "list that are from [tid:%i] and above [sn:%lli] (end=%lli).\n",
             tid, seq_num, (*inst_iter)->seqNum);
 
-    while ((*inst_iter)->seqNum > seq_num) {
+    while (!*inst_iter || (*inst_iter)->seqNum > seq_num) {
 
         bool break_loop = (inst_iter == instList.begin());
 
@@ -1538,7 +1555,7 @@ template <class Impl>
 inline void
 FullO3CPU<Impl>::squashInstIt(const ListIt &instIt, ThreadID tid)
 {
-    if ((*instIt)->threadNumber == tid) {
+    if (*instIt && (*instIt)->threadNumber == tid) {
         DPRINTF(O3CPU, "Squashing instruction, "
                 "[tid:%i] [sn:%lli] PC %s\n",
                 (*instIt)->threadNumber,
@@ -1566,11 +1583,18 @@ FullO3CPU<Impl>::cleanUpRemovedInsts()
                 (*removeList.front())->seqNum,
                 (*removeList.front())->pcState());
 
-        instList.erase(removeList.front());
+        *removeList.front() = NULL;
 
         removeList.pop();
     }
 
+    // Drop the removed instructions from both ends of the list, any
+    // left in the middle are dropped once they get to one of the ends
+    while (!instList.empty() && !instList.front())
+        instList.pop_front();
+    while (!instList.empty() && !instList.back())
+        instList.pop_back();
+
     removeInstsThisCycle = false;
 }
 /*
@@ -1592,6 +1616,10 @@ FullO3CPU<Impl>::dumpInsts()
     cprintf("Dumping Instruction List\n");
 
     while (inst_list_it != instList.end()) {
+        if (!*inst_list_it) {
+            inst_list_it++;
+            continue;
+        }
         cprintf("Instruction:%i\nPC:%#x\n[tid:%i]\n[sn:%lli]\nIssued:%i\n"
                 "Squashed:%i\n\n",
                 num, (*inst_list_it)->instAddr(), (*inst_list_it)->threadNumber,
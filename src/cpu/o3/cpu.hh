@@ -54,6 +54,7 @@
 #include <vector>
 
 #include "arch/types.hh"
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/comm.hh"
@@ -62,6 +63,8 @@
 #include "cpu/o3/thread_state.hh"
 #include "cpu/activity.hh"
 #include "cpu/base.hh"
+#include "cpu/dyn_inst_pool.hh"
+#include "cpu/inst_pipe_record.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/timebuf.hh"
 //#include "cpu/o3/thread_context.hh"
@@ -106,7 +109,7 @@ class FullO3CPU : public BaseO3CPU
     typedef O3ThreadState<Impl> ImplState;
     typedef O3ThreadState<Impl> Thread;
 
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename CircularQueue<DynInstPtr>::iterator ListIt;
 
     friend class O3ThreadContext<Impl>;
 
@@ -147,7 +150,9 @@ class FullO3CPU : public BaseO3CPU
         /** Timing version of receive.  Handles setting fetch to the
          * proper status to start fetching. */
         virtual bool recvTimingResp(PacketPtr pkt);
-        virtual void recvTimingSnoopReq(PacketPtr pkt) { }
+
+        /** Passes invalidations on to the fetch prefetch buffer. */
+        virtual void recvTimingSnoopReq(PacketPtr pkt);
 
         /** Handles doing a retry of a failed fetch. */
         virtual void recvRetry();
@@ -267,6 +272,9 @@ class FullO3CPU : public BaseO3CPU
 
     ProbePointArg<PacketPtr> *ppInstAccessComplete;
     ProbePointArg<std::pair<DynInstPtr, PacketPtr> > *ppDataAccessComplete;
+    /** Notified with the timeline of each instruction leaving the
+     * pipeline, committed or squashed. */
+    ProbePointArg<InstPipeRecord> *ppPipeRecord;
 
     /** Register probe points. */
     void regProbePoints();
@@ -506,13 +514,24 @@ class FullO3CPU : public BaseO3CPU
     void dumpInsts();
 
   public:
+    /** Storage for the dynamic instructions of this CPU, declared
+     * ahead of anything holding on to instructions so that it is
+     * destroyed last.
+     */
+    DynInstPool instPool;
+
 #ifndef NDEBUG
     /** Count of total number of dynamic instructions in flight. */
     int instcount;
 #endif
 
-    /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
+    /** List of all the instructions in flight. Instructions are
+     * removed from the front as they commit, and from the back as
+     * they are squashed. With multiple threads, instructions can also
+     * be removed from the middle, in which case they are replaced by
+     * a null pointer until they reach either end of the list.
+     */
+    CircularQueue<DynInstPtr> instList;
 
     /** List of all the instructions that will be removed at the end of this
      *  cycle.
@@ -739,6 +758,8 @@ class FullO3CPU : public BaseO3CPU
     //number of misc
     Stats::Scalar miscRegfileReads;
     Stats::Scalar miscRegfileWrites;
+    //peak number of dynamic instructions alive at once
+    Stats::Value peakLiveInsts;
 };
 
 #endif // __CPU_O3_CPU_HH__
@@ -50,7 +50,6 @@
 #include "cpu/inst_seq.hh"
 #include "debug/Activity.hh"
 #include "debug/Decode.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/full_system.hh"
 
@@ -697,11 +696,7 @@ DefaultDecode<Impl>::decodeInsts(ThreadID tid)
         ++decodeDecodedInsts;
         --insts_available;
 
-#if TRACING_ON
-        if (DTRACE(O3PipeView)) {
-            inst->decodeTick = curTick() - inst->fetchTick;
-        }
-#endif
+        inst->decodeTick = curTick() - inst->fetchTick;
 
         // Ensure that if it was predicted as a branch, it really is a
         // branch.
@@ -49,6 +49,7 @@
 #include "cpu/o3/cpu.hh"
 #include "cpu/o3/isa_specific.hh"
 #include "cpu/base_dyn_inst.hh"
+#include "cpu/dyn_inst_pool.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/reg_class.hh"
 
@@ -93,6 +94,20 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
     ~BaseO3DynInst();
 
+    /** Allocate an instruction from the instruction pool of a CPU. */
+    static void *operator new(size_t size, DynInstPool &pool)
+    { return pool.allocate(size); }
+
+    /** Allocate an instruction outside of any instruction pool. */
+    static void *operator new(size_t size)
+    { return DynInstPool::allocateHeap(size); }
+
+    static void operator delete(void *p, DynInstPool &pool)
+    { DynInstPool::release(p); }
+
+    static void operator delete(void *p)
+    { DynInstPool::release(p); }
+
     /** Executes the instruction.*/
     Fault execute();
 
@@ -121,7 +136,6 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
 
   public:
-#if TRACING_ON
     /** Tick records used for the pipeline activity viewer. */
     Tick fetchTick;	     // instruction fetch is completed.
     int32_t decodeTick;  // instruction enters decode phase
@@ -131,7 +145,6 @@ class BaseO3DynInst : public BaseDynInst<Impl>
     int32_t completeTick;
     int32_t commitTick;
     int32_t storeTick;
-#endif
 
     /** Reads a misc. register, including any side-effects the read
      * might have as defined by the architecture.
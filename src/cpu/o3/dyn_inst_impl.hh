@@ -68,37 +68,53 @@ BaseO3DynInst<Impl>::BaseO3DynInst(const StaticInstPtr &_staticInst,
 
 template <class Impl>BaseO3DynInst<Impl>::~BaseO3DynInst()
 {
+    // fetchTick is -1 if the instruction never made it out of fetch.
+    Tick fetch = this->fetchTick;
+    if (fetch == -1)
+        return;
+
+    bool notify = this->cpu->ppPipeRecord->hasListeners();
 #if TRACING_ON
-    if (DTRACE(O3PipeView)) {
-        Tick fetch = this->fetchTick;
-        // fetchTick can be -1 if the instruction fetched outside the trace window.
-        if (fetch != -1) {
-            Tick val;
-            // Print info needed by the pipeline activity viewer.
-            DPRINTFR(O3PipeView, "O3PipeView:fetch:%llu:0x%08llx:%d:%llu:%s\n",
-                     fetch,
-                     this->instAddr(),
-                     this->microPC(),
-                     this->seqNum,
-                     this->staticInst->disassemble(this->instAddr()));
-
-            val = (this->decodeTick == -1) ? 0 : fetch + this->decodeTick;
-            DPRINTFR(O3PipeView, "O3PipeView:decode:%llu\n", val);
-            val = (this->renameTick == -1) ? 0 : fetch + this->renameTick;
-            DPRINTFR(O3PipeView, "O3PipeView:rename:%llu\n", val);
-            val = (this->dispatchTick == -1) ? 0 : fetch + this->dispatchTick;
-            DPRINTFR(O3PipeView, "O3PipeView:dispatch:%llu\n", val);
-            val = (this->issueTick == -1) ? 0 : fetch + this->issueTick;
-            DPRINTFR(O3PipeView, "O3PipeView:issue:%llu\n", val);
-            val = (this->completeTick == -1) ? 0 : fetch + this->completeTick;
-            DPRINTFR(O3PipeView, "O3PipeView:complete:%llu\n", val);
-            val = (this->commitTick == -1) ? 0 : fetch + this->commitTick;
-
-            Tick valS = (this->storeTick == -1) ? 0 : fetch + this->storeTick;
-            DPRINTFR(O3PipeView, "O3PipeView:retire:%llu:store:%llu\n", val, valS);
-        }
-    }
+    bool print = DTRACE(O3PipeView);
+#else
+    bool print = false;
 #endif
+    if (!notify && !print)
+        return;
+
+    InstPipeRecord record;
+    record.tid = this->threadNumber;
+    record.seqNum = this->seqNum;
+    record.pc = this->instAddr();
+    record.upc = this->microPC();
+    record.staticInst = this->staticInst;
+    record.fetch = fetch;
+    record.decode = (this->decodeTick == -1) ? 0 : fetch + this->decodeTick;
+    record.rename = (this->renameTick == -1) ? 0 : fetch + this->renameTick;
+    record.dispatch =
+        (this->dispatchTick == -1) ? 0 : fetch + this->dispatchTick;
+    record.issue = (this->issueTick == -1) ? 0 : fetch + this->issueTick;
+    record.complete =
+        (this->completeTick == -1) ? 0 : fetch + this->completeTick;
+    record.commit = (this->commitTick == -1) ? 0 : fetch + this->commitTick;
+    record.store = (this->storeTick == -1) ? 0 : fetch + this->storeTick;
+
+    if (notify)
+        this->cpu->ppPipeRecord->notify(record);
+
+    if (print) {
+        // Print info needed by the pipeline activity viewer.
+        DPRINTFR(O3PipeView, "O3PipeView:fetch:%llu:0x%08llx:%d:%llu:%s\n",
+                 record.fetch, record.pc, record.upc, record.seqNum,
+                 this->staticInst->disassemble(record.pc));
+        DPRINTFR(O3PipeView, "O3PipeView:decode:%llu\n", record.decode);
+        DPRINTFR(O3PipeView, "O3PipeView:rename:%llu\n", record.rename);
+        DPRINTFR(O3PipeView, "O3PipeView:dispatch:%llu\n", record.dispatch);
+        DPRINTFR(O3PipeView, "O3PipeView:issue:%llu\n", record.issue);
+        DPRINTFR(O3PipeView, "O3PipeView:complete:%llu\n", record.complete);
+        DPRINTFR(O3PipeView, "O3PipeView:retire:%llu:store:%llu\n",
+                 record.commit, record.store);
+    }
 };
 
 
@@ -121,7 +137,6 @@ BaseO3DynInst<Impl>::initVars()
 
     _numDestMiscRegs = 0;
 
-#if TRACING_ON
     // Value -1 indicates that particular phase
     // hasn't happened (yet).
     fetchTick = -1;
@@ -132,7 +147,6 @@ BaseO3DynInst<Impl>::initVars()
     completeTick = -1;
     commitTick = -1;
     storeTick = -1;
-#endif
 }
 
 template <class Impl>
@@ -109,6 +109,30 @@ class DefaultFetch
         }
     };
 
+    class PrefetchTranslation : public BaseTLB::Translation
+    {
+      protected:
+        DefaultFetch<Impl> *fetch;
+
+      public:
+        PrefetchTranslation(DefaultFetch<Impl> *_fetch)
+            : fetch(_fetch)
+        {}
+
+        void
+        markDelayed()
+        {}
+
+        void
+        finish(const Fault &fault, RequestPtr req, ThreadContext *tc,
+               BaseTLB::Mode mode)
+        {
+            assert(mode == BaseTLB::Execute);
+            fetch->finishPrefetchTranslation(fault, req);
+            delete this;
+        }
+    };
+
   private:
     /* Event to delay delivery of a fetch translation result in case of
      * a fault and the nop to carry the fault cannot be generated
@@ -229,6 +253,9 @@ class DefaultFetch
     /** Processes cache completion event. */
     void processCacheCompletion(PacketPtr pkt);
 
+    /** Drops prefetched blocks that an icache snoop invalidates. */
+    void recvTimingSnoopReq(PacketPtr pkt);
+
     /** Resume after a drain. */
     void drainResume();
 
@@ -296,6 +323,51 @@ class DefaultFetch
     bool fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc);
     void finishTranslation(const Fault &fault, RequestPtr mem_req);
 
+    /** Predicts the fetch buffer block fetched after the given one. */
+    Addr predictFetchTarget(Addr block_pc) const;
+
+    /** Trains the next block predictor with a fetch stream transition. */
+    void setFetchTarget(Addr block_pc, Addr target_pc);
+
+    /**
+     * Moves the fetch stream of a thread to a new fetch buffer block,
+     * consuming the head of the fetch target queue if it predicted the
+     * block and flushing the queue otherwise.
+     */
+    void advanceFetchTarget(Addr block_pc, ThreadID tid);
+
+    /**
+     * Runs the fetch target queue of a thread one block further ahead
+     * of fetch, and prefetches that block from the icache.
+     */
+    void fillFetchTargetQueue(ThreadID tid);
+
+    /** Sends an icache prefetch of a block into a prefetch buffer entry. */
+    void issuePrefetch(int entry_idx, Addr block_pc, ThreadID tid);
+    void finishPrefetchTranslation(const Fault &fault, RequestPtr mem_req);
+
+    /**
+     * Satisfies a demand fetch from the prefetch buffer, either by
+     * copying a prefetched block into the fetch buffer or by waiting
+     * for a prefetch that is in flight.
+     * @return Whether the prefetch buffer had the block.
+     */
+    bool usePrefetchedBlock(Addr block_pc, ThreadID tid);
+
+    /** Fills the prefetch buffer if the packet is an icache prefetch.
+     * @return Whether the packet was a prefetch.
+     */
+    bool processPrefetchCompletion(PacketPtr pkt);
+
+    /**
+     * Drops the prefetched blocks of a thread, and marks its prefetches
+     * in flight so they are thrown away when they complete.
+     */
+    void invalidatePrefetches(ThreadID tid);
+
+    /** Drops a prefetched block, or marks it stale if in flight. */
+    void invalidatePrefetch(int entry_idx, ThreadID tid);
+
 
     /** Check if an interrupt is pending and that we need to handle
      */
@@ -521,6 +593,53 @@ class DefaultFetch
     /** Event used to delay fault generation of translation faults */
     FinishTranslationEvent finishTranslationEvent;
 
+    /** The size of the fetch target queue in fetch buffer blocks. Fetch
+     * is only decoupled from the queue if it is not zero.
+     */
+    unsigned ftqSize;
+
+    /** Predicted fetch buffer blocks ahead of the fetch stream. */
+    std::deque<Addr> ftq[Impl::MaxThreads];
+
+    /** The block the fetch stream is in, MaxAddr if unknown. */
+    Addr lastFetchBlock[Impl::MaxThreads];
+
+    struct FetchTarget
+    {
+        Addr blockPC;
+        Addr targetPC;
+    };
+
+    /** Next fetch buffer block predictor that runs the queue ahead. */
+    std::vector<FetchTarget> fetchTargets;
+
+    /** Mask to index the next fetch buffer block predictor. */
+    Addr fetchTargetMask;
+
+    enum PrefetchState {
+        PrefetchInvalid,
+        PrefetchTranslating,
+        PrefetchWaiting,
+        PrefetchReady
+    };
+
+    struct PrefetchEntry
+    {
+        Addr blockPC;
+        /** Physical address of the block once translated. */
+        Addr paddr;
+        /** Task the block was translated for. */
+        uint32_t taskId;
+        RequestPtr req;
+        PrefetchState state;
+        /** Squashed or snooped while in flight, so the data is dropped. */
+        bool stale;
+        std::vector<uint8_t> data;
+    };
+
+    /** Blocks prefetched along the fetch target queue. */
+    std::vector<PrefetchEntry> prefetchBuffer[Impl::MaxThreads];
+
     // @todo: Consider making these vectors and tracking on a per thread basis.
     /** Stat for total number of cycles stalled due to an icache miss. */
     Stats::Scalar icacheStallCycles;
@@ -564,6 +683,16 @@ class DefaultFetch
      * due to a squash.
      */
     Stats::Scalar fetchTlbSquashes;
+    /** Stat for fetch buffer blocks predicted by the fetch target queue. */
+    Stats::Scalar ftqHits;
+    /** Stat for fetch target queue flushes due to an unpredicted block. */
+    Stats::Scalar ftqResteers;
+    /** Stat for icache prefetches sent along the fetch target queue. */
+    Stats::Scalar icachePrefetches;
+    /** Stat for demand fetches satisfied by a prefetched block. */
+    Stats::Scalar icachePrefetchHits;
+    /** Stat for demand fetches that waited for a prefetch in flight. */
+    Stats::Scalar icachePrefetchLateHits;
     /** Distribution of number of instructions fetched each cycle. */
     Stats::Distribution fetchNisnDist;
     /** Rate of how often fetch was idle. */
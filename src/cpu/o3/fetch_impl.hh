@@ -54,6 +54,7 @@
 #include "arch/tlb.hh"
 #include "arch/utility.hh"
 #include "arch/vtophys.hh"
+#include "base/intmath.hh"
 #include "base/random.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
@@ -64,7 +65,6 @@
 #include "debug/Activity.hh"
 #include "debug/Drain.hh"
 #include "debug/Fetch.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/byteswap.hh"
@@ -92,7 +92,9 @@ DefaultFetch<Impl>::DefaultFetch(O3CPU *_cpu, DerivO3CPUParams *params)
       fetchQueueSize(params->fetchQueueSize),
       numThreads(params->numThreads),
       numFetchingThreads(params->smtNumFetchingThreads),
-      finishTranslationEvent(this)
+      finishTranslationEvent(this),
+      ftqSize(params->ftqSize),
+      fetchTargetMask(params->fetchTargetTableSize - 1)
 {
     if (numThreads > Impl::MaxThreads)
         fatal("numThreads (%d) is larger than compiled limit (%d),\n"
@@ -108,6 +110,9 @@ DefaultFetch<Impl>::DefaultFetch(O3CPU *_cpu, DerivO3CPUParams *params)
     if (cacheBlkSize % fetchBufferSize)
         fatal("cache block (%u bytes) is not a multiple of the "
               "fetch buffer (%u bytes)\n", cacheBlkSize, fetchBufferSize);
+    if (ftqSize && !isPowerOf2(params->fetchTargetTableSize))
+        fatal("fetch target table size (%u) is not a power of 2\n",
+              params->fetchTargetTableSize);
 
     std::string policy = params->smtFetchPolicy;
 
@@ -154,6 +159,15 @@ DefaultFetch<Impl>::DefaultFetch(O3CPU *_cpu, DerivO3CPUParams *params)
         // Create space to buffer the cache line data,
         // which may not hold the entire cache line.
         fetchBuffer[tid] = new uint8_t[fetchBufferSize];
+
+        prefetchBuffer[tid].resize(ftqSize);
+        for (int i = 0; i < ftqSize; i++)
+            prefetchBuffer[tid][i].data.resize(fetchBufferSize);
+    }
+
+    if (ftqSize) {
+        FetchTarget invalid_target = { MaxAddr, MaxAddr };
+        fetchTargets.assign(params->fetchTargetTableSize, invalid_target);
     }
 }
 
@@ -267,6 +281,35 @@ DefaultFetch<Impl>::regStats()
         .desc("Number of outstanding ITLB misses that were squashed")
         .prereq(fetchTlbSquashes);
 
+    ftqHits
+        .name(name() + ".ftqHits")
+        .desc("Number of fetch buffer blocks predicted by the fetch target "
+              "queue")
+        .prereq(ftqHits);
+
+    ftqResteers
+        .name(name() + ".ftqResteers")
+        .desc("Number of fetch target queue flushes due to fetching an "
+              "unpredicted block")
+        .prereq(ftqResteers);
+
+    icachePrefetches
+        .name(name() + ".IcachePrefetches")
+        .desc("Number of Icache prefetches sent along the fetch target "
+              "queue")
+        .prereq(icachePrefetches);
+
+    icachePrefetchHits
+        .name(name() + ".IcachePrefetchHits")
+        .desc("Number of fetch buffer blocks taken from the prefetch buffer")
+        .prereq(icachePrefetchHits);
+
+    icachePrefetchLateHits
+        .name(name() + ".IcachePrefetchLateHits")
+        .desc("Number of fetch buffer blocks waited for while they were "
+              "being prefetched")
+        .prereq(icachePrefetchLateHits);
+
     fetchNisnDist
         .init(/* base value */ 0,
               /* last value */ fetchWidth,
@@ -362,6 +405,14 @@ DefaultFetch<Impl>::resetStage()
 
         fetchQueue[tid].clear();
 
+        ftq[tid].clear();
+        lastFetchBlock[tid] = MaxAddr;
+        for (int i = 0; i < ftqSize; i++) {
+            prefetchBuffer[tid][i].state = PrefetchInvalid;
+            prefetchBuffer[tid][i].req = NULL;
+            prefetchBuffer[tid][i].stale = false;
+        }
+
         priorityList.push_back(tid);
     }
 
@@ -375,9 +426,13 @@ DefaultFetch<Impl>::processCacheCompletion(PacketPtr pkt)
 {
     ThreadID tid = pkt->req->threadId();
 
-    DPRINTF(Fetch, "[tid:%u] Waking up from cache miss.\n", tid);
     assert(!cpu->switchedOut());
 
+    if (ftqSize && processPrefetchCompletion(pkt))
+        return;
+
+    DPRINTF(Fetch, "[tid:%u] Waking up from cache miss.\n", tid);
+
     // Only change the status if it's still waiting on the icache access
     // to return.
     if (fetchStatus[tid] != IcacheWaitResponse ||
@@ -456,6 +511,13 @@ DefaultFetch<Impl>::isDrained() const
         if (!fetchQueue[i].empty())
             return false;
 
+        // Prefetches in flight would complete after the switch
+        for (int j = 0; j < ftqSize; j++) {
+            if (prefetchBuffer[i][j].state == PrefetchTranslating ||
+                prefetchBuffer[i][j].state == PrefetchWaiting)
+                return false;
+        }
+
         // Return false if not idle or drain stalled
         if (fetchStatus[i] != Idle) {
             if (fetchStatus[i] == Blocked && stalls[i].drain)
@@ -608,6 +670,12 @@ DefaultFetch<Impl>::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
     // Align the fetch address to the start of a fetch buffer segment.
     Addr fetchBufferBlockPC = fetchBufferAlignPC(vaddr);
 
+    if (ftqSize) {
+        advanceFetchTarget(fetchBufferBlockPC, tid);
+        if (usePrefetchedBlock(fetchBufferBlockPC, tid))
+            return true;
+    }
+
     DPRINTF(Fetch, "[tid:%i] Fetching cache line %#x for addr %#x\n",
             tid, fetchBufferBlockPC, vaddr);
 
@@ -737,6 +805,322 @@ DefaultFetch<Impl>::finishTranslation(const Fault &fault, RequestPtr mem_req)
     _status = updateFetchStatus();
 }
 
+template <class Impl>
+Addr
+DefaultFetch<Impl>::predictFetchTarget(Addr block_pc) const
+{
+    const FetchTarget &target =
+        fetchTargets[(block_pc / fetchBufferSize) & fetchTargetMask];
+
+    // Without a recorded transition fetch falls through to the next block
+    if (target.blockPC == block_pc)
+        return target.targetPC;
+    return block_pc + fetchBufferSize;
+}
+
+template <class Impl>
+void
+DefaultFetch<Impl>::setFetchTarget(Addr block_pc, Addr target_pc)
+{
+    FetchTarget &target =
+        fetchTargets[(block_pc / fetchBufferSize) & fetchTargetMask];
+    target.blockPC = block_pc;
+    target.targetPC = target_pc;
+}
+
+template <class Impl>
+void
+DefaultFetch<Impl>::advanceFetchTarget(Addr block_pc, ThreadID tid)
+{
+    if (block_pc == lastFetchBlock[tid])
+        return;
+
+    if (lastFetchBlock[tid] != MaxAddr)
+        setFetchTarget(lastFetchBlock[tid], block_pc);
+    lastFetchBlock[tid] = block_pc;
+
+    if (ftq[tid].empty())
+        return;
+
+    if (ftq[tid].front() == block_pc) {
+        ftq[tid].pop_front();
+        ++ftqHits;
+    } else {
+        DPRINTF(Fetch, "[tid:%i] Fetch target queue expected block %#x "
+                "but fetch moved to %#x, flushing it.\n",
+                tid, ftq[tid].front(), block_pc);
+        ftq[tid].clear();
+        ++ftqResteers;
+    }
+}
+
+template <class Impl>
+void
+DefaultFetch<Impl>::fillFetchTargetQueue(ThreadID tid)
+{
+    if (ftq[tid].size() >= ftqSize || lastFetchBlock[tid] == MaxAddr ||
+        cacheBlocked || stalls[tid].drain)
+        return;
+
+    switch (fetchStatus[tid]) {
+      case Running:
+      case ItlbWait:
+      case IcacheWaitResponse:
+      case IcacheAccessComplete:
+        break;
+      default:
+        return;
+    }
+
+    // Like a branch predictor producing a fetch block per cycle, the
+    // queue grows by one block each cycle
+    Addr block_pc = ftq[tid].empty() ? lastFetchBlock[tid] : ftq[tid].back();
+    Addr next_pc = predictFetchTarget(block_pc);
+
+    bool need_prefetch =
+        !(fetchBufferValid[tid] && fetchBufferPC[tid] == next_pc);
+    int free_entry = -1;
+    for (int i = 0; i < ftqSize; i++) {
+        const PrefetchEntry &entry = prefetchBuffer[tid][i];
+        if (entry.state == PrefetchInvalid) {
+            if (free_entry < 0)
+                free_entry = i;
+        } else if (entry.blockPC == next_pc && !entry.stale) {
+            need_prefetch = false;
+        }
+    }
+
+    if (need_prefetch && free_entry < 0) {
+        // Replace a prefetched block the fetch stream has moved past,
+        // but never one in flight
+        for (int i = 0; i < ftqSize; i++) {
+            const PrefetchEntry &entry = prefetchBuffer[tid][i];
+            if (entry.state == PrefetchReady &&
+                std::find(ftq[tid].begin(), ftq[tid].end(),
+                          entry.blockPC) == ftq[tid].end()) {
+                free_entry = i;
+                break;
+            }
+        }
+        if (free_entry < 0)
+            return;
+        prefetchBuffer[tid][free_entry].state = PrefetchInvalid;
+    }
+
+    DPRINTF(Fetch, "[tid:%i] Fetch target queue predicts block %#x after "
+            "%#x.\n", tid, next_pc, block_pc);
+    ftq[tid].push_back(next_pc);
+
+    if (need_prefetch)
+        issuePrefetch(free_entry, next_pc, tid);
+}
+
+template <class Impl>
+void
+DefaultFetch<Impl>::issuePrefetch(int entry_idx, Addr block_pc,
+                                  ThreadID tid)
+{
+    PrefetchEntry &entry = prefetchBuffer[tid][entry_idx];
+    assert(entry.state == PrefetchInvalid);
+
+    RequestPtr mem_req =
+        new Request(tid, block_pc, fetchBufferSize,
+                    Request::INST_FETCH, cpu->instMasterId(), block_pc,
+                    cpu->thread[tid]->contextId(), tid);
+
+    mem_req->taskId(cpu->taskId());
+
+    entry.blockPC = block_pc;
+    entry.taskId = cpu->taskId();
+    entry.req = mem_req;
+    entry.state = PrefetchTranslating;
+    entry.stale = false;
+
+    DPRINTF(Fetch, "[tid:%i] Prefetching block %#x.\n", tid, block_pc);
+
+    // The translation may finish before this call returns
+    PrefetchTranslation *trans = new PrefetchTranslation(this);
+    cpu->itb->translateTiming(mem_req, cpu->thread[tid]->getTC(),
+                              trans, BaseTLB::Execute);
+}
+
+template <class Impl>
+void
+DefaultFetch<Impl>::finishPrefetchTranslation(const Fault &fault,
+                                              RequestPtr mem_req)
+{
+    ThreadID tid = mem_req->threadId();
+
+    assert(!cpu->switchedOut());
+
+    PrefetchEntry *entry = NULL;
+    for (int i = 0; i < ftqSize; i++) {
+        if (prefetchBuffer[tid][i].state == PrefetchTranslating &&
+            prefetchBuffer[tid][i].req == mem_req) {
+            entry = &prefetchBuffer[tid][i];
+            break;
+        }
+    }
+    assert(entry);
+
+    // Prefetches are dropped rather than raising faults, fetching from
+    // outside of memory or waiting for the cache to unblock; a demand
+    // fetch of the block handles those
+    if (entry->stale || fault != NoFault || cacheBlocked ||
+        !cpu->system->isMemAddr(mem_req->getPaddr())) {
+        DPRINTF(Fetch, "[tid:%i] Dropping prefetch of block %#x.\n",
+                tid, entry->blockPC);
+        entry->state = PrefetchInvalid;
+        entry->req = NULL;
+        delete mem_req;
+        return;
+    }
+
+    PacketPtr data_pkt = new Packet(mem_req, MemCmd::ReadReq);
+    data_pkt->dataDynamicArray(new uint8_t[fetchBufferSize]);
+
+    if (!cpu->getInstPort().sendTimingReq(data_pkt)) {
+        // Demand fetches have to wait for the retry
+        DPRINTF(Fetch, "[tid:%i] Out of MSHRs, dropping prefetch.\n", tid);
+        entry->state = PrefetchInvalid;
+        entry->req = NULL;
+        delete data_pkt;
+        delete mem_req;
+        cacheBlocked = true;
+        return;
+    }
+
+    entry->paddr = mem_req->getPaddr();
+    entry->state = PrefetchWaiting;
+    ++icachePrefetches;
+}
+
+template <class Impl>
+bool
+DefaultFetch<Impl>::usePrefetchedBlock(Addr block_pc, ThreadID tid)
+{
+    for (int i = 0; i < ftqSize; i++) {
+        PrefetchEntry &entry = prefetchBuffer[tid][i];
+        if (entry.blockPC != block_pc || entry.stale)
+            continue;
+
+        // The block was translated for another task, and the virtual
+        // address may map somewhere else now
+        if (entry.taskId != cpu->taskId()) {
+            invalidatePrefetch(i, tid);
+            continue;
+        }
+
+        if (entry.state == PrefetchReady) {
+            DPRINTF(Fetch, "[tid:%i] Fetching block %#x from the prefetch "
+                    "buffer.\n", tid, block_pc);
+            memcpy(fetchBuffer[tid], &entry.data[0], fetchBufferSize);
+            fetchBufferPC[tid] = block_pc;
+            fetchBufferValid[tid] = true;
+            entry.state = PrefetchInvalid;
+            ++icachePrefetchHits;
+            return true;
+        } else if (entry.state == PrefetchWaiting) {
+            // Wait for the prefetch as if it was the demand access
+            DPRINTF(Fetch, "[tid:%i] Waiting for the prefetch of block "
+                    "%#x.\n", tid, block_pc);
+            memReq[tid] = entry.req;
+            fetchBufferPC[tid] = block_pc;
+            fetchBufferValid[tid] = false;
+            entry.state = PrefetchInvalid;
+            entry.req = NULL;
+            lastIcacheStall[tid] = curTick();
+            fetchStatus[tid] = IcacheWaitResponse;
+            ++icachePrefetchLateHits;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <class Impl>
+bool
+DefaultFetch<Impl>::processPrefetchCompletion(PacketPtr pkt)
+{
+    ThreadID tid = pkt->req->threadId();
+
+    for (int i = 0; i < ftqSize; i++) {
+        PrefetchEntry &entry = prefetchBuffer[tid][i];
+        if (entry.state != PrefetchWaiting || entry.req != pkt->req)
+            continue;
+
+        if (entry.stale) {
+            DPRINTF(Fetch, "[tid:%i] Dropping stale prefetch of block "
+                    "%#x.\n", tid, entry.blockPC);
+            entry.state = PrefetchInvalid;
+            entry.stale = false;
+        } else {
+            DPRINTF(Fetch, "[tid:%i] Prefetch of block %#x complete.\n",
+                    tid, entry.blockPC);
+            memcpy(&entry.data[0], pkt->getPtr<uint8_t>(), fetchBufferSize);
+            entry.state = PrefetchReady;
+        }
+        entry.req = NULL;
+
+        delete pkt->req;
+        delete pkt;
+        return true;
+    }
+
+    return false;
+}
+
+template <class Impl>
+void
+DefaultFetch<Impl>::invalidatePrefetch(int entry_idx, ThreadID tid)
+{
+    PrefetchEntry &entry = prefetchBuffer[tid][entry_idx];
+
+    if (entry.state == PrefetchReady) {
+        entry.state = PrefetchInvalid;
+    } else if (entry.state != PrefetchInvalid) {
+        // The translation or the icache access still owns the request
+        entry.stale = true;
+    }
+}
+
+template <class Impl>
+void
+DefaultFetch<Impl>::invalidatePrefetches(ThreadID tid)
+{
+    DPRINTF(Fetch, "[tid:%i] Invalidating the prefetch buffer.\n", tid);
+
+    for (int i = 0; i < ftqSize; i++)
+        invalidatePrefetch(i, tid);
+}
+
+template <class Impl>
+void
+DefaultFetch<Impl>::recvTimingSnoopReq(PacketPtr pkt)
+{
+    if (!ftqSize || !pkt->isInvalidate())
+        return;
+
+    Addr start = pkt->getAddr();
+    Addr end = start + pkt->getSize();
+
+    // Another writer took the line, so any prefetched copy of it may
+    // hold old code
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        for (int i = 0; i < ftqSize; i++) {
+            PrefetchEntry &entry = prefetchBuffer[tid][i];
+            if ((entry.state == PrefetchWaiting ||
+                 entry.state == PrefetchReady) &&
+                entry.paddr < end && start < entry.paddr + fetchBufferSize) {
+                DPRINTF(Fetch, "[tid:%i] Snoop of %#x invalidates prefetch "
+                        "of block %#x.\n", tid, start, entry.blockPC);
+                invalidatePrefetch(i, tid);
+            }
+        }
+    }
+}
+
 template <class Impl>
 inline void
 DefaultFetch<Impl>::doSquash(const TheISA::PCState &newPC,
@@ -780,6 +1164,25 @@ DefaultFetch<Impl>::doSquash(const TheISA::PCState &newPC,
     // Empty fetch queue
     fetchQueue[tid].clear();
 
+    // The fetch target queue ran ahead along the squashed path. Learn
+    // where the mispredicted branch went and restart from there.
+    if (ftqSize) {
+        Addr new_block = fetchBufferAlignPC(newPC.instAddr());
+        if (squashInst && squashInst->isControl()) {
+            Addr branch_block =
+                fetchBufferAlignPC(squashInst->pcState().instAddr());
+            if (branch_block != new_block)
+                setFetchTarget(branch_block, new_block);
+        }
+        ftq[tid].clear();
+        lastFetchBlock[tid] = new_block;
+
+        // Squashes come from mispredictions, but also from traps,
+        // system calls and anything else that may change the code or
+        // the translation of the prefetched blocks
+        invalidatePrefetches(tid);
+    }
+
     // microops are being squashed, it is not known wheather the
     // youngest non-squashed microop was  marked delayed commit
     // or not. Setting the flag to true ensures that the
@@ -930,6 +1333,12 @@ DefaultFetch<Impl>::tick()
         }
     }
 
+    // Run the fetch target queues ahead of fetch.
+    if (ftqSize) {
+        for (auto tid : *activeThreads)
+            fillFetchTargetQueue(tid);
+    }
+
     // Send instructions enqueued into the fetch queue to decode.
     // Limit rate by fetchWidth.  Stall if decode is stalled.
     unsigned insts_to_decode = 0;
@@ -1092,7 +1501,8 @@ DefaultFetch<Impl>::buildInst(ThreadID tid, StaticInstPtr staticInst,
 
     // Create a new DynInst from the instruction fetched.
     DynInstPtr instruction =
-        new DynInst(staticInst, curMacroop, thisPC, nextPC, seq, cpu);
+        new (cpu->instPool) DynInst(staticInst, curMacroop, thisPC, nextPC,
+                                    seq, cpu);
     instruction->setTid(tid);
 
     instruction->setASID(tid);
@@ -1189,13 +1599,18 @@ DefaultFetch<Impl>::fetch(bool &status_change)
 
             fetchCacheLine(fetchAddr, tid, thisPC.instAddr());
 
-            if (fetchStatus[tid] == IcacheWaitResponse)
-                ++icacheStallCycles;
-            else if (fetchStatus[tid] == ItlbWait)
-                ++fetchTlbCycles;
-            else
-                ++fetchMiscStallCycles;
-            return;
+            // A block taken from the prefetch buffer can be fetched from
+            // in the same cycle
+            if (!(fetchBufferValid[tid] &&
+                  fetchBufferBlockPC == fetchBufferPC[tid])) {
+                if (fetchStatus[tid] == IcacheWaitResponse)
+                    ++icacheStallCycles;
+                else if (fetchStatus[tid] == ItlbWait)
+                    ++fetchTlbCycles;
+                else
+                    ++fetchMiscStallCycles;
+                return;
+            }
         } else if ((checkInterrupt(thisPC.instAddr()) && !delayedCommit[tid])) {
             // Stall CPU if an interrupt is posted and we're not issuing
             // an delayed commit micro-op currently (delayed commit instructions
@@ -1330,11 +1745,7 @@ DefaultFetch<Impl>::fetch(bool &status_change)
             ppFetch->notify(instruction);
             numInst++;
 
-#if TRACING_ON
-            if (DTRACE(O3PipeView)) {
-                instruction->fetchTick = curTick();
-            }
-#endif
+            instruction->fetchTick = curTick();
 
             nextPC = thisPC;
 
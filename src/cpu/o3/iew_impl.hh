@@ -59,7 +59,6 @@
 #include "debug/Activity.hh"
 #include "debug/Drain.hh"
 #include "debug/IEW.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 
 using namespace std;
@@ -1136,9 +1135,7 @@ DefaultIEW<Impl>::dispatchInsts(ThreadID tid)
 
         ++iewDispatchedInsts;
 
-#if TRACING_ON
         inst->dispatchTick = curTick() - inst->fetchTick;
-#endif
         ppDispatch->notify(inst);
     }
 
@@ -1584,11 +1581,7 @@ DefaultIEW<Impl>::updateExeInstStats(DynInstPtr &inst)
 
     iewExecutedInsts++;
 
-#if TRACING_ON
-    if (DTRACE(O3PipeView)) {
-        inst->completeTick = curTick() - inst->fetchTick;
-    }
-#endif
+    inst->completeTick = curTick() - inst->fetchTick;
 
     //
     //  Control operations
@@ -46,12 +46,12 @@
 
 #include <list>
 #include <map>
-#include <queue>
 #include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
-#include "cpu/o3/dep_graph.hh"
+#include "cpu/o3/comm.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
@@ -62,9 +62,10 @@ class FUPool;
 class MemInterface;
 
 /**
- * A standard instruction queue class.  It holds ready instructions, in
- * order, in seperate priority queues to facilitate the scheduling of
- * instructions.  The IQ uses a separate linked list to track dependencies.
+ * A standard instruction queue class.  It tracks register dependencies
+ * in a wakeup matrix, with a bitmap of waiting instructions per
+ * physical register, and keeps the ready instructions in an age ordered
+ * bitmap from which the oldest ones are selected for issue.
  * Similar to the rename map and the free list, it expects that
  * floating point registers have their indices start after the integer
  * registers (ie with 96 int and 96 fp registers, regs 0-95 are integer
@@ -92,7 +93,7 @@ class InstructionQueue
     typedef typename Impl::CPUPol::TimeStruct TimeStruct;
 
     // Typedef of iterator through the list of instructions.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename CircularQueue<DynInstPtr>::iterator ListIt;
 
     /** FU completion event class. */
     class FUCompletion : public Event {
@@ -309,10 +310,10 @@ class InstructionQueue
     //////////////////////////////////////
 
     /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    CircularQueue<DynInstPtr> instList[Impl::MaxThreads];
 
     /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    CircularQueue<DynInstPtr> instsToExecute;
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
@@ -327,28 +328,6 @@ class InstructionQueue
      */
     std::list<DynInstPtr> retryMemInsts;
 
-    /**
-     * Struct for comparing entries to be added to the priority queue.
-     * This gives reverse ordering to the instructions in terms of
-     * sequence numbers: the instructions with smaller sequence
-     * numbers (and hence are older) will be at the top of the
-     * priority queue.
-     */
-    struct pqCompare {
-        bool operator() (const DynInstPtr &lhs, const DynInstPtr &rhs) const
-        {
-            return lhs->seqNum > rhs->seqNum;
-        }
-    };
-
-    typedef std::priority_queue<DynInstPtr, std::vector<DynInstPtr>, pqCompare>
-    ReadyInstQueue;
-
-    /** List of ready instructions, per op class.  They are separated by op
-     *  class to allow for easy mapping to FUs.
-     */
-    ReadyInstQueue readyInsts[Num_OpClasses];
-
     /** List of non-speculative instructions that will be scheduled
      *  once the IQ gets a signal from commit.  While it's redundant to
      *  have the key be a part of the value (the sequence number is stored
@@ -360,41 +339,88 @@ class InstructionQueue
 
     typedef typename std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
 
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry {
-        OpClass queueType;
-        InstSeqNum oldestInst;
-    };
+    //////////////////////////////////////
+    // Wakeup and select
+    //////////////////////////////////////
 
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
+    /**
+     * Instructions in the IQ are identified by their position in the
+     * instruction list of their thread, which is in age order and
+     * does not change while the instruction is in the IQ. The wakeup
+     * and select state is kept as bitmaps over these positions, one
+     * bitmap per thread, so that waking up the consumers of a
+     * register and finding the oldest ready instructions are both a
+     * matter of scanning a few words with find-first-set.
      */
-    std::list<ListOrderEntry> listOrder;
 
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+    /** Number of positions in the per-thread instruction lists. */
+    unsigned listSize;
 
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
+    /** Number of 64-bit words in a bitmap over the positions. */
+    unsigned listWords;
 
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
+    /**
+     * The wakeup matrix, holding for every physical register and
+     * thread a bitmap of the instructions waiting for the register.
      */
-    ListOrderIt readyIt[Num_OpClasses];
+    std::vector<uint64_t> consumers;
+
+    /** Per-thread bitmap of the instructions ready to issue. */
+    std::vector<uint64_t> readyInsts[Impl::MaxThreads];
 
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
+    /** Number of instructions ready to issue across all threads. */
+    unsigned numReadyInsts;
+
+    /** Position of an instruction in the bitmaps of its thread. */
+    unsigned listPos(const DynInstPtr &inst) const
+    { return inst->iqIdx & (listSize - 1); }
+
+    /** Bitmap of the consumers of a register within a thread. */
+    uint64_t *consumersOf(PhysRegIndex reg, ThreadID tid)
+    { return &consumers[(reg * numThreads + tid) * listWords]; }
+
+    /** Does any instruction wait for the given register. */
+    bool hasConsumers(PhysRegIndex reg);
+
+    /** Is the instruction still in the instruction list of its thread. */
+    bool inInstList(const DynInstPtr &inst);
+
+    /** Appends an instruction to the instruction list of its thread. */
+    void addToInstList(DynInstPtr &new_inst);
 
     /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
+     * Doubles the number of positions in the bitmaps, moving the bits
+     * of the instructions in the lists to their new positions.
      */
-    void moveToYoungerInst(ListOrderIt age_order_it);
+    void growBitmaps();
 
-    DependencyGraph<DynInstPtr> dependGraph;
+    /**
+     * Sets the bits of a grown bitmap from a bitmap over the previous
+     * number of positions.
+     */
+    void moveBits(const uint64_t *old_bits, unsigned old_size,
+                  uint64_t *new_bits, ThreadID tid);
+
+    /** Marks an instruction as ready to issue. */
+    void setReady(const DynInstPtr &inst);
+
+    /** Removes an instruction from the ready bitmap, if it is there. */
+    void clearReady(const DynInstPtr &inst);
+
+    /** Removes an instruction from the wakeup matrix. */
+    void removeFromDependents(const DynInstPtr &inst);
+
+    /**
+     * Finds the oldest ready instruction of a thread, starting at the
+     * given index of its instruction list, skipping instructions of
+     * op classes that have no free FU this cycle.
+     *
+     * @param tid Thread to look at
+     * @param from Index in the instruction list to start at
+     * @param fu_busy Per op class flag telling if the FUs are busy
+     * @return Index of the instruction, or the end of the list
+     */
+    uint64_t findReady(ThreadID tid, uint64_t from, const bool *fu_busy);
 
     //////////////////////////////////////
     // Various parameters
@@ -450,10 +476,10 @@ class InstructionQueue
      */
     std::vector<bool> regScoreboard;
 
-    /** Adds an instruction to the dependency graph, as a consumer. */
+    /** Adds an instruction to the wakeup matrix, as a consumer. */
     bool addToDependents(DynInstPtr &new_inst);
 
-    /** Adds an instruction to the dependency graph, as a producer. */
+    /** Records an instruction as the producer of its registers. */
     void addToProducers(DynInstPtr &new_inst);
 
     /** Moves an instruction to the ready queue if it is ready. */
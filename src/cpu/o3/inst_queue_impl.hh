@@ -45,9 +45,11 @@
 #ifndef __CPU_O3_INST_QUEUE_IMPL_HH__
 #define __CPU_O3_INST_QUEUE_IMPL_HH__
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "cpu/o3/fu_pool.hh"
 #include "cpu/o3/inst_queue.hh"
 #include "debug/IQ.hh"
@@ -101,10 +103,6 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
     numPhysRegs = params->numPhysIntRegs + params->numPhysFloatRegs +
         params->numPhysCCRegs;
 
-    //Create an entry for each physical register within the
-    //dependency graph.
-    dependGraph.resize(numPhysRegs);
-
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
 
@@ -114,6 +112,28 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
         memDepUnit[tid].setIQ(this);
     }
 
+    // Instructions stay on the per-thread lists until the commit
+    // notice reaches the IQ, while the ROB entries they leave behind
+    // are refilled by dispatch straight away. Size the lists for a
+    // full ROB plus the instructions committed in the meantime, and
+    // use their positions to index the wakeup matrix and the ready
+    // bitmaps. This is only an estimate, the bitmaps grow with the
+    // lists should it be exceeded.
+    unsigned list_entries = params->numROBEntries + params->commitWidth *
+        (params->commitToIEWDelay + params->iewToCommitDelay);
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        instList[tid] = CircularQueue<DynInstPtr>(
+            std::max(list_entries, 64U));
+    }
+    instsToExecute = CircularQueue<DynInstPtr>(numEntries);
+
+    listSize = instList[0].capacity();
+    listWords = listSize / 64;
+    consumers.resize(numPhysRegs * numThreads * listWords);
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        readyInsts[tid].resize(listWords);
+    }
+
     resetState();
 
     std::string policy = params->smtIQPolicy;
@@ -167,11 +187,6 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
 template <class Impl>
 InstructionQueue<Impl>::~InstructionQueue()
 {
-    dependGraph.reset();
-#ifdef DEBUG
-    cprintf("Nodes traversed: %i, removed: %i\n",
-            dependGraph.nodesTraversed, dependGraph.nodesRemoved);
-#endif
 }
 
 template <class Impl>
@@ -404,14 +419,12 @@ InstructionQueue<Impl>::resetState()
         squashedSeqNum[tid] = 0;
     }
 
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        while (!readyInsts[i].empty())
-            readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
+    std::fill(consumers.begin(), consumers.end(), 0);
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        std::fill(readyInsts[tid].begin(), readyInsts[tid].end(), 0);
     }
+    numReadyInsts = 0;
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -444,7 +457,8 @@ template <class Impl>
 void
 InstructionQueue<Impl>::drainSanityCheck() const
 {
-    assert(dependGraph.empty());
+    assert(std::all_of(consumers.begin(), consumers.end(),
+                       [](uint64_t w) { return w == 0; }));
     assert(instsToExecute.empty());
     for (ThreadID tid = 0; tid < numThreads; ++tid)
         memDepUnit[tid].drainSanityCheck();
@@ -533,17 +547,7 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
-        return true;
-    }
-
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        if (!readyInsts[i].empty()) {
-            return true;
-        }
-    }
-
-    return false;
+    return numReadyInsts != 0;
 }
 
 template <class Impl>
@@ -559,7 +563,7 @@ InstructionQueue<Impl>::insert(DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    addToInstList(new_inst);
 
     --freeEntries;
 
@@ -604,7 +608,7 @@ InstructionQueue<Impl>::insertNonSpec(DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    addToInstList(new_inst);
 
     --freeEntries;
 
@@ -651,59 +655,6 @@ InstructionQueue<Impl>::getInstToExecute()
     return inst;
 }
 
-template <class Impl>
-void
-InstructionQueue<Impl>::addToOrderList(OpClass op_class)
-{
-    assert(!readyInsts[op_class].empty());
-
-    ListOrderEntry queue_entry;
-
-    queue_entry.queueType = op_class;
-
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
-
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
-        }
-
-        list_it++;
-    }
-
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
-}
-
-template <class Impl>
-void
-InstructionQueue<Impl>::moveToYoungerInst(ListOrderIt list_order_it)
-{
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
-    }
-
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
-}
-
 template <class Impl>
 void
 InstructionQueue<Impl>::processFUCompletion(DynInstPtr &inst, int fu_idx)
@@ -746,40 +697,47 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
-    // Have iterator to head of the list
-    // While I haven't exceeded bandwidth or reached the end of the list,
-    // Try to get a FU that can do what this op needs.
-    // If successful, change the oldestInst to the new top of the list, put
-    // the queue in the proper place in the list.
-    // Increment the iterator.
-    // This will avoid trying to schedule a certain op class if there are no
-    // FUs that handle it.
+    // Walk the ready instructions from oldest to youngest, merging
+    // the threads by age, until the issue width is exhausted. An op
+    // class that fails to get a FU is skipped for the rest of the
+    // cycle.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
+    bool fu_busy[Num_OpClasses] = {};
+    uint64_t ready_it[Impl::MaxThreads];
+    uint64_t ready_end[Impl::MaxThreads];
 
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        ready_it[tid] = instList[tid].begin().index();
+        ready_end[tid] = instList[tid].end().index();
+    }
 
-        assert(!readyInsts[op_class].empty());
+    while (total_issued < totalWidth && numReadyInsts != 0) {
+        ThreadID tid = InvalidThreadID;
+        DynInstPtr issuing_inst;
 
-        DynInstPtr issuing_inst = readyInsts[op_class].top();
+        for (ThreadID t = 0; t < numThreads; ++t) {
+            ready_it[t] = findReady(t, ready_it[t], fu_busy);
+            if (ready_it[t] == ready_end[t])
+                continue;
 
-        issuing_inst->isFloating() ? fpInstQueueReads++ : intInstQueueReads++;
+            const DynInstPtr &inst = instList[t][ready_it[t]];
+            if (!issuing_inst || inst->seqNum < issuing_inst->seqNum) {
+                issuing_inst = inst;
+                tid = t;
+            }
+        }
+
+        if (tid == InvalidThreadID)
+            break;
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
+        ++ready_it[tid];
 
-        if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
+        OpClass op_class = issuing_inst->opClass();
 
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+        issuing_inst->isFloating() ? fpInstQueueReads++ : intInstQueueReads++;
 
-            listOrder.erase(order_it++);
+        if (issuing_inst->isSquashed()) {
+            clearReady(issuing_inst);
 
             ++iqSquashedInstsIssued;
 
@@ -788,7 +746,6 @@ InstructionQueue<Impl>::scheduleReadyInsts()
 
         int idx = -2;
         Cycles op_latency = Cycles(1);
-        ThreadID tid = issuing_inst->threadNumber;
 
         if (op_class != No_OpClass) {
             idx = fuPool->getUnit(op_class);
@@ -834,21 +791,12 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                     tid, issuing_inst->pcState(),
                     issuing_inst->seqNum);
 
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+            clearReady(issuing_inst);
 
             issuing_inst->setIssued();
             ++total_issued;
 
-#if TRACING_ON
             issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
-#endif
 
             if (!issuing_inst->isMemRef()) {
                 // Memory instructions can not be freed from the IQ until they
@@ -860,12 +808,11 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
             statIssuedInstType[tid][op_class]++;
         } else {
             statFuBusy[op_class]++;
             fuBusy[tid]++;
-            ++order_it;
+            fu_busy[op_class] = true;
         }
     }
 
@@ -918,11 +865,10 @@ InstructionQueue<Impl>::commit(const InstSeqNum &inst, ThreadID tid)
     DPRINTF(IQ, "[tid:%i]: Committing instructions older than [sn:%i]\n",
             tid,inst);
 
-    ListIt iq_it = instList[tid].begin();
-
-    while (iq_it != instList[tid].end() &&
-           (*iq_it)->seqNum <= inst) {
-        ++iq_it;
+    while (!instList[tid].empty() &&
+           instList[tid].front()->seqNum <= inst) {
+        clearReady(instList[tid].front());
+        removeFromDependents(instList[tid].front());
         instList[tid].pop_front();
     }
 
@@ -960,6 +906,8 @@ InstructionQueue<Impl>::wakeDependents(DynInstPtr &completed_inst)
         memDepUnit[completed_inst->threadNumber].completeBarrier(completed_inst);
     }
 
+    ThreadID tid = completed_inst->threadNumber;
+
     for (int dest_reg_idx = 0;
          dest_reg_idx < completed_inst->numDestRegs();
          dest_reg_idx++)
@@ -979,31 +927,38 @@ InstructionQueue<Impl>::wakeDependents(DynInstPtr &completed_inst)
         DPRINTF(IQ, "Waking any dependents on register %i.\n",
                 (int) dest_reg);
 
-        //Go through the dependency chain, marking the registers as
-        //ready within the waiting instructions.
-        DynInstPtr dep_inst = dependGraph.pop(dest_reg);
+        // Go through the register's row of the wakeup matrix, marking
+        // the register as ready within the waiting instructions. Only
+        // instructions of the producing thread can consume it.
+        uint64_t *row = consumersOf(dest_reg, tid);
+        uint64_t head = instList[tid].begin().index();
 
-        while (dep_inst) {
-            DPRINTF(IQ, "Waking up a dependent instruction, [sn:%lli] "
-                    "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
+        for (unsigned word = 0; word < listWords; ++word) {
+            uint64_t bits = row[word];
+            row[word] = 0;
 
-            // Might want to give more information to the instruction
-            // so that it knows which of its source registers is
-            // ready.  However that would mean that the dependency
-            // graph entries would need to hold the src_reg_idx.
-            dep_inst->markSrcRegReady();
+            while (bits) {
+                int bit = findLsbSet(bits);
+                bits &= bits - 1;
 
-            addIfReady(dep_inst);
+                uint64_t pos = word * 64 + bit;
+                DynInstPtr dep_inst =
+                    instList[tid][head + ((pos - head) & (listSize - 1))];
 
-            dep_inst = dependGraph.pop(dest_reg);
+                DPRINTF(IQ, "Waking up a dependent instruction, [sn:%lli] "
+                        "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
 
-            ++dependents;
-        }
+                // Might want to give more information to the instruction
+                // so that it knows which of its source registers is
+                // ready.  However that would mean that the matrix
+                // entries would need to hold the src_reg_idx.
+                dep_inst->markSrcRegReady();
+
+                addIfReady(dep_inst);
 
-        // Reset the head node now that all of its dependents have
-        // been woken up.
-        assert(dependGraph.empty(dest_reg));
-        dependGraph.clearInst(dest_reg);
+                ++dependents;
+            }
+        }
 
         // Mark the scoreboard as having that register ready.
         regScoreboard[dest_reg] = true;
@@ -1017,17 +972,7 @@ InstructionQueue<Impl>::addReadyMemInst(DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
-    readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
-    }
+    setReady(ready_inst);
 
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%lli].\n",
@@ -1104,7 +1049,7 @@ template <class Impl>
 typename Impl::DynInstPtr
 InstructionQueue<Impl>::getDeferredMemInstToExecute()
 {
-    for (ListIt it = deferredMemInsts.begin(); it != deferredMemInsts.end();
+    for (auto it = deferredMemInsts.begin(); it != deferredMemInsts.end();
          ++it) {
         if ((*it)->translationCompleted() || (*it)->isSquashed()) {
             DynInstPtr mem_inst = *it;
@@ -1161,26 +1106,23 @@ template <class Impl>
 void
 InstructionQueue<Impl>::doSquash(ThreadID tid)
 {
-    // Start at the tail.
-    ListIt squash_it = instList[tid].end();
-    --squash_it;
-
     DPRINTF(IQ, "[tid:%i]: Squashing until sequence number %i!\n",
             tid, squashedSeqNum[tid]);
 
     // Squash any instructions younger than the squashed sequence number
-    // given.
-    while (squash_it != instList[tid].end() &&
-           (*squash_it)->seqNum > squashedSeqNum[tid]) {
+    // given, starting at the tail.
+    while (!instList[tid].empty() &&
+           instList[tid].back()->seqNum > squashedSeqNum[tid]) {
 
-        DynInstPtr squashed_inst = (*squash_it);
+        DynInstPtr squashed_inst = instList[tid].back();
         squashed_inst->isFloating() ? fpInstQueueWrites++ : intInstQueueWrites++;
 
         // Only handle the instruction if it actually is in the IQ and
         // hasn't already been squashed in the IQ.
         if (squashed_inst->threadNumber != tid ||
             squashed_inst->isSquashedInIQ()) {
-            --squash_it;
+            clearReady(squashed_inst);
+            instList[tid].pop_back();
             continue;
         }
 
@@ -1210,18 +1152,13 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
                     PhysRegIndex src_reg =
                         squashed_inst->renamedSrcRegIdx(src_reg_idx);
 
-                    // Only remove it from the dependency graph if it
+                    // Only remove it from the wakeup matrix if it
                     // was placed there in the first place.
-
-                    // Instead of doing a linked list traversal, we
-                    // can just remove these squashed instructions
-                    // either at issue time, or when the register is
-                    // overwritten.  The only downside to this is it
-                    // leaves more room for error.
-
                     if (!squashed_inst->isReadySrcRegIdx(src_reg_idx) &&
                         src_reg < numPhysRegs) {
-                        dependGraph.remove(src_reg, squashed_inst);
+                        unsigned pos = listPos(squashed_inst);
+                        consumersOf(src_reg, tid)[pos / 64] &=
+                            ~(1ULL << (pos % 64));
                     }
 
 
@@ -1251,8 +1188,6 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
                 }
             }
 
-            // Might want to also clear out the head of the dependency graph.
-
             // Mark it as squashed within the IQ.
             squashed_inst->setSquashedInIQ();
 
@@ -1268,7 +1203,8 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
             ++freeEntries;
         }
 
-        instList[tid].erase(squash_it--);
+        clearReady(squashed_inst);
+        instList[tid].pop_back();
         ++iqSquashedInstsExamined;
     }
 }
@@ -1301,7 +1237,9 @@ InstructionQueue<Impl>::addToDependents(DynInstPtr &new_inst)
                         "is being added to the dependency chain.\n",
                         new_inst->pcState(), src_reg);
 
-                dependGraph.insert(src_reg, new_inst);
+                unsigned pos = listPos(new_inst);
+                consumersOf(src_reg, new_inst->threadNumber)[pos / 64] |=
+                    1ULL << (pos % 64);
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1324,9 +1262,8 @@ void
 InstructionQueue<Impl>::addToProducers(DynInstPtr &new_inst)
 {
     // Nothing really needs to be marked when an instruction becomes
-    // the producer of a register's value, but for convenience a ptr
-    // to the producing instruction will be placed in the head node of
-    // the dependency links.
+    // the producer of a register's value other than the scoreboard;
+    // the register's row of the wakeup matrix must be empty though.
     int8_t total_dest_regs = new_inst->numDestRegs();
 
     for (int dest_reg_idx = 0;
@@ -1343,13 +1280,11 @@ InstructionQueue<Impl>::addToProducers(DynInstPtr &new_inst)
             continue;
         }
 
-        if (!dependGraph.empty(dest_reg)) {
-            dependGraph.dump();
-            panic("Dependency graph %i not empty!", dest_reg);
+        if (hasConsumers(dest_reg)) {
+            dumpLists();
+            panic("Wakeup matrix row %i not empty!", dest_reg);
         }
 
-        dependGraph.setInst(dest_reg, new_inst);
-
         // Mark the scoreboard to say it's not yet ready.
         regScoreboard[dest_reg] = false;
     }
@@ -1381,18 +1316,187 @@ InstructionQueue<Impl>::addIfReady(DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%lli].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
+        setReady(inst);
+    }
+}
 
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
+template <class Impl>
+bool
+InstructionQueue<Impl>::hasConsumers(PhysRegIndex reg)
+{
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        uint64_t *row = consumersOf(reg, tid);
+        for (unsigned word = 0; word < listWords; ++word) {
+            if (row[word])
+                return true;
         }
     }
+
+    return false;
+}
+
+template <class Impl>
+bool
+InstructionQueue<Impl>::inInstList(const DynInstPtr &inst)
+{
+    ThreadID tid = inst->threadNumber;
+
+    return instList[tid].contains(inst->iqIdx) &&
+        instList[tid][inst->iqIdx] == inst;
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::addToInstList(DynInstPtr &new_inst)
+{
+    ThreadID tid = new_inst->threadNumber;
+
+    // The positions of the instructions in a list have to be distinct
+    if (instList[tid].size() == listSize)
+        growBitmaps();
+
+    instList[tid].push_back(new_inst);
+    new_inst->iqIdx = (--instList[tid].end()).index();
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::growBitmaps()
+{
+    unsigned old_size = listSize;
+    unsigned old_words = listWords;
+    listSize *= 2;
+    listWords *= 2;
+
+    DPRINTF(IQ, "Growing the IQ bitmaps to %i positions.\n", listSize);
+
+    std::vector<uint64_t> old_consumers(numPhysRegs * numThreads *
+                                        listWords, 0);
+    old_consumers.swap(consumers);
+
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        std::vector<uint64_t> old_ready(listWords, 0);
+        old_ready.swap(readyInsts[tid]);
+        moveBits(&old_ready[0], old_size, &readyInsts[tid][0], tid);
+
+        for (PhysRegIndex reg = 0; reg < numPhysRegs; ++reg) {
+            moveBits(&old_consumers[(reg * numThreads + tid) * old_words],
+                     old_size, consumersOf(reg, tid), tid);
+        }
+    }
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::moveBits(const uint64_t *old_bits,
+                                 unsigned old_size, uint64_t *new_bits,
+                                 ThreadID tid)
+{
+    uint64_t head = instList[tid].begin().index();
+
+    for (unsigned word = 0; word < old_size / 64; ++word) {
+        uint64_t bits = old_bits[word];
+        while (bits) {
+            uint64_t pos = word * 64 + findLsbSet(bits);
+            bits &= bits - 1;
+
+            // A position maps back to the one instruction of the list
+            // it can belong to, whose index gives the new position
+            uint64_t idx = head + ((pos - head) & (old_size - 1));
+            unsigned new_pos = idx & (listSize - 1);
+            new_bits[new_pos / 64] |= 1ULL << (new_pos % 64);
+        }
+    }
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::setReady(const DynInstPtr &inst)
+{
+    // Instructions can become ready after they have been squashed and
+    // removed from the list, in which case they must not be issued.
+    if (!inInstList(inst)) {
+        assert(inst->isSquashed());
+        return;
+    }
+
+    unsigned pos = listPos(inst);
+    uint64_t &word = readyInsts[inst->threadNumber][pos / 64];
+    uint64_t bit = 1ULL << (pos % 64);
+
+    if (!(word & bit)) {
+        word |= bit;
+        ++numReadyInsts;
+    }
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::clearReady(const DynInstPtr &inst)
+{
+    if (!inInstList(inst))
+        return;
+
+    unsigned pos = listPos(inst);
+    uint64_t &word = readyInsts[inst->threadNumber][pos / 64];
+    uint64_t bit = 1ULL << (pos % 64);
+
+    if (word & bit) {
+        word &= ~bit;
+        --numReadyInsts;
+    }
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::removeFromDependents(const DynInstPtr &inst)
+{
+    unsigned pos = listPos(inst);
+
+    for (int src_reg_idx = 0;
+         src_reg_idx < inst->numSrcRegs();
+         src_reg_idx++)
+    {
+        PhysRegIndex src_reg = inst->renamedSrcRegIdx(src_reg_idx);
+
+        if (!inst->isReadySrcRegIdx(src_reg_idx) && src_reg < numPhysRegs) {
+            consumersOf(src_reg, inst->threadNumber)[pos / 64] &=
+                ~(1ULL << (pos % 64));
+        }
+    }
+}
+
+template <class Impl>
+uint64_t
+InstructionQueue<Impl>::findReady(ThreadID tid, uint64_t from,
+                                  const bool *fu_busy)
+{
+    const std::vector<uint64_t> &ready = readyInsts[tid];
+    uint64_t tail = instList[tid].end().index();
+    uint64_t idx = from;
+
+    // The list is circular over the bitmap, so walk the absolute
+    // indices from the given one and map them onto the positions.
+    while (idx < tail) {
+        unsigned pos = idx & (listSize - 1);
+        uint64_t bits = ready[pos / 64] >> (pos % 64);
+
+        if (!bits) {
+            idx += 64 - pos % 64;
+            continue;
+        }
+
+        idx += findLsbSet(bits);
+        if (idx >= tail)
+            break;
+
+        if (!fu_busy[instList[tid][idx]->opClass()])
+            return idx;
+
+        ++idx;
+    }
+
+    return tail;
 }
 
 template <class Impl>
@@ -1435,10 +1539,12 @@ template <class Impl>
 void
 InstructionQueue<Impl>::dumpLists()
 {
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        int ready = 0;
+        for (auto word : readyInsts[tid])
+            ready += popCount(word);
 
-        cprintf("\n");
+        cprintf("Ready list %i size: %i\n", tid, ready);
     }
 
     cprintf("Non speculative list size: %i\n", nonSpecInsts.size());
@@ -1455,22 +1561,6 @@ InstructionQueue<Impl>::dumpLists()
     }
 
     cprintf("\n");
-
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
-    int i = 1;
-
-    cprintf("List order: ");
-
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%lli] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
-
-        ++list_order_it;
-        ++i;
-    }
-
-    cprintf("\n");
 }
 
 
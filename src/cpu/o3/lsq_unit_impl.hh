@@ -56,7 +56,6 @@
 #include "debug/Activity.hh"
 #include "debug/IEW.hh"
 #include "debug/LSQUnit.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 
@@ -1170,12 +1169,8 @@ LSQUnit<Impl>::completeStore(int store_idx)
             "idx:%i\n",
             storeQueue[store_idx].inst->seqNum, store_idx, storeHead);
 
-#if TRACING_ON
-    if (DTRACE(O3PipeView)) {
-        storeQueue[store_idx].inst->storeTick =
-            curTick() - storeQueue[store_idx].inst->fetchTick;
-    }
-#endif
+    storeQueue[store_idx].inst->storeTick =
+        curTick() - storeQueue[store_idx].inst->fetchTick;
 
     if (isStalled() &&
         storeQueue[store_idx].inst->seqNum == stallingStoreIsn) {
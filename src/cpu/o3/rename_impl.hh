@@ -54,7 +54,6 @@
 #include "cpu/reg_class.hh"
 #include "debug/Activity.hh"
 #include "debug/Rename.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 
 using namespace std;
@@ -771,11 +770,7 @@ DefaultRename<Impl>::sortInsts()
     for (int i = 0; i < insts_from_decode; ++i) {
         DynInstPtr inst = fromDecode->insts[i];
         insts[inst->threadNumber].push_back(inst);
-#if TRACING_ON
-        if (DTRACE(O3PipeView)) {
-            inst->renameTick = curTick() - inst->fetchTick;
-        }
-#endif
+        inst->renameTick = curTick() - inst->fetchTick;
     }
 }
 
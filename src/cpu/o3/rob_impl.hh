@@ -103,6 +103,10 @@ ROB<Impl>::ROB(O3CPU *_cpu, DerivO3CPUParams *params)
                     "Partitioned, Threshold}");
     }
 
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        instList[tid] = CircularQueue<DynInstPtr>(maxEntries[tid]);
+    }
+
     resetState();
 }
 
@@ -269,7 +273,7 @@ ROB<Impl>::retireHead(ThreadID tid)
     head_inst->clearInROB();
     head_inst->setCommitted();
 
-    instList[tid].erase(head_it);
+    instList[tid].pop_front();
 
     //Update "Global" Head of ROB
     updateHead();
@@ -36,7 +36,8 @@ class BranchPredictor(SimObject):
 
     numThreads = Param.Unsigned(1, "Number of threads")
     predType = Param.String("tournament",
-        "Branch predictor type ('local', 'tournament', 'bi-mode')")
+        "Branch predictor type ('local', 'tournament', 'bi-mode', 'tage', "
+        "'perceptron')")
     localPredictorSize = Param.Unsigned(2048, "Size of local predictor")
     localCtrBits = Param.Unsigned(2, "Bits per counter")
     localHistoryTableSize = Param.Unsigned(2048, "Size of local history table")
@@ -45,6 +46,26 @@ class BranchPredictor(SimObject):
     choicePredictorSize = Param.Unsigned(8192, "Size of choice predictor")
     choiceCtrBits = Param.Unsigned(2, "Bits of choice counters")
 
+    tageNumTables = Param.Unsigned(7, "Number of TAGE tagged tables")
+    tageTableSize = Param.Unsigned(1024, "Entries per TAGE tagged table")
+    tageBaseSize = Param.Unsigned(8192, "Size of TAGE base predictor")
+    tageTagBits = Param.Unsigned(9, "Size of the TAGE tags, in bits")
+    tageMinHist = Param.Unsigned(5, "Shortest TAGE history length")
+    tageMaxHist = Param.Unsigned(130, "Longest TAGE history length")
+    tageLoopPredictor = Param.Bool(False, "Use a loop predictor with TAGE")
+    tageLoopTableSize = Param.Unsigned(64, "Size of TAGE loop predictor")
+    tageStatCorrector = Param.Bool(False,
+        "Use a statistical corrector with TAGE")
+    tageSCTableSize = Param.Unsigned(1024,
+        "Size of TAGE statistical corrector tables")
+
+    perceptronNumTables = Param.Unsigned(8,
+        "Number of perceptron weight tables, including the bias table")
+    perceptronTableSize = Param.Unsigned(1024, "Entries per weight table")
+    perceptronHistoryLength = Param.Unsigned(64,
+        "Global history length of the perceptron predictor (at most 64)")
+    perceptronWeightBits = Param.Unsigned(8, "Bits per perceptron weight")
+
     BTBEntries = Param.Unsigned(4096, "Number of BTB entries")
     BTBTagSize = Param.Unsigned(16, "Size of the BTB tags, in bits")
 
@@ -34,6 +34,8 @@
 #include "cpu/pred/2bit_local.hh"
 #include "cpu/pred/bi_mode.hh"
 #include "cpu/pred/bpred_unit_impl.hh"
+#include "cpu/pred/perceptron.hh"
+#include "cpu/pred/tage.hh"
 #include "cpu/pred/tournament.hh"
 
 BPredUnit *
@@ -46,6 +48,10 @@ BranchPredictorParams::create()
         return new TournamentBP(this);
     } else if (predType == "bi-mode") {
         return new BiModeBP(this);
+    } else if (predType == "tage") {
+        return new TAGEBP(this);
+    } else if (predType == "perceptron") {
+        return new PerceptronBP(this);
     } else {
         fatal("Invalid BP selected!");
     }
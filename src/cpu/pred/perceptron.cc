@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a hashed perceptron branch predictor
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "cpu/pred/perceptron.hh"
+
+namespace
+{
+
+/** Saturation value of the threshold adaptation counter. */
+const int ThetaCtrMax = 64;
+
+} // anonymous namespace
+
+PerceptronBP::PerceptronBP(const Params *params)
+    : BPredUnit(params), instShiftAmt(params->instShiftAmt),
+      numTables(params->perceptronNumTables),
+      logTableSize(floorLog2(params->perceptronTableSize)),
+      tableMask(params->perceptronTableSize - 1),
+      historyLength(params->perceptronHistoryLength),
+      weightMax((1 << (params->perceptronWeightBits - 1)) - 1),
+      weightMin(-(1 << (params->perceptronWeightBits - 1))),
+      histLengths(numTables, 0),
+      weights(numTables,
+              std::vector<int8_t>(params->perceptronTableSize, 0)),
+      globalHistory(0), historyMask(mask(historyLength)),
+      theta(int(2.14 * (numTables + 1) + 20.58)), thetaCtr(0)
+{
+    if (!isPowerOf2(params->perceptronTableSize))
+        fatal("Invalid perceptron table size.\n");
+    // The history is folded in chunks of log2(table size) bits
+    fatal_if(params->perceptronTableSize < 2,
+             "The perceptron tables need at least two entries.\n");
+    if (numTables < 1)
+        fatal("The perceptron predictor needs at least one table.\n");
+    if (historyLength < 1 || historyLength > 64)
+        fatal("Perceptron history length has to be 1 to 64 bits.\n");
+    if (params->perceptronWeightBits < 2 ||
+        params->perceptronWeightBits > 8)
+        fatal("Perceptron weights have to be 2 to 8 bits.\n");
+
+    // The history lengths of the tables after the bias table form a
+    // geometric series ending at the full history
+    for (unsigned i = 1; i < numTables; ++i) {
+        double exp = double(i) / (numTables - 1);
+        histLengths[i] = std::min(historyLength, unsigned(
+            std::ceil(std::pow(double(historyLength), exp))));
+    }
+}
+
+void
+PerceptronBP::regStats()
+{
+    BPredUnit::regStats();
+
+    trainings
+        .name(name() + ".perceptronTrainings")
+        .desc("Number of times the perceptron weights were trained")
+        ;
+}
+
+unsigned
+PerceptronBP::index(Addr branch_addr, unsigned table) const
+{
+    Addr pc = branch_addr >> instShiftAmt;
+    uint64_t idx = pc * (2 * table + 1);
+    uint64_t hist = globalHistory & mask(histLengths[table]);
+
+    // Fold the history segment down to the width of an index
+    while (hist) {
+        idx ^= hist;
+        hist >>= logTableSize;
+    }
+    return (idx ^ (idx >> logTableSize)) & tableMask;
+}
+
+void
+PerceptronBP::updateGlobalHistory(bool taken)
+{
+    globalHistory = ((globalHistory << 1) | taken) & historyMask;
+}
+
+void
+PerceptronBP::uncondBranch(void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    history->globalHistory = globalHistory;
+    history->conditional = false;
+    history->sum = 0;
+    history->pred = true;
+    bp_history = static_cast<void*>(history);
+    updateGlobalHistory(true);
+}
+
+void
+PerceptronBP::squash(void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    globalHistory = history->globalHistory;
+
+    delete history;
+}
+
+bool
+PerceptronBP::lookup(Addr branch_addr, void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    history->globalHistory = globalHistory;
+    history->conditional = true;
+    history->indices.resize(numTables);
+
+    int sum = 0;
+    for (unsigned i = 0; i < numTables; ++i) {
+        history->indices[i] = index(branch_addr, i);
+        sum += weights[i][history->indices[i]];
+    }
+    history->sum = sum;
+    history->pred = sum >= 0;
+
+    bp_history = static_cast<void*>(history);
+    updateGlobalHistory(history->pred);
+
+    return history->pred;
+}
+
+void
+PerceptronBP::btbUpdate(Addr branch_addr, void * &bp_history)
+{
+    // The branch is predicted not taken for lack of a target
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    globalHistory = history->globalHistory;
+    updateGlobalHistory(false);
+    history->pred = false;
+}
+
+void
+PerceptronBP::update(Addr branch_addr, bool taken, void *bp_history,
+                     bool squashed)
+{
+    if (!bp_history)
+        return;
+
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    if (history->conditional)
+        train(taken, history);
+
+    if (squashed) {
+        // Redo the speculative history update with the actual outcome;
+        // the history is deleted when the branch retires
+        globalHistory = history->globalHistory;
+        updateGlobalHistory(taken);
+        history->pred = taken;
+    } else {
+        delete history;
+    }
+}
+
+void
+PerceptronBP::retireSquashed(void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    delete history;
+}
+
+void
+PerceptronBP::train(bool taken, BPHistory *history)
+{
+    bool mispredicted = history->pred != taken;
+    int magnitude = std::abs(history->sum);
+    if (!mispredicted && magnitude > theta)
+        return;
+
+    ++trainings;
+    for (unsigned i = 0; i < numTables; ++i) {
+        int8_t &weight = weights[i][history->indices[i]];
+        if (taken && weight < weightMax)
+            ++weight;
+        else if (!taken && weight > weightMin)
+            --weight;
+    }
+
+    // Raise the threshold when mispredictions dominate the trainings
+    // and lower it when low confidence correct predictions do
+    if (mispredicted) {
+        if (++thetaCtr >= ThetaCtrMax) {
+            ++theta;
+            thetaCtr = 0;
+        }
+    } else if (--thetaCtr <= -ThetaCtrMax) {
+        if (theta > 0)
+            --theta;
+        thetaCtr = 0;
+    }
+}
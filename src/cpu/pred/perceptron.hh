@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a hashed perceptron branch predictor
+ */
+
+#ifndef __CPU_PRED_PERCEPTRON_PRED_HH__
+#define __CPU_PRED_PERCEPTRON_PRED_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/pred/bpred_unit.hh"
+
+/**
+ * Implements a hashed perceptron branch predictor. Instead of one
+ * weight per history bit, every table holds weights indexed by a
+ * hash of the branch address and a global history segment of
+ * geometrically increasing length, and the prediction is the sign of
+ * the sum of the selected weights. Table 0 is indexed by the branch
+ * address alone and provides the bias weight.
+ *
+ * The weights are only trained on mispredictions and on predictions
+ * whose sum is below a threshold, which is adapted at run time to
+ * balance the two.
+ */
+class PerceptronBP : public BPredUnit
+{
+  public:
+    PerceptronBP(const Params *params);
+    void regStats();
+    void uncondBranch(void * &bp_history);
+    void squash(void *bp_history);
+    bool lookup(Addr branch_addr, void * &bp_history);
+    void btbUpdate(Addr branch_addr, void * &bp_history);
+    void update(Addr branch_addr, bool taken, void *bp_history, bool squashed);
+    void retireSquashed(void *bp_history);
+
+  private:
+    struct BPHistory
+    {
+        /** The speculative global history as it was before the branch. */
+        uint64_t globalHistory;
+        bool conditional;
+        std::vector<unsigned> indices;
+        int sum;
+        bool pred;
+    };
+
+    unsigned index(Addr branch_addr, unsigned table) const;
+    void updateGlobalHistory(bool taken);
+    void train(bool taken, BPHistory *history);
+
+    unsigned instShiftAmt;
+
+    unsigned numTables;
+    unsigned logTableSize;
+    unsigned tableMask;
+    unsigned historyLength;
+    int weightMax;
+    int weightMin;
+
+    /** Global history bits used by each table, 0 for the bias table. */
+    std::vector<unsigned> histLengths;
+    std::vector<std::vector<int8_t> > weights;
+
+    uint64_t globalHistory;
+    uint64_t historyMask;
+
+    /** Sums of at most this magnitude are trained even when correct. */
+    int theta;
+    int thetaCtr;
+
+    /** Stat for the number of times the weights were trained. */
+    Stats::Scalar trainings;
+};
+
+#endif // __CPU_PRED_PERCEPTRON_PRED_HH__
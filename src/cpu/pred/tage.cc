@@ -0,0 +1,723 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a TAGE branch predictor
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "cpu/pred/tage.hh"
+
+namespace
+{
+
+/** Bits of the signed counters of the tagged tables. */
+const unsigned TageCtrBits = 3;
+/** Largest value of the useful counters. */
+const uint8_t UMax = 3;
+/** Trained branches between two agings of the useful counters. */
+const unsigned UResetPeriod = 1 << 18;
+
+const unsigned LoopTagBits = 14;
+const uint8_t LoopConfMax = 3;
+const uint8_t LoopAgeMax = 7;
+
+/** Number of corrector tables, including the bias table. */
+const unsigned NumSCTables = 4;
+/** History lengths of the corrector tables after the bias table. */
+const unsigned SCHistLengths[NumSCTables - 1] = { 6, 12, 24 };
+const unsigned SCCtrBits = 6;
+const int SCThresholdCtrMax = 32;
+
+} // anonymous namespace
+
+const unsigned TAGEBP::HistBufferSize;
+
+void
+TAGEBP::FoldedHistory::init(unsigned orig_length, unsigned comp_length)
+{
+    comp = 0;
+    origLength = orig_length;
+    compLength = comp_length;
+    outpoint = orig_length % comp_length;
+}
+
+void
+TAGEBP::FoldedHistory::update(const std::vector<uint8_t> &hist, unsigned pt)
+{
+    comp = (comp << 1) | hist[pt];
+    comp ^= hist[(pt + origLength) % HistBufferSize] << outpoint;
+    comp ^= comp >> compLength;
+    comp &= mask(compLength);
+}
+
+TAGEBP::TAGEBP(const Params *params)
+    : BPredUnit(params), instShiftAmt(params->instShiftAmt),
+      numTables(params->tageNumTables),
+      logTableSize(floorLog2(params->tageTableSize)),
+      tableMask(params->tageTableSize - 1),
+      baseMask(params->tageBaseSize - 1),
+      tagBits(params->tageTagBits),
+      histLengths(numTables + 1, 0),
+      base(params->tageBaseSize),
+      tables(numTables + 1),
+      useAltOnNA(0), uResetTick(0), randomSeed(1),
+      ghist(HistBufferSize, 0), ptr(0), pathHist(0),
+      useLoop(params->tageLoopPredictor),
+      logLoopSize(floorLog2(params->tageLoopTableSize)),
+      useSC(params->tageStatCorrector),
+      scMask(params->tageSCTableSize - 1),
+      scThreshold(6), scThresholdCtr(0)
+{
+    if (!isPowerOf2(params->tageTableSize))
+        fatal("Invalid TAGE table size.\n");
+    // The histories are folded down to log2(table size) bits
+    fatal_if(params->tageTableSize < 2,
+             "The TAGE tables need at least two entries.\n");
+    if (!isPowerOf2(params->tageBaseSize))
+        fatal("Invalid TAGE base predictor size.\n");
+    if (numTables < 1)
+        fatal("TAGE needs at least one tagged table.\n");
+    if (tagBits < 2 || tagBits > 16)
+        fatal("TAGE tags have to be 2 to 16 bits.\n");
+    if (params->tageMinHist < 1 ||
+        params->tageMaxHist < params->tageMinHist ||
+        params->tageMaxHist > HistBufferSize / 4)
+        fatal("Invalid TAGE history lengths.\n");
+
+    for (unsigned i = 0; i < base.size(); ++i)
+        base[i].setBits(2);
+
+    // The history lengths form a geometric series from the shortest
+    // to the longest
+    double ratio = double(params->tageMaxHist) / params->tageMinHist;
+    folded.resize(3 * numTables + (useSC ? NumSCTables - 1 : 0));
+    for (unsigned i = 1; i <= numTables; ++i) {
+        double exp = numTables > 1 ? double(i - 1) / (numTables - 1) : 0;
+        histLengths[i] = unsigned(params->tageMinHist *
+                                  std::pow(ratio, exp) + 0.5);
+
+        tables[i].resize(params->tageTableSize);
+        folded[idxFold(i)].init(histLengths[i], logTableSize);
+        folded[idxFold(i) + 1].init(histLengths[i], tagBits);
+        folded[idxFold(i) + 2].init(histLengths[i], tagBits - 1);
+    }
+
+    if (useLoop) {
+        if (!isPowerOf2(params->tageLoopTableSize))
+            fatal("Invalid TAGE loop predictor size.\n");
+        loopTable.resize(params->tageLoopTableSize);
+    }
+
+    if (useSC) {
+        if (!isPowerOf2(params->tageSCTableSize))
+            fatal("Invalid TAGE statistical corrector size.\n");
+        scTables.assign(NumSCTables,
+                        std::vector<int8_t>(params->tageSCTableSize, 0));
+        for (unsigned i = 1; i < NumSCTables; ++i) {
+            folded[scFold(i)].init(SCHistLengths[i - 1],
+                                   floorLog2(params->tageSCTableSize));
+        }
+    }
+}
+
+void
+TAGEBP::regStats()
+{
+    BPredUnit::regStats();
+
+    providerHits
+        .init(numTables + 1)
+        .name(name() + ".tageProviderHits")
+        .desc("Number of conditional branches provided by each TAGE table "
+              "(0 is the base predictor)")
+        ;
+
+    providerCorrect
+        .init(numTables + 1)
+        .name(name() + ".tageProviderCorrect")
+        .desc("Number of correct predictions of each TAGE table "
+              "(0 is the base predictor)")
+        ;
+
+    altUsed
+        .name(name() + ".tageAltUsed")
+        .desc("Number of predictions taken from the alternate TAGE table")
+        ;
+
+    loopPredicted
+        .name(name() + ".tageLoopPredicted")
+        .desc("Number of branches predicted by the loop predictor")
+        ;
+
+    loopCorrect
+        .name(name() + ".tageLoopCorrect")
+        .desc("Number of correct predictions of the loop predictor")
+        ;
+
+    scReverted
+        .name(name() + ".tageSCReverted")
+        .desc("Number of TAGE predictions reverted by the statistical "
+              "corrector")
+        ;
+
+    scCorrect
+        .name(name() + ".tageSCCorrect")
+        .desc("Number of correct reversions of the statistical corrector")
+        ;
+}
+
+void
+TAGEBP::ctrUpdate(int8_t &ctr, bool taken, unsigned bits)
+{
+    if (taken) {
+        if (ctr < (1 << (bits - 1)) - 1)
+            ++ctr;
+    } else {
+        if (ctr > -(1 << (bits - 1)))
+            --ctr;
+    }
+}
+
+unsigned
+TAGEBP::nextRandom()
+{
+    randomSeed = randomSeed * 1103515245 + 12345;
+    return randomSeed >> 16;
+}
+
+unsigned
+TAGEBP::gindex(Addr branch_addr, unsigned bank) const
+{
+    Addr pc = branch_addr >> instShiftAmt;
+    unsigned path = pathHist & mask(std::min(histLengths[bank], 16U));
+    unsigned shift = std::abs(int(logTableSize) - int(bank)) + 1;
+
+    return (pc ^ (pc >> shift) ^ folded[idxFold(bank)].comp ^
+            path ^ (path >> logTableSize)) & tableMask;
+}
+
+uint16_t
+TAGEBP::gtag(Addr branch_addr, unsigned bank) const
+{
+    Addr pc = branch_addr >> instShiftAmt;
+
+    return (pc ^ folded[idxFold(bank) + 1].comp ^
+            (folded[idxFold(bank) + 2].comp << 1)) & mask(tagBits);
+}
+
+void
+TAGEBP::saveState(HistoryState &state) const
+{
+    state.ptr = ptr;
+    state.pathHist = pathHist;
+    state.folded.resize(folded.size());
+    for (unsigned i = 0; i < folded.size(); ++i)
+        state.folded[i] = folded[i].comp;
+}
+
+void
+TAGEBP::restoreState(const HistoryState &state)
+{
+    // The buffer is large enough that the bits of older branches have
+    // not been overwritten, so moving the pointer back is sufficient
+    ptr = state.ptr;
+    pathHist = state.pathHist;
+    for (unsigned i = 0; i < folded.size(); ++i)
+        folded[i].comp = state.folded[i];
+}
+
+void
+TAGEBP::pushHistory(bool taken)
+{
+    ptr = (ptr + HistBufferSize - 1) % HistBufferSize;
+    ghist[ptr] = taken;
+    for (unsigned i = 0; i < folded.size(); ++i)
+        folded[i].update(ghist, ptr);
+}
+
+void
+TAGEBP::pushPath(Addr branch_addr)
+{
+    pathHist = (pathHist << 1) | ((branch_addr >> instShiftAmt) & 1);
+}
+
+void
+TAGEBP::uncondBranch(void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    saveState(history->state);
+    history->branchAddr = 0;
+    history->conditional = false;
+    history->finalPred = true;
+    bp_history = static_cast<void*>(history);
+    pushHistory(true);
+}
+
+void
+TAGEBP::squash(void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    restoreState(history->state);
+    if (history->conditional && useLoop)
+        loopRestore(history);
+
+    delete history;
+}
+
+bool
+TAGEBP::lookup(Addr branch_addr, void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    saveState(history->state);
+    history->branchAddr = branch_addr;
+    history->conditional = true;
+
+    history->indices.resize(numTables + 1);
+    history->tags.resize(numTables + 1);
+    history->indices[0] = (branch_addr >> instShiftAmt) & baseMask;
+    history->tags[0] = 0;
+    for (unsigned i = 1; i <= numTables; ++i) {
+        history->indices[i] = gindex(branch_addr, i);
+        history->tags[i] = gtag(branch_addr, i);
+    }
+
+    // The provider is the hitting table with the longest history, the
+    // alternate the one with the next longest
+    history->provider = 0;
+    history->altProvider = 0;
+    for (unsigned i = numTables; i > 0; --i) {
+        if (tables[i][history->indices[i]].tag != history->tags[i])
+            continue;
+        if (!history->provider) {
+            history->provider = i;
+        } else {
+            history->altProvider = i;
+            break;
+        }
+    }
+
+    bool base_pred = base[history->indices[0]].read() > 1;
+    unsigned alt = history->altProvider;
+    history->altPred = alt ?
+        tables[alt][history->indices[alt]].ctr >= 0 : base_pred;
+
+    unsigned provider = history->provider;
+    if (provider) {
+        const TaggedEntry &entry =
+            tables[provider][history->indices[provider]];
+        history->providerPred = entry.ctr >= 0;
+        // Newly allocated entries are not to be trusted until they
+        // have proven useful
+        history->usedAlt = useAltOnNA >= 0 && entry.u == 0 &&
+            (entry.ctr == 0 || entry.ctr == -1);
+    } else {
+        history->providerPred = base_pred;
+        history->usedAlt = false;
+    }
+    history->tagePred = history->usedAlt ?
+        history->altPred : history->providerPred;
+
+    bool pred = history->tagePred;
+    history->loopHit = false;
+    history->loopValid = false;
+    history->loopPred = false;
+    if (useLoop)
+        pred = loopLookup(branch_addr, history, pred);
+    history->scUsed = false;
+    if (useSC && !history->loopValid)
+        pred = scLookup(branch_addr, history, pred);
+
+    history->finalPred = pred;
+    bp_history = static_cast<void*>(history);
+
+    if (useLoop)
+        loopSpecUpdate(history, pred);
+    pushHistory(pred);
+    pushPath(branch_addr);
+
+    return pred;
+}
+
+void
+TAGEBP::btbUpdate(Addr branch_addr, void * &bp_history)
+{
+    // The branch is predicted not taken for lack of a target, so redo
+    // its speculative history update
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    restoreState(history->state);
+    if (useLoop) {
+        loopRestore(history);
+        loopSpecUpdate(history, false);
+    }
+    pushHistory(false);
+    pushPath(branch_addr);
+    history->finalPred = false;
+}
+
+void
+TAGEBP::update(Addr branch_addr, bool taken, void *bp_history, bool squashed)
+{
+    if (!bp_history)
+        return;
+
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    if (history->conditional)
+        train(branch_addr, taken, history);
+
+    if (squashed) {
+        // Redo the speculative history update with the actual outcome;
+        // the history is deleted when the branch retires
+        restoreState(history->state);
+        if (history->conditional && useLoop) {
+            loopRestore(history);
+            loopSpecUpdate(history, taken);
+        }
+        pushHistory(taken);
+        if (history->conditional)
+            pushPath(branch_addr);
+        history->finalPred = taken;
+    } else {
+        delete history;
+    }
+}
+
+void
+TAGEBP::retireSquashed(void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    delete history;
+}
+
+void
+TAGEBP::train(Addr branch_addr, bool taken, BPHistory *history)
+{
+    unsigned provider = history->provider;
+    unsigned alt = history->altProvider;
+
+    ++providerHits[provider];
+    if (history->providerPred == taken)
+        ++providerCorrect[provider];
+    if (history->usedAlt)
+        ++altUsed;
+
+    if (useLoop) {
+        if (history->loopValid) {
+            ++loopPredicted;
+            if (history->loopPred == taken)
+                ++loopCorrect;
+        }
+        loopUpdate(branch_addr, taken, history);
+    }
+
+    if (useSC && !history->scIndices.empty()) {
+        if (history->scUsed) {
+            ++scReverted;
+            if (history->scPred == taken)
+                ++scCorrect;
+        }
+        scUpdate(taken, history);
+    }
+
+    // The entries may have been reallocated since the lookup
+    TaggedEntry *entry = NULL;
+    if (provider &&
+        tables[provider][history->indices[provider]].tag ==
+        history->tags[provider]) {
+        entry = &tables[provider][history->indices[provider]];
+    }
+
+    bool alloc = history->tagePred != taken && provider < numTables;
+    if (entry && entry->u == 0 && (entry->ctr == 0 || entry->ctr == -1)) {
+        if (history->providerPred != history->altPred) {
+            if (history->altPred == taken) {
+                if (useAltOnNA < 7)
+                    ++useAltOnNA;
+            } else if (useAltOnNA > -8) {
+                --useAltOnNA;
+            }
+        }
+        // A new entry that was right only needs to gain confidence
+        if (history->providerPred == taken)
+            alloc = false;
+    }
+
+    if (alloc)
+        allocate(taken, history);
+
+    if (entry) {
+        // Train the alternate prediction along with a provider that
+        // has not proven useful yet
+        if (entry->u == 0) {
+            if (alt && tables[alt][history->indices[alt]].tag ==
+                history->tags[alt]) {
+                ctrUpdate(tables[alt][history->indices[alt]].ctr, taken,
+                          TageCtrBits);
+            } else if (!alt) {
+                if (taken)
+                    base[history->indices[0]].increment();
+                else
+                    base[history->indices[0]].decrement();
+            }
+        }
+
+        ctrUpdate(entry->ctr, taken, TageCtrBits);
+
+        if (history->providerPred != history->altPred) {
+            if (history->providerPred == taken) {
+                if (entry->u < UMax)
+                    ++entry->u;
+            } else if (entry->u > 0) {
+                --entry->u;
+            }
+        }
+    } else if (!provider) {
+        if (taken)
+            base[history->indices[0]].increment();
+        else
+            base[history->indices[0]].decrement();
+    }
+
+    // Age the useful counters, so that entries that are no longer
+    // useful can be replaced
+    if (++uResetTick == UResetPeriod) {
+        uResetTick = 0;
+        for (unsigned i = 1; i <= numTables; ++i) {
+            for (unsigned j = 0; j < tables[i].size(); ++j)
+                tables[i][j].u >>= 1;
+        }
+    }
+}
+
+void
+TAGEBP::allocate(bool taken, const BPHistory *history)
+{
+    // Randomly skip one or two of the next tables, so that branches
+    // competing for the same entries do not keep evicting each other
+    unsigned start = history->provider + 1;
+    unsigned skip = nextRandom();
+    if ((skip & 1) && start < numTables) {
+        ++start;
+        if ((skip & 2) && start < numTables)
+            ++start;
+    }
+
+    uint8_t min_u = UMax;
+    for (unsigned i = start; i <= numTables; ++i)
+        min_u = std::min(min_u, tables[i][history->indices[i]].u);
+
+    // No entry to replace, so make the candidates more likely to be
+    // replaced next time
+    if (min_u > 0) {
+        for (unsigned i = start; i <= numTables; ++i)
+            --tables[i][history->indices[i]].u;
+        return;
+    }
+
+    for (unsigned i = start; i <= numTables; ++i) {
+        TaggedEntry &entry = tables[i][history->indices[i]];
+        if (entry.u == 0) {
+            entry.tag = history->tags[i];
+            entry.ctr = taken ? 0 : -1;
+            return;
+        }
+    }
+}
+
+unsigned
+TAGEBP::loopIndex(Addr branch_addr) const
+{
+    return (branch_addr >> instShiftAmt) & (loopTable.size() - 1);
+}
+
+uint16_t
+TAGEBP::loopTag(Addr branch_addr) const
+{
+    return (branch_addr >> (instShiftAmt + logLoopSize)) & mask(LoopTagBits);
+}
+
+bool
+TAGEBP::loopLookup(Addr branch_addr, BPHistory *history, bool pred)
+{
+    const LoopEntry &entry = loopTable[loopIndex(branch_addr)];
+    history->loopHit = entry.valid && entry.tag == loopTag(branch_addr);
+    history->loopOldSpecIter = entry.specIter;
+    if (!history->loopHit)
+        return pred;
+
+    // The loop is predicted to exit once it has run its trip count
+    history->loopPred = entry.specIter + 1 == entry.numIter ?
+        !entry.dir : entry.dir;
+    history->loopValid = entry.confidence == LoopConfMax && entry.numIter;
+
+    return history->loopValid ? history->loopPred : pred;
+}
+
+void
+TAGEBP::loopSpecUpdate(const BPHistory *history, bool taken)
+{
+    LoopEntry &entry = loopTable[loopIndex(history->branchAddr)];
+    if (!history->loopHit || !entry.valid ||
+        entry.tag != loopTag(history->branchAddr))
+        return;
+
+    entry.specIter = taken == entry.dir ? entry.specIter + 1 : 0;
+}
+
+void
+TAGEBP::loopRestore(const BPHistory *history)
+{
+    LoopEntry &entry = loopTable[loopIndex(history->branchAddr)];
+    if (history->loopHit && entry.valid &&
+        entry.tag == loopTag(history->branchAddr))
+        entry.specIter = history->loopOldSpecIter;
+}
+
+void
+TAGEBP::loopUpdate(Addr branch_addr, bool taken, BPHistory *history)
+{
+    LoopEntry &entry = loopTable[loopIndex(branch_addr)];
+    uint16_t tag = loopTag(branch_addr);
+
+    if (entry.valid && entry.tag == tag) {
+        if (history->loopValid) {
+            if (history->loopPred != taken) {
+                entry.valid = false;
+                return;
+            }
+            if (history->loopPred != history->tagePred &&
+                entry.age < LoopAgeMax)
+                ++entry.age;
+        }
+
+        // Loops too long to track are left to TAGE
+        if (++entry.currentIter == 0xffff) {
+            entry.valid = false;
+            return;
+        }
+
+        if (taken != entry.dir) {
+            if (entry.currentIter == entry.numIter) {
+                if (entry.confidence < LoopConfMax)
+                    ++entry.confidence;
+                // So are loops with very few iterations
+                if (entry.numIter < 3) {
+                    entry.valid = false;
+                    return;
+                }
+            } else if (entry.numIter == 0) {
+                entry.numIter = entry.currentIter;
+                entry.confidence = 0;
+            } else {
+                entry.valid = false;
+                return;
+            }
+            entry.currentIter = 0;
+        }
+    } else if (history->tagePred != taken) {
+        // Assume that TAGE mispredicted the exit of a loop, and start
+        // counting its iterations
+        if (!entry.valid || entry.age == 0) {
+            entry.valid = true;
+            entry.dir = !taken;
+            entry.tag = tag;
+            entry.numIter = 0;
+            entry.currentIter = 0;
+            entry.specIter = 0;
+            entry.confidence = 0;
+            entry.age = LoopAgeMax;
+        } else {
+            --entry.age;
+        }
+    }
+}
+
+bool
+TAGEBP::scLookup(Addr branch_addr, BPHistory *history, bool pred)
+{
+    Addr pc = branch_addr >> instShiftAmt;
+
+    // The bias table is indexed by the TAGE prediction as well, the
+    // other tables by global histories of increasing length
+    history->scIndices.resize(NumSCTables);
+    history->scIndices[0] = ((pc << 1) | pred) & scMask;
+    for (unsigned i = 1; i < NumSCTables; ++i) {
+        history->scIndices[i] =
+            (pc ^ (pc >> i) ^ folded[scFold(i)].comp) & scMask;
+    }
+
+    int sum = 0;
+    for (unsigned i = 0; i < NumSCTables; ++i)
+        sum += 2 * scTables[i][history->scIndices[i]] + 1;
+    history->scSum = sum;
+    history->scPred = sum >= 0;
+
+    // Only predictions of low confidence are reverted
+    bool weak;
+    unsigned provider = history->provider;
+    if (provider) {
+        int ctr = tables[provider][history->indices[provider]].ctr;
+        weak = std::abs(2 * ctr + 1) <= 3;
+    } else {
+        uint8_t ctr = base[history->indices[0]].read();
+        weak = ctr == 1 || ctr == 2;
+    }
+
+    history->scUsed = weak && history->scPred != pred &&
+        std::abs(sum) >= scThreshold;
+
+    return history->scUsed ? history->scPred : pred;
+}
+
+void
+TAGEBP::scUpdate(bool taken, BPHistory *history)
+{
+    // Adapt the threshold to how often the corrector is right when it
+    // disagrees with TAGE
+    if (history->scPred != history->tagePred) {
+        scThresholdCtr += history->scPred == taken ? -1 : 1;
+        if (scThresholdCtr >= SCThresholdCtrMax) {
+            ++scThreshold;
+            scThresholdCtr = 0;
+        } else if (scThresholdCtr <= -SCThresholdCtrMax) {
+            if (scThreshold > 1)
+                --scThreshold;
+            scThresholdCtr = 0;
+        }
+    }
+
+    if (history->scPred != taken || std::abs(history->scSum) < scThreshold) {
+        for (unsigned i = 0; i < NumSCTables; ++i)
+            ctrUpdate(scTables[i][history->scIndices[i]], taken, SCCtrBits);
+    }
+}
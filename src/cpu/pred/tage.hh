@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a TAGE branch predictor with optional loop
+ * predictor and statistical corrector
+ */
+
+#ifndef __CPU_PRED_TAGE_PRED_HH__
+#define __CPU_PRED_TAGE_PRED_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/sat_counter.hh"
+
+/**
+ * Implements a TAGE (TAgged GEometric history length) branch
+ * predictor. A bimodal base predictor is backed by a number of
+ * partially tagged tables, indexed by hashes of the branch address
+ * and global histories of geometrically increasing length. The
+ * hitting table with the longest history provides the prediction,
+ * and entries are allocated in longer history tables on
+ * mispredictions.
+ *
+ * The global history is kept in a circular buffer with folded
+ * copies of it for each table index and tag. Every branch saves the
+ * buffer pointer and the folded histories, so that squashing a branch
+ * restores the history in constant time.
+ *
+ * A loop predictor can be enabled to catch loops with a constant
+ * trip count, and a statistical corrector to revert TAGE predictions
+ * of low confidence that are statistically biased the other way.
+ */
+class TAGEBP : public BPredUnit
+{
+  public:
+    TAGEBP(const Params *params);
+    void regStats();
+    void uncondBranch(void * &bp_history);
+    void squash(void *bp_history);
+    bool lookup(Addr branch_addr, void * &bp_history);
+    void btbUpdate(Addr branch_addr, void * &bp_history);
+    void update(Addr branch_addr, bool taken, void *bp_history, bool squashed);
+    void retireSquashed(void *bp_history);
+
+  private:
+    /**
+     * Size of the global history buffer. It has to hold the longest
+     * history and the history of all branches in flight.
+     */
+    static const unsigned HistBufferSize = 4096;
+
+    /** A global history folded down to the width of an index or tag. */
+    struct FoldedHistory
+    {
+        unsigned comp;
+        unsigned compLength;
+        unsigned origLength;
+        unsigned outpoint;
+
+        void init(unsigned orig_length, unsigned comp_length);
+
+        /** Shift in the newest bit at pt, dropping the oldest one. */
+        void update(const std::vector<uint8_t> &hist, unsigned pt);
+    };
+
+    struct TaggedEntry
+    {
+        int8_t ctr;
+        uint16_t tag;
+        uint8_t u;
+    };
+
+    struct LoopEntry
+    {
+        bool valid;
+        bool dir;
+        uint16_t tag;
+        uint16_t numIter;
+        uint16_t currentIter;
+        uint16_t specIter;
+        uint8_t confidence;
+        uint8_t age;
+    };
+
+    /** The speculative history as it was before a branch. */
+    struct HistoryState
+    {
+        unsigned ptr;
+        uint16_t pathHist;
+        std::vector<unsigned> folded;
+    };
+
+    struct BPHistory
+    {
+        HistoryState state;
+        Addr branchAddr;
+        bool conditional;
+
+        // table 0 is the base predictor
+        std::vector<unsigned> indices;
+        std::vector<uint16_t> tags;
+        unsigned provider;
+        unsigned altProvider;
+        bool providerPred;
+        bool altPred;
+        bool usedAlt;
+        bool tagePred;
+
+        bool loopHit;
+        bool loopValid;
+        bool loopPred;
+        uint16_t loopOldSpecIter;
+
+        std::vector<unsigned> scIndices;
+        int scSum;
+        bool scPred;
+        bool scUsed;
+
+        bool finalPred;
+    };
+
+    static void ctrUpdate(int8_t &ctr, bool taken, unsigned bits);
+
+    unsigned idxFold(unsigned bank) const { return 3 * (bank - 1); }
+    unsigned scFold(unsigned table) const
+    { return 3 * numTables + table - 1; }
+
+    unsigned gindex(Addr branch_addr, unsigned bank) const;
+    uint16_t gtag(Addr branch_addr, unsigned bank) const;
+
+    void saveState(HistoryState &state) const;
+    void restoreState(const HistoryState &state);
+    void pushHistory(bool taken);
+    void pushPath(Addr branch_addr);
+
+    bool loopLookup(Addr branch_addr, BPHistory *history, bool pred);
+    void loopSpecUpdate(const BPHistory *history, bool taken);
+    void loopRestore(const BPHistory *history);
+    void loopUpdate(Addr branch_addr, bool taken, BPHistory *history);
+    unsigned loopIndex(Addr branch_addr) const;
+    uint16_t loopTag(Addr branch_addr) const;
+
+    bool scLookup(Addr branch_addr, BPHistory *history, bool pred);
+    void scUpdate(bool taken, BPHistory *history);
+
+    void allocate(bool taken, const BPHistory *history);
+    void train(Addr branch_addr, bool taken, BPHistory *history);
+    unsigned nextRandom();
+
+    unsigned instShiftAmt;
+
+    unsigned numTables;
+    unsigned logTableSize;
+    unsigned tableMask;
+    unsigned baseMask;
+    unsigned tagBits;
+    std::vector<unsigned> histLengths;
+
+    std::vector<SatCounter> base;
+    std::vector<std::vector<TaggedEntry> > tables;
+
+    /** Whether to use the alternate prediction of new entries. */
+    int8_t useAltOnNA;
+    /** Branches trained since the useful bits were last aged. */
+    unsigned uResetTick;
+    unsigned randomSeed;
+
+    std::vector<uint8_t> ghist;
+    unsigned ptr;
+    uint16_t pathHist;
+    std::vector<FoldedHistory> folded;
+
+    bool useLoop;
+    unsigned logLoopSize;
+    std::vector<LoopEntry> loopTable;
+
+    bool useSC;
+    unsigned scMask;
+    std::vector<std::vector<int8_t> > scTables;
+    int scThreshold;
+    int scThresholdCtr;
+
+    /** Stat for the committed branches provided by each table. */
+    Stats::Vector providerHits;
+    /** Stat for the correct predictions of each table. */
+    Stats::Vector providerCorrect;
+    /** Stat for the predictions taken from the alternate table. */
+    Stats::Scalar altUsed;
+    /** Stat for the predictions made by the loop predictor. */
+    Stats::Scalar loopPredicted;
+    /** Stat for the correct predictions of the loop predictor. */
+    Stats::Scalar loopCorrect;
+    /** Stat for the TAGE predictions reverted by the corrector. */
+    Stats::Scalar scReverted;
+    /** Stat for the correct reversions of the corrector. */
+    Stats::Scalar scCorrect;
+};
+
+#endif // __CPU_PRED_TAGE_PRED_HH__
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/probes/inst_pipe_trace.hh"
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "cpu/static_inst.hh"
+#include "proto/inst_pipe.pb.h"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+InstPipeTrace::InstPipeTrace(const InstPipeTraceParams *params)
+    : ProbeListenerObject(params),
+      traceStream(NULL)
+{
+    std::string filename;
+    if (params->trace_file != "") {
+        filename = simout.resolve(params->trace_file);
+
+        // Append the compression suffix if it is missing
+        std::string suffix = ".gz";
+        if (params->trace_compress &&
+            (filename.size() < suffix.size() ||
+             filename.compare(filename.size() - suffix.size(),
+                              suffix.size(), suffix) != 0))
+            filename = filename + suffix;
+    } else {
+        filename = simout.resolve(name() + ".trc" +
+                                  (params->trace_compress ? ".gz" : ""));
+    }
+
+    traceStream = new ProtoOutputStream(filename);
+
+    ProtoMessage::InstPipeHeader header_msg;
+    header_msg.set_obj_id(name());
+    header_msg.set_tick_freq(SimClock::Frequency);
+    traceStream->write(header_msg);
+
+    // The destructor is not called on exit, so flush and close the
+    // trace from an exit callback
+    Callback *cb = new MakeCallback<InstPipeTrace,
+        &InstPipeTrace::closeStreams>(this);
+    registerExitCallback(cb);
+}
+
+InstPipeTrace::~InstPipeTrace()
+{
+    closeStreams();
+}
+
+void
+InstPipeTrace::closeStreams()
+{
+    delete traceStream;
+    traceStream = NULL;
+}
+
+void
+InstPipeTrace::regProbeListeners()
+{
+    typedef ProbeListenerArg<InstPipeTrace, InstPipeRecord>
+        InstPipeListener;
+    listeners.push_back(new InstPipeListener(this, "PipeRecord",
+                                             &InstPipeTrace::record));
+}
+
+void
+InstPipeTrace::record(const InstPipeRecord &rec)
+{
+    if (traceStream == NULL)
+        return;
+
+    ProtoMessage::InstPipe inst_msg;
+    inst_msg.set_seq_num(rec.seqNum);
+    inst_msg.set_pc(rec.pc);
+    if (rec.upc != 0)
+        inst_msg.set_upc(rec.upc);
+    if (rec.tid != 0)
+        inst_msg.set_tid(rec.tid);
+    inst_msg.set_fetch_tick(rec.fetch);
+
+    // Stages are stored as deltas from fetch, and only if reached
+    if (rec.decode)
+        inst_msg.set_decode(rec.decode - rec.fetch);
+    if (rec.rename)
+        inst_msg.set_rename(rec.rename - rec.fetch);
+    if (rec.dispatch)
+        inst_msg.set_dispatch(rec.dispatch - rec.fetch);
+    if (rec.issue)
+        inst_msg.set_issue(rec.issue - rec.fetch);
+    if (rec.complete)
+        inst_msg.set_complete(rec.complete - rec.fetch);
+    if (rec.commit)
+        inst_msg.set_commit(rec.commit - rec.fetch);
+    if (rec.store)
+        inst_msg.set_store(rec.store - rec.fetch);
+
+    if (rec.staticInst && seenInsts[rec.pc].insert(rec.upc).second)
+        inst_msg.set_disasm(rec.staticInst->disassemble(rec.pc));
+
+    traceStream->write(inst_msg);
+}
+
+InstPipeTrace *
+InstPipeTraceParams::create()
+{
+    return new InstPipeTrace(this);
+}
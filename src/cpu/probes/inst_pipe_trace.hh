@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PROBES_INST_PIPE_TRACE_HH__
+#define __CPU_PROBES_INST_PIPE_TRACE_HH__
+
+#include <set>
+
+#include "base/hashmap.hh"
+#include "cpu/inst_pipe_record.hh"
+#include "params/InstPipeTrace.hh"
+#include "proto/protoio.hh"
+#include "sim/probe/probe.hh"
+
+/**
+ * Probe listener that writes the PipeRecord notifications of a CPU to
+ * a protobuf trace, one message per instruction. The stage ticks are
+ * stored relative to the fetch tick and the disassembly is only
+ * stored the first time an instruction is seen, which keeps the trace
+ * an order of magnitude smaller than the O3PipeView debug output.
+ * util/decode_inst_pipe_trace.py turns the trace back into the
+ * O3PipeView format for util/o3-pipeview.py.
+ */
+class InstPipeTrace : public ProbeListenerObject
+{
+  public:
+    InstPipeTrace(const InstPipeTraceParams *params);
+    virtual ~InstPipeTrace();
+
+    virtual void regProbeListeners();
+
+    /** Write the pipeline record of an instruction to the trace. */
+    void record(const InstPipeRecord &rec);
+
+  private:
+    /** Flush and close the trace, called on exit. */
+    void closeStreams();
+
+    /** Output stream for the trace. */
+    ProtoOutputStream *traceStream;
+
+    /** Micro-PCs of the instructions already in the trace, by PC. */
+    m5::hash_map<Addr, std::set<MicroPC> > seenInsts;
+};
+
+#endif // __CPU_PROBES_INST_PIPE_TRACE_HH__
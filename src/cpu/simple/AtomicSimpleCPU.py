@@ -62,6 +62,14 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
     fastmem = Param.Bool(False, "Access memory directly")
+    fast_forward = Param.Bool(False, "Access memory through host pointers "
+                              "and run instructions in large quanta, for "
+                              "functional fast-forwarding (implies fastmem)")
+    fast_forward_quantum = Param.Unsigned(1000, "Instructions to run per "
+                                          "tick in fast-forward mode")
+    bb_cache_size = Param.Unsigned(0, "Number of decoded basic blocks to "
+                                   "cache, bypassing instruction fetch and "
+                                   "decode for them (0 disables the cache)")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
@@ -40,6 +40,9 @@
  * Authors: Steve Reinhardt
  */
 
+#include <algorithm>
+#include <limits>
+
 #include "arch/locked_mem.hh"
 #include "arch/mmapped_ipr.hh"
 #include "arch/utility.hh"
@@ -51,6 +54,7 @@
 #include "debug/Drain.hh"
 #include "debug/ExecFaulting.hh"
 #include "debug/SimpleCPU.hh"
+#include "mem/abstract_mem.hh"
 #include "mem/packet.hh"
 #include "mem/packet_access.hh"
 #include "mem/physical.hh"
@@ -103,6 +107,27 @@ AtomicSimpleCPU::init()
     data_write_req.setThreadContext(_cpuId, 0); // Add thread ID here too
 }
 
+void
+AtomicSimpleCPU::regStats()
+{
+    BaseSimpleCPU::regStats();
+
+    bbCacheHits
+        .name(name() + ".bbCacheHits")
+        .desc("Number of basic blocks run from the decoded block cache")
+        ;
+
+    bbCacheMisses
+        .name(name() + ".bbCacheMisses")
+        .desc("Number of decoded block cache lookups that missed")
+        ;
+
+    bbCacheInsts
+        .name(name() + ".bbCacheInsts")
+        .desc("Number of ops run from the decoded block cache")
+        ;
+}
+
 AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
     : BaseSimpleCPU(p), tickEvent(this), width(p->width), locked(false),
       simulate_data_stalls(p->simulate_data_stalls),
@@ -110,9 +135,18 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       drain_manager(NULL),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
-      fastmem(p->fastmem)
+      fastmem(p->fastmem || p->fast_forward),
+      fastForward(p->fast_forward), ffQuantum(p->fast_forward_quantum),
+      hostTLBUser(false),
+      bbCache(p->bb_cache_size ?
+              new BasicBlockCache(p->bb_cache_size) : NULL),
+      curBlock(NULL), curBlockIdx(0), recControl(false)
 {
     _status = Idle;
+
+    fatal_if(bbCache && simulate_inst_stalls,
+             "%s: the basic-block cache does not fetch instructions, so "
+             "icache stalls cannot be simulated with it\n", name());
 }
 
 
@@ -121,6 +155,8 @@ AtomicSimpleCPU::~AtomicSimpleCPU()
     if (tickEvent.scheduled()) {
         deschedule(tickEvent);
     }
+
+    delete bbCache;
 }
 
 unsigned int
@@ -154,6 +190,12 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // Memory and translations may have changed while drained, e.g. by
+    // restoring a checkpoint, so the decoded blocks and host TLBs
+    // cannot be trusted
+    flushBBCache();
+    flushHostTLBs();
+
     assert(!threadContexts.empty());
     if (threadContexts.size() > 1)
         fatal("The atomic CPU only supports one thread.\n");
@@ -193,6 +235,9 @@ AtomicSimpleCPU::switchOut()
 {
     BaseSimpleCPU::switchOut();
 
+    flushBBCache();
+    flushHostTLBs();
+
     assert(!tickEvent.scheduled());
     assert(_status == BaseSimpleCPU::Running || _status == Idle);
     assert(isDrained());
@@ -277,6 +322,11 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
         TheISA::handleLockedSnoop(cpu->thread, pkt, cacheBlockMask);
     }
 
+    // someone else is writing, drop any code decoded from the page
+    if (pkt->isWrite() || pkt->isInvalidate())
+        static_cast<AtomicSimpleCPU *>(cpu)->invalidateBBCache(
+            pkt->getAddr());
+
     return 0;
 }
 
@@ -292,6 +342,10 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
                 pkt->getAddr());
         TheISA::handleLockedSnoop(cpu->thread, pkt, cacheBlockMask);
     }
+
+    if (pkt->isWrite() || pkt->isInvalidate())
+        static_cast<AtomicSimpleCPU *>(cpu)->invalidateBBCache(
+            pkt->getAddr());
 }
 
 Fault
@@ -305,6 +359,14 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data,
         traceData->setAddr(addr);
     }
 
+    if (fastForward) {
+        const HostTLB::Entry *entry = readTLB.lookup(addr, size, flags);
+        if (entry) {
+            memcpy(data, entry->host + (addr - entry->vstart), size);
+            return NoFault;
+        }
+    }
+
     //The size of the data we're trying to read.
     int fullSize = size;
 
@@ -337,6 +399,9 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data,
                     system->getPhysMem().access(&pkt);
                 else
                     dcache_latency += dcachePort.sendAtomic(&pkt);
+
+                if (fastForward)
+                    fillHostTLB(readTLB, req, flags);
             }
             dcache_access = true;
 
@@ -401,6 +466,17 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size,
         traceData->setAddr(addr);
     }
 
+    if (fastForward && !res) {
+        const HostTLB::Entry *entry = writeTLB.lookup(addr, size, flags);
+        // locked addresses of the memory have to be cleared by access()
+        if (entry && !entry->mem->hasLockedAddrs()) {
+            Addr offset = addr - entry->vstart;
+            memcpy(entry->host + offset, data, size);
+            invalidateBBCache(entry->pstart + offset);
+            return NoFault;
+        }
+    }
+
     //The size of the data we're trying to read.
     int fullSize = size;
 
@@ -452,6 +528,11 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size,
                 dcache_access = true;
                 assert(!pkt.isError());
 
+                invalidateBBCache(req->getPaddr());
+
+                if (fastForward && !req->isMmappedIpr())
+                    fillHostTLB(writeTLB, req, flags);
+
                 if (req->isSwap()) {
                     assert(res);
                     memcpy(res, pkt.getPtr<uint8_t>(), fullSize);
@@ -499,11 +580,51 @@ AtomicSimpleCPU::tick()
 
     Tick latency = 0;
 
-    for (int i = 0; i < width || locked; ++i) {
+    // Neither a fast-forward quantum nor a block from the basic-block
+    // cache may run past the next instruction-count event, so that
+    // e.g. max_insts and switching CPUs after a number of
+    // instructions happen where they would without them
+    Counter insts_to_event = std::numeric_limits<Counter>::max();
+    if (!comInstEventQueue[0]->empty()) {
+        insts_to_event = std::min<Counter>(
+            insts_to_event, comInstEventQueue[0]->nextTick() - numInst);
+    }
+    if (!system->instEventQueue.empty()) {
+        insts_to_event = std::min<Counter>(
+            insts_to_event,
+            system->instEventQueue.nextTick() - system->totalNumInsts);
+    }
+    const Counter start_insts = numInst;
+
+    Counter tick_width = width;
+    if (fastForward) {
+        tick_width = std::max<Counter>(
+            std::min<Counter>(ffQuantum, insts_to_event), 1);
+    }
+
+    // A block entered from the basic-block cache is run to its end
+    // within the tick, unless an instruction-count event is due
+    Counter i;
+    for (i = 0; i < tick_width || locked ||
+             (curBlock && curBlockIdx < curBlock->insts.size() &&
+              numInst - start_insts < insts_to_event); ++i) {
         numCycles++;
 
-        if (!curStaticInst || !curStaticInst->isDelayedCommit())
-            checkForInterrupts();
+        if (!curStaticInst || !curStaticInst->isDelayedCommit()) {
+            // Taking an interrupt may change how code is decoded and
+            // translated
+            if (checkForInterrupts()) {
+                flushBBCache();
+                flushHostTLBs();
+            }
+        }
+
+        // Catch mode changes the host TLBs were not flushed for
+        if (fastForward && FullSystem &&
+            TheISA::inUserMode(tc) != hostTLBUser) {
+            flushHostTLBs();
+            hostTLBUser = !hostTLBUser;
+        }
 
         checkPcEventQueue();
         // We must have just got suspended by a PC event
@@ -516,13 +637,41 @@ AtomicSimpleCPU::tick()
 
         TheISA::PCState pcState = thread->pcState();
 
+        const BasicBlockCache::Inst *cached_inst =
+            bbCache ? fetchCachedInst(pcState) : NULL;
+        const bool cached = cached_inst != NULL;
+
         bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
-                           !curMacroStaticInst;
+                           !curMacroStaticInst && !cached;
+        uint8_t *fetch_host = NULL;
         if (needToFetch) {
             ifetch_req.taskId(taskId());
             setupFetchRequest(&ifetch_req);
-            fault = thread->itb->translateAtomic(&ifetch_req, tc,
-                                                 BaseTLB::Execute);
+
+            const HostTLB::Entry *entry = fastForward ?
+                fetchTLB.lookup(ifetch_req.getVaddr(), sizeof(inst),
+                                Request::INST_FETCH) : NULL;
+            if (entry) {
+                Addr offset = ifetch_req.getVaddr() - entry->vstart;
+                ifetch_req.setPaddr(entry->pstart + offset);
+                fetch_host = entry->host + offset;
+            } else {
+                fault = thread->itb->translateAtomic(&ifetch_req, tc,
+                                                     BaseTLB::Execute);
+                if (fastForward && fault == NoFault)
+                    fillHostTLB(fetchTLB, &ifetch_req, Request::INST_FETCH);
+            }
+
+            // Blocks do not cross pages, so that a write to a page
+            // only has to drop the blocks fetched from it
+            if (recBlock && fault == NoFault) {
+                Addr page = BasicBlockCache::pageOf(ifetch_req.getPaddr());
+                if (recBlock->insts.empty() && fetchOffset == 0) {
+                    recBlock->physPage = page;
+                } else if (page != recBlock->physPage) {
+                    finishBlock();
+                }
+            }
         }
 
         if (fault == NoFault) {
@@ -538,6 +687,9 @@ AtomicSimpleCPU::tick()
                 //Fetch more instruction memory if necessary
                 //if(decoder.needMoreBytes())
                 //{
+                if (fetch_host) {
+                    memcpy(&inst, fetch_host, sizeof(inst));
+                } else {
                     icache_access = true;
                     Packet ifetch_pkt = Packet(&ifetch_req, MemCmd::ReadReq);
                     ifetch_pkt.dataStatic(&inst);
@@ -551,10 +703,19 @@ AtomicSimpleCPU::tick()
 
                     // ifetch_req is initialized to read the instruction directly
                     // into the CPU object's inst field.
+                }
                 //}
             }
 
-            preExecute();
+            if (cached) {
+                thread->pcState(cached_inst->pc);
+                preExecute(cached_inst->staticInst, cached_inst->macroInst);
+                ++bbCacheInsts;
+            } else {
+                preExecute();
+            }
+
+            const TheISA::PCState decodedPC = thread->pcState();
 
             if (curStaticInst) {
                 fault = curStaticInst->execute(this, traceData);
@@ -573,6 +734,13 @@ AtomicSimpleCPU::tick()
                 }
 
                 postExecute();
+
+                if (fault == NoFault && changesContext(curStaticInst)) {
+                    flushBBCache();
+                    flushHostTLBs();
+                } else if (bbCache && fault == NoFault) {
+                    updateBBCache(pcState, decodedPC, cached);
+                }
             }
 
             // @todo remove me after debugging with legion done
@@ -596,6 +764,12 @@ AtomicSimpleCPU::tick()
             }
 
         }
+        // Faults may change how code is decoded and translated
+        if (fault != NoFault) {
+            flushBBCache();
+            flushHostTLBs();
+        }
+
         if(fault != NoFault || !stayAtPC)
             advancePC(fault);
     }
@@ -603,14 +777,205 @@ AtomicSimpleCPU::tick()
     if (tryCompleteDrain())
         return;
 
-    // instruction takes at least one cycle
-    if (latency < clockPeriod())
+    // instruction takes at least one cycle, and in fast-forward mode
+    // each instruction of the quantum takes one
+    if (fastForward)
+        latency = std::max(latency, clockPeriod() * i);
+    else if (latency < clockPeriod())
         latency = clockPeriod();
 
     if (_status != Idle)
         schedule(tickEvent, curTick() + latency);
 }
 
+const BasicBlockCache::Inst *
+AtomicSimpleCPU::fetchCachedInst(const TheISA::PCState &pc)
+{
+    BasicBlockCache::Block *prev = NULL;
+
+    if (curBlock) {
+        if (curBlockIdx < curBlock->insts.size()) {
+            const BasicBlockCache::Inst &inst = curBlock->insts[curBlockIdx];
+            if (inst.fetchPC == pc) {
+                ++curBlockIdx;
+                return &inst;
+            }
+        } else {
+            // The block ran to its end, so try to chain to the next
+            prev = curBlock;
+        }
+
+        leaveBlock();
+    }
+
+    // Blocks start at instruction boundaries, and are only looked up
+    // once the block being recorded, if any, is finished
+    if (recBlock || isRomMicroPC(pc.microPC()) || curMacroStaticInst ||
+        fetchOffset != 0) {
+        return NULL;
+    }
+
+    BasicBlockCache::Block *block = bbCache->lookup(pc, prev);
+
+    if (block) {
+        // Translate the fetch of the block so that faults and changed
+        // mappings are seen as they would be without the cache
+        ifetch_req.taskId(taskId());
+        setupFetchRequest(&ifetch_req);
+        Fault fault = thread->itb->translateAtomic(&ifetch_req, tc,
+                                                   BaseTLB::Execute);
+
+        if (fault == NoFault &&
+            BasicBlockCache::pageOf(ifetch_req.getPaddr()) ==
+            block->physPage) {
+            DPRINTF(SimpleCPU, "Running decoded block at %s\n", pc);
+            ++bbCacheHits;
+            curBlock = block;
+            curBlockIdx = 1;
+            return &block->insts.front();
+        }
+    }
+
+    // Record the block, replacing the stale one if there is one
+    ++bbCacheMisses;
+    recBlock.reset(new BasicBlockCache::Block);
+    recControl = false;
+
+    return NULL;
+}
+
+void
+AtomicSimpleCPU::updateBBCache(const TheISA::PCState &fetch_pc,
+                               const TheISA::PCState &decoded_pc,
+                               bool cached)
+{
+    if (cached || !recBlock)
+        return;
+
+    BasicBlockCache::Inst inst;
+    inst.fetchPC = fetch_pc;
+    inst.pc = decoded_pc;
+    inst.staticInst = curStaticInst;
+    inst.macroInst = curMacroStaticInst;
+    recBlock->insts.push_back(inst);
+
+    if (curStaticInst->isControl())
+        recControl = true;
+
+    if (!curStaticInst->isMicroop() || curStaticInst->isLastMicroop()) {
+        // Blocks end after the macroop of a control instruction
+        if (recControl ||
+            recBlock->insts.size() >= BasicBlockCache::MaxBlockInsts) {
+            finishBlock();
+        }
+    } else if (recBlock->insts.size() > BasicBlockCache::MaxBlockInsts) {
+        // Microcode loops, e.g. for string instructions, are not cached
+        recBlock.reset();
+    }
+}
+
+bool
+AtomicSimpleCPU::changesContext(const StaticInstPtr &inst)
+{
+    // These may change how code is decoded and translated, or, for
+    // system calls, remap or write memory without going through the
+    // CPU
+    return inst->isSerializing() || inst->isSerializeAfter() ||
+        inst->isSquashAfter() || inst->isNonSpeculative() ||
+        inst->isSyscall();
+}
+
+void
+AtomicSimpleCPU::fillHostTLB(HostTLB &tlb, Request *req,
+                             Request::FlagsType flags)
+{
+    const Request::FlagsType special = Request::UNCACHEABLE |
+        Request::MMAPPED_IPR | Request::CLEAR_LL | Request::NO_ACCESS |
+        Request::LOCKED | Request::LLSC | Request::MEM_SWAP |
+        Request::MEM_SWAP_COND | Request::PREFETCH | Request::GENERIC_IPR;
+
+    if (req->getFlags().isSet(special))
+        return;
+
+    // The whole page has to be contiguous host memory of one memory
+    Addr page = roundDown(req->getPaddr(), TheISA::PageBytes);
+    AbstractMemory *mem = NULL;
+    AbstractMemory *last_mem = NULL;
+    PhysicalMemory &physmem = system->getPhysMem();
+    uint8_t *host = physmem.toHostAddr(page, mem);
+    uint8_t *last_host =
+        physmem.toHostAddr(page + TheISA::PageBytes - 1, last_mem);
+
+    if (host && last_host == host + TheISA::PageBytes - 1 &&
+        mem == last_mem) {
+        tlb.insert(req->getVaddr(), req->getPaddr(), flags, host, mem);
+    }
+}
+
+void
+AtomicSimpleCPU::flushHostTLBs()
+{
+    if (!fastForward)
+        return;
+
+    fetchTLB.flush();
+    readTLB.flush();
+    writeTLB.flush();
+}
+
+void
+AtomicSimpleCPU::finishBlock()
+{
+    if (!recBlock->insts.empty()) {
+        DPRINTF(SimpleCPU, "Caching decoded block at %s of %d ops\n",
+                recBlock->insts.front().fetchPC, recBlock->insts.size());
+        bbCache->insert(std::move(recBlock));
+    }
+
+    recBlock.reset();
+}
+
+void
+AtomicSimpleCPU::leaveBlock()
+{
+    curBlock = NULL;
+    curBlockIdx = 0;
+
+    // The decoder was bypassed, so it has no valid state to go on from
+    thread->decoder.reset();
+}
+
+void
+AtomicSimpleCPU::invalidateBBCache(Addr paddr)
+{
+    if (!bbCache)
+        return;
+
+    Addr page = BasicBlockCache::pageOf(paddr);
+
+    if (curBlock && curBlock->physPage == page)
+        leaveBlock();
+
+    if (recBlock && recBlock->physPage == page)
+        recBlock.reset();
+
+    if (bbCache->invalidate(paddr))
+        DPRINTF(SimpleCPU, "Dropped decoded blocks of page %#x\n", page);
+}
+
+void
+AtomicSimpleCPU::flushBBCache()
+{
+    if (!bbCache)
+        return;
+
+    if (curBlock)
+        leaveBlock();
+
+    recBlock.reset();
+    bbCache->flush();
+}
+
 void
 AtomicSimpleCPU::regProbePoints()
 {
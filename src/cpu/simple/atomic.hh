@@ -44,6 +44,8 @@
 #define __CPU_SIMPLE_ATOMIC_HH__
 
 #include "cpu/simple/base.hh"
+#include "cpu/simple/bb_cache.hh"
+#include "cpu/simple/host_tlb.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
 
@@ -56,6 +58,8 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
     virtual void init();
 
+    virtual void regStats();
+
   private:
 
     struct TickEvent : public Event
@@ -172,6 +176,47 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     AtomicCPUDPort dcachePort;
 
     bool fastmem;
+
+    /**
+     * In fast-forward mode, ordinary memory is read and written
+     * through host pointers cached in software TLBs, and the CPU runs
+     * a quantum of instructions per tick, accounting one cycle for
+     * each. Anything else (devices, uncacheable, locked or unaligned
+     * accesses) takes the normal atomic path.
+     */
+    const bool fastForward;
+
+    /** Number of instructions to run per tick in fast-forward mode. */
+    const unsigned ffQuantum;
+
+    /** Software TLBs to host memory for fetches, reads and writes. */
+    HostTLB fetchTLB;
+    HostTLB readTLB;
+    HostTLB writeTLB;
+
+    /** Was the CPU in user mode when the host TLBs were filled. */
+    bool hostTLBUser;
+
+    /**
+     * Add the page of a translated access to a host TLB, if it is an
+     * ordinary access to host-backed memory.
+     *
+     * @param tlb The TLB to fill
+     * @param req The translated request
+     * @param flags Request flags the access was made with
+     */
+    void fillHostTLB(HostTLB &tlb, Request *req,
+                     Request::FlagsType flags);
+
+    /** Drop all host TLB entries, as translations may have changed. */
+    void flushHostTLBs();
+
+    /**
+     * Does an instruction possibly change the translation or decoding
+     * context, or memory behind the CPU's back.
+     */
+    static bool changesContext(const StaticInstPtr &inst);
+
     Request ifetch_req;
     Request data_read_req;
     Request data_write_req;
@@ -179,6 +224,65 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool dcache_access;
     Tick dcache_latency;
 
+    /**
+     * Cache of decoded basic blocks, NULL if disabled. Instructions
+     * run from the cache are not fetched through the instruction
+     * port, so it is meant for fast-forwarding.
+     */
+    BasicBlockCache *bbCache;
+
+    /** Block being run from the cache, or NULL. */
+    BasicBlockCache::Block *curBlock;
+
+    /** Index of the next instruction to run in the current block. */
+    unsigned curBlockIdx;
+
+    /** Block being recorded while running uncached, or NULL. */
+    std::unique_ptr<BasicBlockCache::Block> recBlock;
+
+    /** Has the block being recorded reached a control instruction. */
+    bool recControl;
+
+    /**
+     * Find the next instruction to run from the basic-block cache,
+     * following or entering a block as needed.
+     *
+     * @param pc PC state of the instruction, before decoding
+     * @return The decoded instruction, or NULL to fetch and decode
+     */
+    const BasicBlockCache::Inst *fetchCachedInst(
+        const TheISA::PCState &pc);
+
+    /**
+     * Update the basic-block cache once an instruction has executed,
+     * recording it if it was not run from the cache.
+     *
+     * @param fetch_pc PC state of the instruction, before decoding
+     * @param decoded_pc PC state of the instruction once decoded
+     * @param cached Was the instruction run from the cache
+     */
+    void updateBBCache(const TheISA::PCState &fetch_pc,
+                       const TheISA::PCState &decoded_pc, bool cached);
+
+    /** Add the block being recorded to the cache, if not empty. */
+    void finishBlock();
+
+    /** Stop running from the cache, and return to fetch and decode. */
+    void leaveBlock();
+
+    /** Drop the decoded blocks fetched from a written physical page. */
+    void invalidateBBCache(Addr paddr);
+
+    /** Drop all decoded blocks. */
+    void flushBBCache();
+
+    /** Number of blocks entered from the basic-block cache. */
+    Stats::Scalar bbCacheHits;
+    /** Number of basic-block cache lookups that found no block. */
+    Stats::Scalar bbCacheMisses;
+    /** Number of instructions (and microops) run from the cache. */
+    Stats::Scalar bbCacheInsts;
+
     /** Probe Points. */
     ProbePointArg<std::pair<SimpleThread*, const StaticInstPtr>> *ppCommit;
 
@@ -208,6 +312,24 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     Fault writeMem(uint8_t *data, unsigned size,
                    Addr addr, unsigned flags, uint64_t *res);
 
+    void demapPage(Addr vaddr, uint64_t asn)
+    {
+        flushHostTLBs();
+        BaseSimpleCPU::demapPage(vaddr, asn);
+    }
+
+    void demapInstPage(Addr vaddr, uint64_t asn)
+    {
+        flushHostTLBs();
+        BaseSimpleCPU::demapInstPage(vaddr, asn);
+    }
+
+    void demapDataPage(Addr vaddr, uint64_t asn)
+    {
+        flushHostTLBs();
+        BaseSimpleCPU::demapDataPage(vaddr, asn);
+    }
+
     virtual void regProbePoints();
 
     /**
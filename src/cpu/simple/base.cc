@@ -354,7 +354,7 @@ BaseSimpleCPU::wakeup()
     thread->activate();
 }
 
-void
+bool
 BaseSimpleCPU::checkForInterrupts()
 {
     if (checkInterrupts(tc)) {
@@ -365,8 +365,11 @@ BaseSimpleCPU::checkForInterrupts()
             interrupts->updateIntrInfo(tc);
             interrupt->invoke(tc);
             thread->decoder.reset();
+            return true;
         }
     }
+
+    return false;
 }
 
 
@@ -385,7 +388,7 @@ BaseSimpleCPU::setupFetchRequest(Request *req)
 
 
 void
-BaseSimpleCPU::preExecute()
+BaseSimpleCPU::preDecode()
 {
     // maintain $r0 semantics
     thread->setIntReg(ZeroReg, 0);
@@ -396,6 +399,12 @@ BaseSimpleCPU::preExecute()
     // check for instruction-count-based events
     comInstEventQueue[0]->serviceEvents(numInst);
     system->instEventQueue.serviceEvents(system->totalNumInsts);
+}
+
+void
+BaseSimpleCPU::preExecute()
+{
+    preDecode();
 
     // decode the instruction
     inst = gtoh(inst);
@@ -444,6 +453,25 @@ BaseSimpleCPU::preExecute()
         curStaticInst = curMacroStaticInst->fetchMicroop(pcState.microPC());
     }
 
+    postDecode();
+}
+
+void
+BaseSimpleCPU::preExecute(const StaticInstPtr &static_inst,
+                          const StaticInstPtr &macro_inst)
+{
+    preDecode();
+
+    stayAtPC = false;
+    curStaticInst = static_inst;
+    curMacroStaticInst = macro_inst;
+
+    postDecode();
+}
+
+void
+BaseSimpleCPU::postDecode()
+{
     //If we decoded an instruction this "tick", record information about it.
     if (curStaticInst) {
 #if TRACING_ON
@@ -164,12 +164,30 @@ class BaseSimpleCPU : public BaseCPU, public ExecContext
     //instructions which go beyond MachInst boundaries.
     bool stayAtPC;
 
-    void checkForInterrupts();
+    /** Take any pending interrupt, returning whether one was taken. */
+    bool checkForInterrupts();
     void setupFetchRequest(Request *req);
     void preExecute();
+    /**
+     * Prepare to execute an instruction that is already decoded,
+     * bypassing fetch and decode.
+     *
+     * @param static_inst The instruction, or microop, to execute
+     * @param macro_inst The macroop of the microop, if any
+     */
+    void preExecute(const StaticInstPtr &static_inst,
+                    const StaticInstPtr &macro_inst);
     void postExecute();
     void advancePC(const Fault &fault);
 
+  private:
+    /** Per instruction work done before decoding. */
+    void preDecode();
+    /** Per instruction work done once the instruction is decoded. */
+    void postDecode();
+
+  public:
+
     virtual void haltContext(ThreadID thread_num);
 
     // statistics
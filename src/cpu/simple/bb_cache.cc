@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/bb_cache.hh"
+
+#include <algorithm>
+
+BasicBlockCache::BasicBlockCache(unsigned max_blocks)
+    : maxBlocks(max_blocks), generation(1)
+{
+}
+
+BasicBlockCache::Block *
+BasicBlockCache::lookup(const TheISA::PCState &pc, Block *prev)
+{
+    if (prev) {
+        for (auto &link : prev->successors) {
+            if (link.generation == generation &&
+                link.block->insts.front().fetchPC == pc)
+                return link.block;
+        }
+    }
+
+    auto it = blocks.find(pc.instAddr());
+    if (it == blocks.end() || !(it->second->insts.front().fetchPC == pc))
+        return NULL;
+
+    Block *block = it->second.get();
+
+    if (prev) {
+        Link &link = prev->successors[prev->nextLink];
+        link.block = block;
+        link.generation = generation;
+        prev->nextLink = (prev->nextLink + 1) % 2;
+    }
+
+    return block;
+}
+
+void
+BasicBlockCache::insert(std::unique_ptr<Block> block)
+{
+    assert(!block->insts.empty());
+
+    if (blocks.size() >= maxBlocks)
+        flush();
+
+    Addr start = block->insts.front().fetchPC.instAddr();
+    auto it = blocks.find(start);
+
+    if (it != blocks.end()) {
+        // Links to the block being replaced must not be followed
+        ++generation;
+
+        std::vector<Addr> &starts = pages[it->second->physPage];
+        starts.erase(std::find(starts.begin(), starts.end(), start));
+        if (starts.empty())
+            pages.erase(it->second->physPage);
+    }
+
+    pages[block->physPage].push_back(start);
+    blocks[start] = std::move(block);
+}
+
+bool
+BasicBlockCache::invalidate(Addr paddr)
+{
+    auto it = pages.find(pageOf(paddr));
+    if (it == pages.end())
+        return false;
+
+    for (auto start : it->second)
+        blocks.erase(start);
+    pages.erase(it);
+    ++generation;
+
+    return true;
+}
+
+void
+BasicBlockCache::flush()
+{
+    blocks.clear();
+    pages.clear();
+    ++generation;
+}
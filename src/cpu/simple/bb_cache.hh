@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * A cache of decoded basic blocks for the simple CPUs.
+ */
+
+#ifndef __CPU_SIMPLE_BB_CACHE_HH__
+#define __CPU_SIMPLE_BB_CACHE_HH__
+
+#include <memory>
+#include <vector>
+
+#include "arch/isa_traits.hh"
+#include "arch/types.hh"
+#include "base/hashmap.hh"
+#include "base/types.hh"
+#include "cpu/static_inst.hh"
+
+/**
+ * Caches the decoded instructions, including expanded microops, of
+ * the basic blocks a CPU executes, so that a hot block can be run
+ * again without fetching and decoding each of its instructions.
+ *
+ * Blocks are keyed by the virtual address of their first instruction
+ * and remember the physical page they were fetched from, so that they
+ * can be dropped when that page is written. Each instruction records
+ * the complete PC state it was decoded at, which covers any ISA mode
+ * kept in the PC state (e.g. Thumb or AArch64); the user must flush
+ * the cache on any other change that affects decoding.
+ *
+ * Blocks are chained to their most recent successors, so following a
+ * block with one of its usual successors does not need a lookup. A
+ * generation number, bumped on every invalidation, tells which of
+ * these links are still valid.
+ */
+class BasicBlockCache
+{
+  public:
+
+    /** A decoded instruction, or microop, of a block. */
+    struct Inst
+    {
+        /** PC state the instruction is fetched at, before decoding. */
+        TheISA::PCState fetchPC;
+
+        /** PC state once the instruction is decoded. */
+        TheISA::PCState pc;
+
+        /** The instruction, or microop, to execute. */
+        StaticInstPtr staticInst;
+
+        /** The macroop the microop belongs to, if any. */
+        StaticInstPtr macroInst;
+    };
+
+    struct Block;
+
+    /** A pointer to a successor block. */
+    struct Link
+    {
+        Link() : block(NULL), generation(0) { }
+
+        Block *block;
+        uint64_t generation;
+    };
+
+    /** A decoded basic block. */
+    struct Block
+    {
+        Block() : physPage(0), nextLink(0) { }
+
+        /** Physical page the block was fetched from. */
+        Addr physPage;
+
+        /** The instructions of the block, in program order. */
+        std::vector<Inst> insts;
+
+        /** Most recent successors of the block. */
+        Link successors[2];
+
+        /** Successor link to replace next. */
+        unsigned nextLink;
+    };
+
+    /** Maximum number of instructions in a block. */
+    static const unsigned MaxBlockInsts = 256;
+
+    /**
+     * @param max_blocks Number of blocks to hold before flushing the
+     *                   whole cache
+     */
+    BasicBlockCache(unsigned max_blocks);
+
+    /**
+     * Find the block starting at the given PC state.
+     *
+     * @param pc PC state to start at, before decoding
+     * @param prev Block executed just before, to link to, or NULL
+     * @return The block, or NULL if there is none
+     */
+    Block *lookup(const TheISA::PCState &pc, Block *prev);
+
+    /**
+     * Add a block, replacing any previous block at the same address.
+     *
+     * @param block The block, which must not be empty
+     */
+    void insert(std::unique_ptr<Block> block);
+
+    /**
+     * Drop the blocks fetched from the page of a physical address.
+     *
+     * @param paddr Physical address that is written
+     * @return Whether any block was dropped
+     */
+    bool invalidate(Addr paddr);
+
+    /** Drop all blocks. */
+    void flush();
+
+    /** Number of blocks in the cache. */
+    size_t size() const { return blocks.size(); }
+
+    /** Physical page of an address. */
+    static Addr pageOf(Addr paddr)
+    { return paddr & ~(TheISA::PageBytes - 1); }
+
+  private:
+
+    const unsigned maxBlocks;
+
+    /** Generation of the links, bumped when blocks are dropped. */
+    uint64_t generation;
+
+    /** The blocks, by virtual address of their first instruction. */
+    m5::hash_map<Addr, std::unique_ptr<Block> > blocks;
+
+    /** Start addresses of the blocks fetched from each physical page. */
+    m5::hash_map<Addr, std::vector<Addr> > pages;
+};
+
+#endif // __CPU_SIMPLE_BB_CACHE_HH__
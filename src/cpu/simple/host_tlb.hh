@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * A software TLB from virtual addresses to host memory.
+ */
+
+#ifndef __CPU_SIMPLE_HOST_TLB_HH__
+#define __CPU_SIMPLE_HOST_TLB_HH__
+
+#include <cstring>
+
+#include "arch/isa_traits.hh"
+#include "base/types.hh"
+#include "mem/request.hh"
+
+class AbstractMemory;
+
+/**
+ * A small direct-mapped TLB caching, per page, where the virtual
+ * addresses an access translates to live in the host memory backing
+ * the simulated memory. It lets a CPU read and write ordinary memory
+ * with a copy instead of building requests and packets.
+ *
+ * Entries are filled from accesses that the CPU's TLB translated, and
+ * are tagged with the request flags of the access, as the flags can
+ * affect translation (e.g. the x86 segment). An entry covers the
+ * virtual addresses that map to the same physical page as the access
+ * did, which need not be page aligned when a segment base is added.
+ * Only naturally aligned accesses use the entries, so that alignment
+ * checks done by the TLB do not have to be repeated.
+ */
+class HostTLB
+{
+  public:
+
+    struct Entry
+    {
+        /** First virtual address covered. */
+        Addr vstart;
+
+        /** One past the last virtual address covered. */
+        Addr vend;
+
+        /** Physical address of vstart. */
+        Addr pstart;
+
+        /** Host address of vstart. */
+        uint8_t *host;
+
+        /** The memory the page belongs to. */
+        AbstractMemory *mem;
+
+        /** Request flags of the access that filled the entry. */
+        Request::FlagsType flags;
+    };
+
+    /** Number of entries. */
+    static const unsigned Size = 64;
+
+    HostTLB() { flush(); }
+
+    /**
+     * Look up an access.
+     *
+     * @param vaddr Virtual address of the access
+     * @param size Size of the access in bytes
+     * @param flags Request flags of the access
+     * @return The entry covering the access, or NULL
+     */
+    const Entry *
+    lookup(Addr vaddr, unsigned size, Request::FlagsType flags) const
+    {
+        if ((size & (size - 1)) || (vaddr & (size - 1)))
+            return NULL;
+
+        const Entry &entry = entries[index(vaddr)];
+        if (entry.host && entry.flags == flags && vaddr >= entry.vstart &&
+            vaddr + size <= entry.vend) {
+            return &entry;
+        }
+
+        return NULL;
+    }
+
+    /**
+     * Add the page of a translated access.
+     *
+     * @param vaddr Virtual address of the access
+     * @param paddr Physical address it translated to
+     * @param flags Request flags of the access
+     * @param host Host address of the physical page
+     * @param mem The memory the page belongs to
+     */
+    void
+    insert(Addr vaddr, Addr paddr, Request::FlagsType flags,
+           uint8_t *host, AbstractMemory *mem)
+    {
+        Entry &entry = entries[index(vaddr)];
+        Addr offset = paddr & (TheISA::PageBytes - 1);
+
+        entry.vstart = vaddr - offset;
+        entry.vend = entry.vstart + TheISA::PageBytes;
+        entry.pstart = paddr - offset;
+        entry.host = host;
+        entry.mem = mem;
+        entry.flags = flags;
+    }
+
+    /** Drop all entries. */
+    void flush() { std::memset(entries, 0, sizeof(entries)); }
+
+  private:
+
+    static unsigned index(Addr vaddr)
+    { return (vaddr >> TheISA::PageShift) % Size; }
+
+    Entry entries[Size];
+};
+
+#endif // __CPU_SIMPLE_HOST_TLB_HH__
@@ -44,7 +44,7 @@ from AbstractMemory import *
 
 # Enum for memory scheduling algorithms, currently First-Come
 # First-Served and a First-Row Hit then First-Come First-Served
-class MemSched(Enum): vals = ['fcfs', 'frfcfs']
+class MemSched(Enum): vals = ['fcfs', 'frfcfs', 'bliss', 'atlas']
 
 # Enum for the address mapping. With Ch, Ra, Ba, Ro and Co denoting
 # channel, rank, bank, row and column, respectively, and going from
@@ -92,6 +92,19 @@ class DRAMCtrl(AbstractMemory):
     addr_mapping = Param.AddrMap('RoRaBaChCo', "Address mapping policy")
     page_policy = Param.PageManage('open_adaptive', "Page management policy")
 
+    # parameters of the master-aware scheduling policies
+    bliss_threshold = Param.Unsigned(4, "Consecutive bursts served for a "
+                                     "master before it is blacklisted")
+    sched_quantum = Param.Latency('10us', "Quantum after which the BLISS "
+                                  "blacklist and ATLAS service are updated")
+    atlas_history_weight = Param.Float(0.875, "Weight of past quanta in "
+                                       "the ATLAS attained service")
+
+    # number of commands logged before they are passed to DRAMPower,
+    # the energy itself is only calculated when the stats are dumped
+    power_batch_size = Param.Unsigned(4096, "Minimum number of commands "
+                                      "passed to DRAMPower at once")
+
     # enforce a limit on the number of accesses per row
     max_accesses_per_row = Param.Unsigned(16, "Max accesses per row before "
                                           "closing");
@@ -82,4 +82,14 @@ class SnoopFilter(SimObject):
     cxx_header = "mem/snoop_filter.hh"
     lookup_latency = Param.Cycles(3, "lookup latency (cycles)")
 
+    # With entries set to 0 the filter keeps track of every line it
+    # has seen; otherwise it is a set-associative structure that only
+    # tracks requested or held lines and back-invalidates the holders
+    # of the lines it replaces.
+    entries = Param.Unsigned(0, "Number of tracked lines (0 for unbounded)")
+    assoc = Param.Unsigned(8, "Associativity of the bounded filter")
+    bloom_entries = Param.Unsigned(0, "Counters in the Bloom filter front " \
+                                       "end (0 to disable)")
+    bloom_hashes = Param.Unsigned(3, "Hash functions of the Bloom filter")
+
     system = Param.System(Parent.any, "System that the crossbar belongs to.")
@@ -221,6 +221,21 @@ class AbstractMemory : public MemObject
      */
     void addLockedAddr(LockedAddr addr) { lockedAddrList.push_back(addr); }
 
+    /**
+     * Check if any address is locked, in which case writes have to go
+     * through access() to clear the locks.
+     */
+    bool hasLockedAddrs() const { return !lockedAddrList.empty(); }
+
+    /**
+     * Get the host address backing a physical address of this memory.
+     *
+     * @param addr A physical address within the range of the memory
+     * @return Host pointer, or NULL if the memory is null
+     */
+    uint8_t *toHostAddr(Addr addr) const
+    { return pmemAddr ? pmemAddr + addr - range.start() : NULL; }
+
     /** read the system pointer
      * Implemented for completeness with the setter
      * @return pointer to the system object */
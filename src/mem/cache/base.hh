@@ -570,6 +570,14 @@ class BaseCache : public MemObject
 
     virtual bool inMissQueue(Addr addr, bool is_secure) const = 0;
 
+    /**
+     * Fraction of the MSHRs currently allocated.
+     */
+    double mshrOccupancy() const
+    {
+        return (double)mshrQueue.allocated / mshrQueue.capacity();
+    }
+
     void incMissCount(PacketPtr pkt)
     {
         assert(pkt->req->masterId() < system->maxMasters());
@@ -560,8 +560,11 @@ Cache<TagStore>::recvTimingReq(PacketPtr pkt)
         // hit (for all other request types)
 
         if (prefetcher && (prefetchOnAccess || (blk && blk->wasPrefetched()))) {
-            if (blk)
+            if (blk && blk->wasPrefetched()) {
                 blk->status &= ~BlkHWPrefetched;
+                if (!pkt->cmd.isPrefetch())
+                    prefetcher->prefetchUseful();
+            }
 
             // Don't notify on SWPrefetch
             if (!pkt->cmd.isSWPrefetch())
@@ -645,6 +648,16 @@ Cache<TagStore>::recvTimingReq(PacketPtr pkt)
 
             // Coalesce unless it was a software prefetch (see above).
             if (pkt) {
+                // A demand access waiting on a prefetch means the
+                // prefetch was useful, but late. Further demand
+                // accesses coalescing into the MSHR do not make it
+                // any more useful.
+                if (prefetcher && !pkt->cmd.isPrefetch() &&
+                    !mshr->prefetchLate && mshr->getTarget()->source ==
+                    MSHR::Target::FromPrefetcher) {
+                    mshr->prefetchLate = true;
+                    prefetcher->prefetchLate();
+                }
                 assert(pkt->req->masterId() < system->maxMasters());
                 mshr_hits[pkt->cmdToIndex()][pkt->req->masterId()]++;
                 if (mshr->threadNum != 0/*pkt->req->threadId()*/) {
@@ -710,6 +723,11 @@ Cache<TagStore>::recvTimingReq(PacketPtr pkt)
                 allocateMissBuffer(pkt, time, true);
             }
 
+            if (prefetcher && !pkt->cmd.isPrefetch() &&
+                pkt->cmd != MemCmd::Writeback) {
+                prefetcher->demandMiss(blk_addr);
+            }
+
             if (prefetcher) {
                 // Don't notify on SWPrefetch
                 if (!pkt->cmd.isSWPrefetch())
@@ -1209,7 +1227,10 @@ Cache<TagStore>::recvTimingResp(PacketPtr pkt)
 
           case MSHR::Target::FromPrefetcher:
             assert(target->pkt->cmd == MemCmd::HardPFReq);
-            if (blk)
+            // if demand accesses already coalesced on the prefetch
+            // they have been accounted for as late prefetches, so
+            // the block does not count as an unreferenced prefetch
+            if (blk && mshr->getNumTargets() == 1)
                 blk->status |= BlkHWPrefetched;
             delete target->pkt->req;
             delete target->pkt;
@@ -1463,6 +1484,11 @@ Cache<TagStore>::handleFill(PacketPtr pkt, BlkType *blk,
             DPRINTF(Cache, "using temp block for %x (%s)\n", addr,
                     is_secure ? "s" : "ns");
         } else {
+            if (prefetcher && blk->isValid()) {
+                prefetcher->notifyEvict(
+                    tags->regenerateBlkAddr(blk->tag, blk->set),
+                    blk->wasPrefetched(), pkt);
+            }
             tags->insertBlock(pkt, blk);
         }
 
@@ -65,7 +65,7 @@ MSHR::MSHR() : readyTime(0), _isUncacheable(false), downstreamPending(false),
                pendingDirty(false), postInvalidate(false),
                postDowngrade(false), queue(NULL), order(0), addr(0), size(0),
                isSecure(false), inService(false), isForward(false),
-               threadNum(InvalidThreadID), data(NULL)
+               prefetchLate(false), threadNum(InvalidThreadID), data(NULL)
 {
 }
 
@@ -211,6 +211,7 @@ MSHR::allocate(Addr _addr, int _size, PacketPtr target, Tick whenReady,
     order = _order;
     assert(target);
     isForward = false;
+    prefetchLate = false;
     _isUncacheable = target->req->isUncacheable();
     inService = false;
     downstreamPending = false;
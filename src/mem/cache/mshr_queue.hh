@@ -217,6 +217,16 @@ class MSHRQueue : public Drainable
         return (allocated > numEntries - numReserve);
     }
 
+    /**
+     * Returns the number of entries that can be allocated before the
+     * queue is considered full.
+     * @return The usable capacity of this queue.
+     */
+    int capacity() const
+    {
+        return numEntries - numReserve + 1;
+    }
+
     /**
      * Returns the MSHR at the head of the readyList.
      * @return The next request to service.
@@ -69,6 +69,27 @@ class BasePrefetcher(ClockedObject):
          "Perform a tagged prefetch for instruction fetches always")
     sys = Param.System(Parent.any, "System this device belongs to")
 
+    # Feedback-directed throttling: every feedback_interval trained
+    # accesses the prefetcher looks at its accuracy, lateness and cache
+    # pollution and moves between a fixed set of aggressiveness levels,
+    # overriding degree.
+    use_feedback = Param.Bool(False,
+         "Adjust prefetch degree and distance based on feedback")
+    feedback_interval = Param.Unsigned(8192,
+         "Number of trained accesses per feedback interval")
+    accuracy_high = Param.Float(0.75,
+         "Accuracy above which the prefetcher is considered accurate")
+    accuracy_low = Param.Float(0.40,
+         "Accuracy below which the prefetcher is considered inaccurate")
+    lateness_threshold = Param.Float(0.01,
+         "Fraction of late useful prefetches considered late")
+    pollution_threshold = Param.Float(0.005,
+         "Fraction of demand misses caused by prefetches considered polluting")
+    pollution_filter_size = Param.Unsigned(4096,
+         "Number of entries in the prefetch pollution filter")
+    mshr_throttle = Param.Float(1.0,
+         "Stop prefetching at this fraction of MSHRs in use (1.0 disables)")
+
 class StridePrefetcher(BasePrefetcher):
     type = 'StridePrefetcher'
     cxx_class = 'StridePrefetcher'
@@ -56,15 +56,51 @@
 #include "mem/request.hh"
 #include "sim/system.hh"
 
+namespace {
+
+/**
+ * Aggressiveness levels used by feedback-directed throttling, from
+ * very conservative to very aggressive. Distance is in strides beyond
+ * the triggering access.
+ */
+const struct {
+    unsigned distance;
+    unsigned degree;
+} levels[] = {
+    { 0, 1 },
+    { 1, 1 },
+    { 2, 2 },
+    { 4, 4 },
+    { 8, 4 },
+};
+
+const unsigned numLevels = sizeof(levels) / sizeof(levels[0]);
+const unsigned initialLevel = numLevels / 2;
+
+} // anonymous namespace
+
 BasePrefetcher::BasePrefetcher(const Params *p)
     : ClockedObject(p), size(p->size), cache(nullptr), blkSize(0),
-      latency(p->latency), degree(p->degree),
+      latency(p->latency), degree(p->degree), distance(0),
       useMasterId(p->use_master_id), pageStop(!p->cross_pages),
       serialSquash(p->serial_squash), onlyData(p->data_accesses_only),
       onMissOnly(p->on_miss_only), onReadOnly(p->on_read_only),
       onPrefetch(p->on_prefetch), system(p->sys),
-      masterId(system->getMasterId(name()))
+      masterId(system->getMasterId(name())),
+      useFeedback(p->use_feedback), feedbackInterval(p->feedback_interval),
+      accuracyHigh(p->accuracy_high), accuracyLow(p->accuracy_low),
+      latenessThreshold(p->lateness_threshold),
+      pollutionThreshold(p->pollution_threshold),
+      mshrThrottle(p->mshr_throttle), level(initialLevel),
+      intervalAccesses(0), pollutionFilter(p->pollution_filter_size, false)
 {
+    if (useFeedback) {
+        fatal_if(feedbackInterval == 0,
+                 "%s: feedback_interval must be non-zero\n", name());
+        fatal_if(pollutionFilter.empty(),
+                 "%s: pollution_filter_size must be non-zero\n", name());
+        applyLevel();
+    }
 }
 
 void
@@ -123,6 +159,180 @@ BasePrefetcher::regStats()
         .desc("number of hwpf that got squashed due to a miss "
               "aborting calculation time")
         ;
+
+    pfUseful
+        .name(name() + ".prefetcher.num_hwpf_useful")
+        .desc("number of hwpf referenced by a demand access")
+        ;
+
+    pfLate
+        .name(name() + ".prefetcher.num_hwpf_late")
+        .desc("number of hwpf still in the MSHR when referenced")
+        ;
+
+    pfUnused
+        .name(name() + ".prefetcher.num_hwpf_unused")
+        .desc("number of hwpf evicted without being referenced")
+        ;
+
+    pfPolluting
+        .name(name() + ".prefetcher.num_hwpf_polluting")
+        .desc("number of demand misses to blocks evicted by a hwpf")
+        ;
+
+    pfThrottled
+        .name(name() + ".prefetcher.num_hwpf_throttled")
+        .desc("number of hwpf dropped due to MSHR occupancy")
+        ;
+
+    pfLevelUp
+        .name(name() + ".prefetcher.num_level_increases")
+        .desc("number of times the prefetcher became more aggressive")
+        ;
+
+    pfLevelDown
+        .name(name() + ".prefetcher.num_level_decreases")
+        .desc("number of times the prefetcher became less aggressive")
+        ;
+
+    pfAccuracy
+        .name(name() + ".prefetcher.accuracy")
+        .desc("fraction of issued hwpf that were useful")
+        .precision(6)
+        ;
+    pfAccuracy = pfUseful / pfIssued;
+
+    pfLateness
+        .name(name() + ".prefetcher.lateness")
+        .desc("fraction of useful hwpf that were late")
+        .precision(6)
+        ;
+    pfLateness = pfLate / pfUseful;
+}
+
+void
+BasePrefetcher::applyLevel()
+{
+    assert(level < numLevels);
+    distance = levels[level].distance;
+    degree = levels[level].degree;
+}
+
+bool
+BasePrefetcher::mshrThrottled() const
+{
+    return mshrThrottle < 1.0 && cache->mshrOccupancy() >= mshrThrottle;
+}
+
+size_t
+BasePrefetcher::pollutionIndex(Addr blk_addr) const
+{
+    Addr blk_num = blk_addr / blkSize;
+    return (blk_num ^ (blk_num >> 12)) % pollutionFilter.size();
+}
+
+void
+BasePrefetcher::prefetchUseful()
+{
+    pfUseful++;
+    feedback.useful++;
+}
+
+void
+BasePrefetcher::prefetchLate()
+{
+    // a late prefetch is still a useful one
+    pfLate++;
+    feedback.late++;
+    prefetchUseful();
+}
+
+void
+BasePrefetcher::demandMiss(Addr blk_addr)
+{
+    feedback.demandMisses++;
+    if (pollutionFilter.empty())
+        return;
+
+    size_t idx = pollutionIndex(blk_addr);
+    if (pollutionFilter[idx]) {
+        DPRINTF(HWPrefetch, "Demand miss to 0x%x evicted by a prefetch\n",
+                blk_addr);
+        pfPolluting++;
+        feedback.polluting++;
+        pollutionFilter[idx] = false;
+    }
+}
+
+void
+BasePrefetcher::notifyEvict(Addr repl_addr, bool was_prefetched,
+                            PacketPtr fill)
+{
+    if (was_prefetched)
+        pfUnused++;
+
+    if (pollutionFilter.empty())
+        return;
+
+    // The fill of a prefetch is a plain read response, but it carries
+    // the request the prefetcher made
+    bool pf_fill = fill->req->masterId() == masterId;
+
+    // only demand blocks displaced by prefetches can cause pollution
+    // misses
+    if (pf_fill && !was_prefetched)
+        pollutionFilter[pollutionIndex(repl_addr)] = true;
+}
+
+void
+BasePrefetcher::adjustAggressiveness()
+{
+    double accuracy = feedback.issued > 0 ?
+        feedback.useful / feedback.issued : 0;
+    bool late = feedback.useful > 0 &&
+        feedback.late / feedback.useful > latenessThreshold;
+    bool polluting = feedback.demandMisses > 0 &&
+        feedback.polluting / feedback.demandMisses > pollutionThreshold;
+
+    // Throttling decisions following feedback-directed prefetching:
+    // accurate but late prefetchers may run further ahead, pollution
+    // or inaccuracy combined with lateness pulls them back, and
+    // everything else keeps the current level.
+    int change = 0;
+    if (accuracy >= accuracyHigh) {
+        if (late)
+            change = 1;
+        else if (polluting)
+            change = -1;
+    } else if (accuracy >= accuracyLow) {
+        if (late && !polluting)
+            change = 1;
+        else if (polluting)
+            change = -1;
+    } else {
+        if (late || polluting)
+            change = -1;
+    }
+
+    if (change > 0 && level + 1 < numLevels) {
+        level++;
+        pfLevelUp++;
+    } else if (change < 0 && level > 0) {
+        level--;
+        pfLevelDown++;
+    }
+
+    DPRINTF(HWPrefetch, "Feedback: accuracy %f late %d polluting %d, "
+            "level %d (degree %d, distance %d)\n", accuracy, late,
+            polluting, level, levels[level].degree, levels[level].distance);
+
+    applyLevel();
+
+    feedback.issued /= 2;
+    feedback.useful /= 2;
+    feedback.late /= 2;
+    feedback.polluting /= 2;
+    feedback.demandMisses /= 2;
 }
 
 inline bool
@@ -155,6 +365,21 @@ BasePrefetcher::getPacket()
         return NULL;
     }
 
+    if (mshrThrottled()) {
+        // demand misses need the MSHRs more than we do, drop what is
+        // queued rather than hold on to increasingly stale prefetches
+        DPRINTF(HWPrefetch, "MSHRs too busy, dropping %d queued hw_pf\n",
+                pf.size());
+        while (!pf.empty()) {
+            pfThrottled++;
+            delete pf.front().pkt->req;
+            delete pf.front().pkt;
+            pf.pop_front();
+        }
+        cache->deassertMemSideBusRequest(BaseCache::Request_PF);
+        return NULL;
+    }
+
     PacketPtr pkt = pf.begin()->pkt;
     while (!pf.empty()) {
         pkt = pf.begin()->pkt;
@@ -179,6 +404,7 @@ BasePrefetcher::getPacket()
     }
 
     pfIssued++;
+    feedback.issued++;
     assert(pkt != NULL);
     DPRINTF(HWPrefetch, "returning 0x%x (%s)\n", pkt->getAddr(),
             pkt->isSecure() ? "s" : "ns");
@@ -240,10 +466,24 @@ BasePrefetcher::notify(PacketPtr &pkt, Tick tick)
         }
 
 
+        if (useFeedback && ++intervalAccesses == feedbackInterval) {
+            intervalAccesses = 0;
+            adjustAggressiveness();
+        }
+
         std::list<Addr> addresses;
         std::list<Cycles> delays;
         calculatePrefetch(pkt, addresses, delays);
 
+        // the prefetcher still trains, but does not queue anything
+        // while the MSHRs are needed for demand misses
+        if (!addresses.empty() && mshrThrottled()) {
+            DPRINTF(HWPrefetch, "MSHRs too busy, not queuing %d hw_pf\n",
+                    addresses.size());
+            pfThrottled += addresses.size();
+            addresses.clear();
+        }
+
         std::list<Addr>::iterator addrIter = addresses.begin();
         std::list<Cycles>::iterator delayIter = delays.begin();
         for (; addrIter != addresses.end(); ++addrIter, ++delayIter) {
@@ -49,6 +49,7 @@
 #define __MEM_CACHE_PREFETCH_BASE_PREFETCHER_HH__
 
 #include <list>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "mem/packet.hh"
@@ -88,8 +89,18 @@ class BasePrefetcher : public ClockedObject
     /** The latency before a prefetch is issued */
     const Cycles latency;
 
-    /** The number of prefetches to issue */
-    const unsigned degree;
+    /**
+     * The number of prefetches to issue. Fixed at the configured
+     * value unless feedback-directed throttling is enabled, in which
+     * case it follows the current aggressiveness level.
+     */
+    unsigned degree;
+
+    /**
+     * How many strides beyond the trigger access the first prefetch
+     * is placed. Zero unless feedback-directed throttling is enabled.
+     */
+    unsigned distance;
 
     /** If patterns should be found per context id */
     const bool useMasterId;
@@ -118,6 +129,71 @@ class BasePrefetcher : public ClockedObject
     /** Request id for prefetches */
     MasterID masterId;
 
+    /** Adjust degree and distance based on prefetch feedback. */
+    const bool useFeedback;
+
+    /** Number of trained accesses per feedback interval. */
+    const unsigned feedbackInterval;
+
+    /** Accuracy above which the prefetcher is considered accurate. */
+    const double accuracyHigh;
+
+    /** Accuracy below which the prefetcher is considered inaccurate. */
+    const double accuracyLow;
+
+    /** Fraction of useful prefetches that arrived late. */
+    const double latenessThreshold;
+
+    /** Fraction of demand misses caused by prefetches. */
+    const double pollutionThreshold;
+
+    /**
+     * MSHR occupancy (as a fraction of the cache MSHRs) at or above
+     * which no further prefetches are queued or issued.
+     */
+    const double mshrThrottle;
+
+    /** Current aggressiveness level, an index into the level table. */
+    unsigned level;
+
+    /** Trained accesses seen in the current feedback interval. */
+    unsigned intervalAccesses;
+
+    /**
+     * Feedback counters. Each is halved at the end of an interval
+     * and then accumulates the events of the next one, so older
+     * intervals decay geometrically.
+     */
+    struct Feedback {
+        double issued;
+        double useful;
+        double late;
+        double polluting;
+        double demandMisses;
+        Feedback()
+            : issued(0), useful(0), late(0), polluting(0), demandMisses(0)
+        {}
+    } feedback;
+
+    /**
+     * Hashed bit vector of demand blocks evicted by prefetch fills.
+     * A later demand miss that hits in the filter is attributed to
+     * prefetcher-caused pollution.
+     */
+    std::vector<bool> pollutionFilter;
+
+    /** Index into the pollution filter for a given block address. */
+    size_t pollutionIndex(Addr blk_addr) const;
+
+    /** Apply the end-of-interval throttling decision. */
+    void adjustAggressiveness();
+
+    /** Set degree and distance from the current aggressiveness level. */
+    void applyLevel();
+
+    /** Check whether the MSHRs are too busy for prefetching. */
+    bool mshrThrottled() const;
+
   public:
 
     Stats::Scalar pfIdentified;
@@ -129,6 +205,15 @@ class BasePrefetcher : public ClockedObject
     Stats::Scalar pfIssued;
     Stats::Scalar pfSpanPage;
     Stats::Scalar pfSquashed;
+    Stats::Scalar pfUseful;
+    Stats::Scalar pfLate;
+    Stats::Scalar pfUnused;
+    Stats::Scalar pfPolluting;
+    Stats::Scalar pfThrottled;
+    Stats::Scalar pfLevelUp;
+    Stats::Scalar pfLevelDown;
+    Stats::Formula pfAccuracy;
+    Stats::Formula pfLateness;
 
     void regStats();
 
@@ -151,6 +236,33 @@ class BasePrefetcher : public ClockedObject
 
     bool inMissQueue(Addr addr, bool is_secure);
 
+    /**
+     * A demand access hit on a block brought in by the prefetcher
+     * that had not been referenced yet.
+     */
+    void prefetchUseful();
+
+    /**
+     * A demand access hit on an outstanding prefetch MSHR, i.e. the
+     * prefetch was useful but not timely.
+     */
+    void prefetchLate();
+
+    /**
+     * A demand access missed in the cache and had to allocate an
+     * MSHR. Used to attribute misses to prefetcher pollution.
+     * @param blk_addr Block-aligned address of the miss.
+     */
+    void demandMiss(Addr blk_addr);
+
+    /**
+     * A block is being replaced to make room for a fill.
+     * @param repl_addr Block-aligned address of the victim.
+     * @param was_prefetched Victim was prefetched and never referenced.
+     * @param fill The response filling the block.
+     */
+    void notifyEvict(Addr repl_addr, bool was_prefetched, PacketPtr fill);
+
     PacketPtr getPacket();
 
     bool havePending()
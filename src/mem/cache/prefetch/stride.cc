@@ -69,7 +69,7 @@ StridePrefetcher::calculatePrefetch(PacketPtr &pkt, std::list<Addr> &addresses,
     // Revert to simple N-block ahead prefetch for instruction fetches
     if (instTagged && pkt->req->isInstFetch()) {
         for (int d = 1; d <= degree; d++) {
-            Addr new_addr = data_addr + d * blkSize;
+            Addr new_addr = data_addr + (distance + d) * blkSize;
             if (pageStop && !samePage(data_addr, new_addr)) {
                 // Spanned the page, so now stop
                 pfSpanPage += degree - d + 1;
@@ -123,7 +123,7 @@ StridePrefetcher::calculatePrefetch(PacketPtr &pkt, std::list<Addr> &addresses,
             return;
 
         for (int d = 1; d <= degree; d++) {
-            Addr new_addr = data_addr + d * (*iter)->stride;
+            Addr new_addr = data_addr + (distance + d) * (*iter)->stride;
             if (pageStop && !samePage(data_addr, new_addr)) {
                 // Spanned the page, so now stop
                 pfSpanPage += degree - d + 1;
@@ -48,7 +48,7 @@ calculatePrefetch(PacketPtr &pkt, std::list<Addr> &addresses,
     Addr blkAddr = pkt->getAddr() & ~(Addr)(blkSize-1);
 
     for (int d = 1; d <= degree; d++) {
-        Addr newAddr = blkAddr + d*(blkSize);
+        Addr newAddr = blkAddr + (distance + d) * blkSize;
         if (pageStop &&  !samePage(blkAddr, newAddr)) {
             // Spanned the page, so now stop
             pfSpanPage += degree - d + 1;
@@ -47,6 +47,8 @@
  * Definition of a crossbar object.
  */
 
+#include <cstring>
+
 #include "base/misc.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
@@ -85,6 +87,8 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams *p)
                                                       defaultPortID)));
     }
 
+    pendingWritebacks.resize(masterPorts.size());
+
     // create the slave ports, once again starting at zero
     for (int i = 0; i < p->port_slave_connection_count; ++i) {
         std::string portName = csprintf("%s.slave[%d]", name(), i);
@@ -97,8 +101,6 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams *p)
 
     if (snoopFilter)
         snoopFilter->setSlavePorts(slavePorts);
-
-    clearPortCache();
 }
 
 CoherentXBar::~CoherentXBar()
@@ -134,6 +136,148 @@ CoherentXBar::init()
         warn("CoherentXBar %s has no snooping ports attached!\n", name());
 }
 
+void
+CoherentXBar::backInvalidateTiming()
+{
+    std::vector<SnoopFilter::Victim> victims = snoopFilter->takeVictims();
+
+    for (const auto& victim : victims) {
+        DPRINTF(CoherentXBar, "%s: back-invalidating 0x%x in %d ports\n",
+                __func__, victim.addr, victim.holders.size());
+
+        Request *req = new Request(victim.addr, system->cacheLineSize(),
+                                   victim.isSecure ? Request::SECURE : 0,
+                                   Request::wbMasterId);
+        PacketPtr pkt = new Packet(req, MemCmd::ReadExReq);
+        pkt->allocate();
+
+        // the holders snoop the line in their MSHRs and write buffers
+        // as well as their tags, and an owner responds later with its
+        // dirty copy
+        for (const auto& p : victim.holders) {
+            p->sendTimingSnoopReq(pkt);
+        }
+        snoopFanout.sample(victim.holders.size());
+
+        if (pkt->memInhibitAsserted()) {
+            // the data is in flight to us, keep the line away from
+            // memory until it is written back
+            assert(backInvalidations.find(victim.addr) ==
+                   backInvalidations.end());
+            backInvalidations[victim.addr].req = req;
+        } else {
+            delete req;
+        }
+        delete pkt;
+    }
+}
+
+void
+CoherentXBar::backInvalidateAtomic()
+{
+    std::vector<SnoopFilter::Victim> victims = snoopFilter->takeVictims();
+
+    for (const auto& victim : victims) {
+        DPRINTF(CoherentXBar, "%s: back-invalidating 0x%x in %d ports\n",
+                __func__, victim.addr, victim.holders.size());
+
+        Request req(victim.addr, system->cacheLineSize(),
+                    victim.isSecure ? Request::SECURE : 0,
+                    Request::wbMasterId);
+        Packet pkt(&req, MemCmd::ReadExReq);
+        pkt.allocate();
+
+        for (const auto& p : victim.holders) {
+            p->sendAtomicSnoop(&pkt);
+        }
+
+        // an owner responded with its dirty copy, write it back
+        // below as the owner would have done on evicting the line
+        if (pkt.memInhibitAsserted()) {
+            PacketPtr wb_pkt = createWriteback(&pkt);
+            PortID master_port_id = findPort(victim.addr);
+            masterPorts[master_port_id]->sendAtomic(wb_pkt);
+            transDist[wb_pkt->cmdToIndex()]++;
+            delete wb_pkt->req;
+            delete wb_pkt;
+        }
+    }
+}
+
+PacketPtr
+CoherentXBar::createWriteback(PacketPtr snoop_pkt) const
+{
+    unsigned line_size = system->cacheLineSize();
+    Request *req = new Request(snoop_pkt->getAddr(), line_size,
+                               snoop_pkt->isSecure() ? Request::SECURE : 0,
+                               Request::wbMasterId);
+    PacketPtr wb_pkt = new Packet(req, MemCmd::Writeback);
+    wb_pkt->allocate();
+    std::memcpy(wb_pkt->getPtr<uint8_t>(), snoop_pkt->getPtr<uint8_t>(),
+                line_size);
+    return wb_pkt;
+}
+
+bool
+CoherentXBar::recvBackInvalidationResp(PacketPtr pkt)
+{
+    Addr line_addr = pkt->getAddr() & ~(Addr(system->cacheLineSize()) - 1);
+    auto b = backInvalidations.find(line_addr);
+    if (b == backInvalidations.end() || b->second.req != pkt->req)
+        return false;
+
+    DPRINTF(CoherentXBar, "%s: writing back 0x%x\n", __func__, line_addr);
+
+    transDist[pkt->cmdToIndex()]++;
+    snoops++;
+
+    // the owner gave up the line when it was snooped, and the line
+    // stays blocked until its data is on its way below
+    PacketPtr wb_pkt = createWriteback(pkt);
+    delete pkt->req;
+    delete pkt;
+    sendWriteback(wb_pkt);
+
+    return true;
+}
+
+void
+CoherentXBar::sendWriteback(PacketPtr wb_pkt)
+{
+    Addr line_addr = wb_pkt->getAddr();
+    PortID master_port_id = findPort(line_addr);
+    std::deque<PacketPtr> &queue = pendingWritebacks[master_port_id];
+
+    // keep the order of the writebacks, and do not send anything
+    // while the peer owes the request layer a retry
+    if (!queue.empty() || reqLayers[master_port_id]->waitingForRetry() ||
+        !masterPorts[master_port_id]->sendTimingReq(wb_pkt)) {
+        DPRINTF(CoherentXBar, "%s: 0x%x waiting for retry\n", __func__,
+                line_addr);
+        queue.push_back(wb_pkt);
+        return;
+    }
+
+    // the packet belongs to the receiver once it is accepted
+    transDist[MemCmd::Writeback]++;
+    endBackInvalidation(line_addr);
+}
+
+void
+CoherentXBar::endBackInvalidation(Addr line_addr)
+{
+    auto b = backInvalidations.find(line_addr);
+    assert(b != backInvalidations.end());
+
+    std::vector<SlavePort*> waiting_ports;
+    waiting_ports.swap(b->second.waitingPorts);
+    backInvalidations.erase(b);
+
+    // let the requests waiting for the line try again
+    for (auto p : waiting_ports)
+        p->sendRetry();
+}
+
 bool
 CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 {
@@ -146,6 +290,22 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     // determine the destination based on the address
     PortID master_port_id = findPort(pkt->getAddr());
 
+    // hold back requests for a line whose dirty data is still on its
+    // way back after the snoop filter replaced it, without holding up
+    // requests for other lines
+    if (!is_express_snoop && !backInvalidations.empty()) {
+        Addr line_addr = pkt->getAddr() &
+            ~(Addr(system->cacheLineSize()) - 1);
+        auto b = backInvalidations.find(line_addr);
+        if (b != backInvalidations.end()) {
+            DPRINTF(CoherentXBar, "recvTimingReq: src %s %s 0x%x "
+                    "BACK-INVALIDATING\n", src_port->name(),
+                    pkt->cmdString(), pkt->getAddr());
+            b->second.waitingPorts.push_back(src_port);
+            return false;
+        }
+    }
+
     // test if the crossbar should be considered occupied for the current
     // port, and exclude express snoops from the check
     if (!is_express_snoop && !reqLayers[master_port_id]->tryTiming(src_port)) {
@@ -176,6 +336,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         if (snoopFilter) {
             // check with the snoop filter where to forward this packet
             auto sf_res = snoopFilter->lookupRequest(pkt, *src_port);
+            backInvalidateTiming();
             packetFinishTime += sf_res.second * clockPeriod();
             DPRINTF(CoherentXBar, "recvTimingReq: src %s %s 0x%x"\
                     " SF size: %i lat: %i\n", src_port->name(),
@@ -364,6 +525,10 @@ CoherentXBar::recvTimingSnoopReq(PacketPtr pkt, PortID master_port_id)
 bool
 CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
 {
+    // responses to our own back-invalidations end here
+    if (!backInvalidations.empty() && recvBackInvalidationResp(pkt))
+        return true;
+
     // determine the source port based on the id
     SlavePort* src_port = slavePorts[slave_port_id];
 
@@ -511,10 +676,24 @@ CoherentXBar::forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id,
 void
 CoherentXBar::recvRetry(PortID master_port_id)
 {
+    // writebacks of back-invalidated lines go first, and if the
+    // peer refuses one of them again it will send another retry
+    std::deque<PacketPtr> &queue = pendingWritebacks[master_port_id];
+    while (!queue.empty()) {
+        PacketPtr wb_pkt = queue.front();
+        Addr line_addr = wb_pkt->getAddr();
+        if (!masterPorts[master_port_id]->sendTimingReq(wb_pkt))
+            return;
+        queue.pop_front();
+        transDist[MemCmd::Writeback]++;
+        endBackInvalidation(line_addr);
+    }
+
     // responses and snoop responses never block on forwarding them,
-    // so the retry will always be coming from a port to which we
+    // so the retry will otherwise be coming from a port to which we
     // tried to forward a request
-    reqLayers[master_port_id]->recvRetry();
+    if (reqLayers[master_port_id]->waitingForRetry())
+        reqLayers[master_port_id]->recvRetry();
 }
 
 Tick
@@ -538,6 +717,7 @@ CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
             // check with the snoop filter where to forward this packet
             auto sf_res =
                 snoopFilter->lookupRequest(pkt, *slavePorts[slave_port_id]);
+            backInvalidateAtomic();
             snoop_response_latency += sf_res.second * clockPeriod();
             DPRINTF(CoherentXBar, "%s: src %s %s 0x%x"\
                     " SF size: %i lat: %i\n", __func__,
@@ -51,6 +51,8 @@
 #ifndef __MEM_COHERENT_XBAR_HH__
 #define __MEM_COHERENT_XBAR_HH__
 
+#include <deque>
+
 #include "base/hashmap.hh"
 #include "mem/snoop_filter.hh"
 #include "mem/xbar.hh"
@@ -275,6 +277,70 @@ class CoherentXBar : public BaseXBar
       * broadcast needed for probes.  NULL denotes an absent filter. */
     SnoopFilter *snoopFilter;
 
+    /**
+     * A line replaced by the snoop filter whose owner still has to
+     * return the dirty data. Requests for the line are held back
+     * until the data is written below.
+     */
+    struct BackInvalidation {
+        /** Request of the invalidating snoop, identifies the response */
+        RequestPtr req;
+        /** Ports whose requests for the line were refused */
+        std::vector<SlavePort*> waitingPorts;
+    };
+
+    /** Back-invalidations waiting for data, indexed by line address */
+    m5::hash_map<Addr, BackInvalidation> backInvalidations;
+
+    /**
+     * Writebacks of back-invalidated lines that could not be sent
+     * yet, one queue per master port.
+     */
+    std::vector<std::deque<PacketPtr> > pendingWritebacks;
+
+    /**
+     * Invalidate the lines the snoop filter replaced to make room for
+     * new ones by sending timing snoops to their holders. Lines whose
+     * owner responds with data are blocked until the response is
+     * received and written back.
+     */
+    void backInvalidateTiming();
+
+    /**
+     * Invalidate the lines the snoop filter replaced, snooping the
+     * holders atomically and writing back any dirty data.
+     */
+    void backInvalidateAtomic();
+
+    /**
+     * Create a writeback for the dirty data an owner returned in
+     * response to a back-invalidation.
+     *
+     * @param snoop_pkt The back-invalidating snoop with the data
+     * @return A writeback of the line
+     */
+    PacketPtr createWriteback(PacketPtr snoop_pkt) const;
+
+    /**
+     * Complete a back-invalidation once the owner's snoop response
+     * arrives by writing the data back below.
+     *
+     * @return true if the packet responded to a back-invalidation
+     */
+    bool recvBackInvalidationResp(PacketPtr pkt);
+
+    /**
+     * Send the writeback of a back-invalidated line, or queue it if
+     * the master port is waiting for a retry.
+     */
+    void sendWriteback(PacketPtr wb_pkt);
+
+    /**
+     * Unblock a line once its writeback has been sent, and let the
+     * ports whose requests for it were refused try again.
+     */
+    void endBackInvalidation(Addr line_addr);
+
     /** Function called by the port when the crossbar is recieving a Timing
       request packet.*/
     bool recvTimingReq(PacketPtr pkt, PortID slave_port_id);
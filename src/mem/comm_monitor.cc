@@ -174,6 +174,20 @@ CommMonitor::recvFunctionalSnoop(PacketPtr pkt)
 Tick
 CommMonitor::recvAtomic(PacketPtr pkt)
 {
+    // Atomic accesses are traced as well, so that the trace of an
+    // atomic-mode run can be used to warm up caches. The packet is
+    // recorded before it is turned into a response.
+    if (traceStream != NULL) {
+        ProtoMessage::Packet pkt_msg;
+        pkt_msg.set_tick(curTick());
+        pkt_msg.set_cmd(pkt->cmdToIndex());
+        pkt_msg.set_flags(pkt->req->getFlags());
+        pkt_msg.set_addr(pkt->getAddr());
+        pkt_msg.set_size(pkt->getSize());
+
+        traceStream->write(pkt_msg);
+    }
+
     return masterPort.sendAtomic(pkt);
 }
 
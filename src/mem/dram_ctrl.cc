@@ -42,7 +42,10 @@
  *          Neha Agarwal
  */
 
+#include <algorithm>
+
 #include "base/bitfield.hh"
+#include "base/callback.hh"
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/DRAMPower.hh"
@@ -83,7 +86,11 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     tCCD_L(p->tCCD_L), tRCD(p->tRCD), tCL(p->tCL), tRP(p->tRP), tRAS(p->tRAS),
     tWR(p->tWR), tRTP(p->tRTP), tRFC(p->tRFC), tREFI(p->tREFI), tRRD(p->tRRD),
     tRRD_L(p->tRRD_L), tXAW(p->tXAW), activationLimit(p->activation_limit),
-    memSchedPolicy(p->mem_sched_policy), addrMapping(p->addr_mapping),
+    memSchedPolicy(p->mem_sched_policy),
+    blissThreshold(p->bliss_threshold), schedQuantum(p->sched_quantum),
+    atlasHistoryWeight(p->atlas_history_weight), nextQuantumAt(0),
+    lastServedMaster(Request::invldMasterId), servedStreak(0),
+    addrMapping(p->addr_mapping),
     pageMgmt(p->page_policy),
     maxAccessesPerRow(p->max_accesses_per_row),
     frontendLatency(p->static_frontend_latency),
@@ -91,12 +98,16 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     busBusyUntil(0), refreshDueAt(0), refreshState(REF_IDLE),
     pwrStateTrans(PWR_IDLE), pwrState(PWR_IDLE), prevArrival(0),
     nextReqTime(0), pwrStateTick(0), numBanksActive(0),
-    activeRank(0), timeStampOffset(0)
+    activeRank(0), timeStampOffset(0),
+    powerBatchSize(p->power_batch_size)
 {
     // create the bank states based on the dimensions of the ranks and
     // banks
     banks.resize(ranksPerChannel);
 
+    readIndex = QueueIndex(ranksPerChannel * banksPerRank);
+    writeIndex = QueueIndex(ranksPerChannel * banksPerRank);
+
     //create list of drampower objects. For each rank 1 drampower instance.
     for (int i = 0; i < ranksPerChannel; i++) {
         DRAMPower drampower = DRAMPower(p, false);
@@ -459,6 +470,7 @@ DRAMCtrl::addToReadQueue(PacketPtr pkt, unsigned int pktCount)
             DPRINTF(DRAM, "Adding to read queue\n");
 
             readQueue.push_back(dram_pkt);
+            readIndex.add(dram_pkt);
 
             // Update stats
             avgRdQLen = readQueue.size() + respQueue.size();
@@ -572,6 +584,7 @@ DRAMCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pktCount)
             DPRINTF(DRAM, "Adding to write queue\n");
 
             writeQueue.push_back(dram_pkt);
+            writeIndex.add(dram_pkt);
 
             // Update stats
             avgWrQLen = writeQueue.size();
@@ -738,7 +751,72 @@ DRAMCtrl::processRespondEvent()
 }
 
 void
-DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, bool switched_cmd_type)
+DRAMCtrl::QueueIndex::add(DRAMPacket* dram_pkt)
+{
+    dram_pkt->seqNum = nextSeqNum++;
+    bankPkts[dram_pkt->bankId].push_back(dram_pkt);
+    rows[dram_pkt->bankId][dram_pkt->row].push_back(dram_pkt);
+    if (dram_pkt->bankRef.openRow == dram_pkt->row)
+        ++hits;
+}
+
+void
+DRAMCtrl::QueueIndex::remove(const DRAMPacket* dram_pkt)
+{
+    removeFrom(bankPkts[dram_pkt->bankId], dram_pkt);
+
+    auto r = rows[dram_pkt->bankId].find(dram_pkt->row);
+    assert(r != rows[dram_pkt->bankId].end());
+    removeFrom(r->second, dram_pkt);
+    if (r->second.empty())
+        rows[dram_pkt->bankId].erase(r);
+
+    if (dram_pkt->bankRef.openRow == dram_pkt->row) {
+        assert(hits != 0);
+        --hits;
+    }
+}
+
+void
+DRAMCtrl::QueueIndex::removeFrom(Bucket& bucket, const DRAMPacket* dram_pkt)
+{
+    // the schedulers mostly pick the oldest packet of a bank or row
+    if (bucket.front() == dram_pkt) {
+        bucket.pop_front();
+    } else {
+        auto i = std::find(bucket.begin(), bucket.end(), dram_pkt);
+        assert(i != bucket.end());
+        bucket.erase(i);
+    }
+}
+
+void
+DRAMCtrl::QueueIndex::rowChanged(uint16_t bank_id, uint32_t old_row,
+                                 uint32_t new_row)
+{
+    if (old_row != Bank::NO_ROW)
+        hits -= queuedTo(bank_id, old_row);
+    if (new_row != Bank::NO_ROW)
+        hits += queuedTo(bank_id, new_row);
+}
+
+uint32_t
+DRAMCtrl::QueueIndex::queuedTo(uint16_t bank_id, uint32_t row) const
+{
+    auto r = rows[bank_id].find(row);
+    return r == rows[bank_id].end() ? 0 : r->second.size();
+}
+
+DRAMCtrl::DRAMPacket*
+DRAMCtrl::QueueIndex::oldestTo(uint16_t bank_id, uint32_t row) const
+{
+    auto r = rows[bank_id].find(row);
+    return r == rows[bank_id].end() ? NULL : r->second.front();
+}
+
+void
+DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, const QueueIndex& index,
+                     bool switched_cmd_type)
 {
     // This method does the arbitration between requests. The chosen
     // packet is simply moved to the head of the queue. The other
@@ -754,57 +832,132 @@ DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, bool switched_cmd_type)
     if (memSchedPolicy == Enums::fcfs) {
         // Do nothing, since the correct request is already head
     } else if (memSchedPolicy == Enums::frfcfs) {
-        reorderQueue(queue, switched_cmd_type);
+        reorderQueue(queue, index, switched_cmd_type);
+    } else if (memSchedPolicy == Enums::bliss ||
+               memSchedPolicy == Enums::atlas) {
+        reorderQueueByMaster(queue, index, switched_cmd_type);
     } else
         panic("No scheduling policy chosen\n");
 }
 
 void
-DRAMCtrl::reorderQueue(std::deque<DRAMPacket*>& queue, bool switched_cmd_type)
+DRAMCtrl::reorderQueue(std::deque<DRAMPacket*>& queue, const QueueIndex& index,
+                       bool switched_cmd_type)
 {
-    // Only determine this when needed
-    uint64_t earliest_banks = 0;
+    // The index keeps the packets of every bank and row in arrival
+    // order, so the candidates are the heads of the open row buckets,
+    // or the heads of the earliest banks, and FCFS amongst them only
+    // has to compare their arrival order
+    DRAMPacket* selected_pkt = NULL;
 
     // Search for row hits first, if no row hit is found then schedule the
     // packet to one of the earliest banks available
-    bool found_earliest_pkt = false;
-    bool found_prepped_diff_rank_pkt = false;
-    auto selected_pkt_it = queue.begin();
-
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        DRAMPacket* dram_pkt = *i;
-        const Bank& bank = dram_pkt->bankRef;
-        // Check if it is a row hit
-        if (bank.openRow == dram_pkt->row) {
-            if (dram_pkt->rank == activeRank || switched_cmd_type) {
-                // FCFS within the hits, giving priority to commands
-                // that access the same rank as the previous burst
-                // to minimize bus turnaround delays
-                // Only give rank prioity when command type is not changing
-                DPRINTF(DRAM, "Row buffer hit\n");
-                selected_pkt_it = i;
-                break;
-            } else if (!found_prepped_diff_rank_pkt) {
-                // found row hit for command on different rank than prev burst
-                selected_pkt_it = i;
-                found_prepped_diff_rank_pkt = true;
+    if (index.rowHits() != 0) {
+        DRAMPacket* diff_rank_pkt = NULL;
+
+        for (int i = 0; i < ranksPerChannel; i++) {
+            for (int j = 0; j < banksPerRank; j++) {
+                const Bank& bank = banks[i][j];
+                if (bank.openRow == Bank::NO_ROW)
+                    continue;
+
+                DRAMPacket* dram_pkt =
+                    index.oldestTo(i * banksPerRank + j, bank.openRow);
+                if (dram_pkt == NULL)
+                    continue;
+
+                if (dram_pkt->rank == activeRank || switched_cmd_type) {
+                    // FCFS within the hits, giving priority to commands
+                    // that access the same rank as the previous burst
+                    // to minimize bus turnaround delays
+                    // Only give rank prioity when command type is not
+                    // changing
+                    if (selected_pkt == NULL ||
+                        dram_pkt->seqNum < selected_pkt->seqNum)
+                        selected_pkt = dram_pkt;
+                } else if (diff_rank_pkt == NULL ||
+                           dram_pkt->seqNum < diff_rank_pkt->seqNum) {
+                    // row hit for command on different rank than prev burst
+                    diff_rank_pkt = dram_pkt;
+                }
             }
-        } else if (!found_earliest_pkt & !found_prepped_diff_rank_pkt) {
-            // No row hit and
-            // haven't found an entry with a row hit to a new rank
+        }
+
+        if (selected_pkt != NULL)
+            DPRINTF(DRAM, "Row buffer hit\n");
+        else
+            selected_pkt = diff_rank_pkt;
+    } else {
+        // Determine entries with earliest bank prep delay
+        // Function will give priority to commands that access the
+        // same rank as previous burst and can prep the bank seamlessly
+        uint64_t earliest_banks = minBankPrep(index, switched_cmd_type);
+
+        // FCFS amongst the earliest banks available
+        for (int bank_id = 0; bank_id < ranksPerChannel * banksPerRank;
+             bank_id++) {
+            if (!bits(earliest_banks, bank_id, bank_id))
+                continue;
+
+            DRAMPacket* dram_pkt = index.oldestTo(bank_id);
+            if (dram_pkt != NULL && (selected_pkt == NULL ||
+                                     dram_pkt->seqNum < selected_pkt->seqNum))
+                selected_pkt = dram_pkt;
+        }
+    }
+
+    // Otherwise the oldest packet stays at the head of the queue
+    if (selected_pkt == NULL || selected_pkt == queue.front())
+        return;
+
+    auto selected_pkt_it = std::find(queue.begin(), queue.end(),
+                                     selected_pkt);
+    assert(selected_pkt_it != queue.end());
+    queue.erase(selected_pkt_it);
+    queue.push_front(selected_pkt);
+}
+
+void
+DRAMCtrl::reorderQueueByMaster(std::deque<DRAMPacket*>& queue,
+                               const QueueIndex& index,
+                               bool switched_cmd_type)
+{
+    if (curTick() >= nextQuantumAt)
+        endSchedQuantum();
+
+    // Pick the oldest packet amongst those of the most important
+    // masters. Within a priority class the FR-FCFS preferences break
+    // the tie: row hits to the same rank as the previous burst, then
+    // row hits to other ranks, then bursts to the earliest banks
+    uint64_t earliest_banks = 0;
+    auto selected_pkt_it = queue.end();
+    double best_prio = 0;
+    unsigned best_pref = 0;
+
+    for (auto i = queue.begin(); i != queue.end(); ++i) {
+        const DRAMPacket* dram_pkt = *i;
+        double prio = masterPriority(dram_pkt->masterId);
+
+        // nothing in this class can beat the current candidate
+        if (selected_pkt_it != queue.end() &&
+            (prio > best_prio || (prio == best_prio && best_pref == 0)))
+            continue;
+
+        unsigned pref;
+        if (dram_pkt->bankRef.openRow == dram_pkt->row) {
+            pref = dram_pkt->rank == activeRank || switched_cmd_type ? 0 : 1;
+        } else {
             if (earliest_banks == 0)
-                // Determine entries with earliest bank prep delay
-                // Function will give priority to commands that access the
-                // same rank as previous burst and can prep the bank seamlessly
-                earliest_banks = minBankPrep(queue, switched_cmd_type);
-
-            // FCFS - Bank is first available bank
-            if (bits(earliest_banks, dram_pkt->bankId, dram_pkt->bankId)) {
-                // Remember the packet to be scheduled to one of the earliest
-                // banks available, FCFS amongst the earliest banks
-                selected_pkt_it = i;
-                found_earliest_pkt = true;
-            }
+                earliest_banks = minBankPrep(index, switched_cmd_type);
+            pref = bits(earliest_banks, dram_pkt->bankId,
+                        dram_pkt->bankId) ? 2 : 3;
+        }
+
+        if (selected_pkt_it == queue.end() || prio < best_prio ||
+            pref < best_pref) {
+            selected_pkt_it = i;
+            best_prio = prio;
+            best_pref = pref;
         }
     }
 
@@ -813,6 +966,66 @@ DRAMCtrl::reorderQueue(std::deque<DRAMPacket*>& queue, bool switched_cmd_type)
     queue.push_front(selected_pkt);
 }
 
+double
+DRAMCtrl::masterPriority(MasterID master_id) const
+{
+    if (memSchedPolicy == Enums::bliss) {
+        return master_id < blacklisted.size() && blacklisted[master_id] ?
+            1 : 0;
+    } else {
+        assert(memSchedPolicy == Enums::atlas);
+        return master_id < attainedService.size() ?
+            attainedService[master_id] : 0;
+    }
+}
+
+void
+DRAMCtrl::updateMasterService(const DRAMPacket* dram_pkt)
+{
+    MasterID master_id = dram_pkt->masterId;
+
+    if (memSchedPolicy == Enums::bliss) {
+        if (master_id == lastServedMaster) {
+            ++servedStreak;
+        } else {
+            lastServedMaster = master_id;
+            servedStreak = 1;
+        }
+
+        if (servedStreak > blissThreshold) {
+            if (master_id >= blacklisted.size())
+                blacklisted.resize(master_id + 1, false);
+            if (!blacklisted[master_id])
+                DPRINTF(DRAM, "Blacklisting master %d\n", master_id);
+            blacklisted[master_id] = true;
+        }
+    } else if (memSchedPolicy == Enums::atlas) {
+        if (master_id >= quantumService.size()) {
+            quantumService.resize(master_id + 1, 0);
+            attainedService.resize(master_id + 1, 0);
+        }
+        ++quantumService[master_id];
+    }
+}
+
+void
+DRAMCtrl::endSchedQuantum()
+{
+    if (memSchedPolicy == Enums::bliss) {
+        blacklisted.assign(blacklisted.size(), false);
+    } else if (memSchedPolicy == Enums::atlas) {
+        for (size_t i = 0; i < attainedService.size(); ++i) {
+            attainedService[i] = atlasHistoryWeight * attainedService[i] +
+                (1 - atlasHistoryWeight) * quantumService[i];
+            quantumService[i] = 0;
+        }
+    }
+
+    // skip any quanta where we did not schedule anything
+    nextQuantumAt = curTick() + schedQuantum -
+        (curTick() - nextQuantumAt) % schedQuantum;
+}
+
 void
 DRAMCtrl::accessAndRespond(PacketPtr pkt, Tick static_latency)
 {
@@ -857,6 +1070,9 @@ DRAMCtrl::activateBank(Bank& bank, Tick act_tick, uint32_t row)
 
     // update the open row
     assert(bank.openRow == Bank::NO_ROW);
+    uint16_t bank_id = rank * banksPerRank + bank.bank;
+    readIndex.rowChanged(bank_id, Bank::NO_ROW, row);
+    writeIndex.rowChanged(bank_id, Bank::NO_ROW, row);
     bank.openRow = row;
 
     // start counting anew, this covers both the case when we
@@ -871,9 +1087,9 @@ DRAMCtrl::activateBank(Bank& bank, Tick act_tick, uint32_t row)
     DPRINTF(DRAM, "Activate bank %d, rank %d at tick %lld, now got %d active\n",
             bank.bank, bank.rank, act_tick, numBanksActive);
 
-    rankPower[bank.rank].powerlib.doCommand(MemCommand::ACT, bank.bank,
-                                            divCeil(act_tick, tCK) -
-                                            timeStampOffset);
+    rankPower[bank.rank].doCommand(MemCommand::ACT, bank.bank,
+                                   divCeil(act_tick, tCK) -
+                                   timeStampOffset);
 
     DPRINTF(DRAMPower, "%llu,ACT,%d,%d\n", divCeil(act_tick, tCK) -
             timeStampOffset, bank.bank, bank.rank);
@@ -964,6 +1180,9 @@ DRAMCtrl::prechargeBank(Bank& bank, Tick pre_at, bool trace)
     // the page
     bytesPerActivate.sample(bank.bytesAccessed);
 
+    uint16_t bank_id = bank.rank * banksPerRank + bank.bank;
+    readIndex.rowChanged(bank_id, bank.openRow, Bank::NO_ROW);
+    writeIndex.rowChanged(bank_id, bank.openRow, Bank::NO_ROW);
     bank.openRow = Bank::NO_ROW;
 
     // no precharge allowed before this one
@@ -981,9 +1200,9 @@ DRAMCtrl::prechargeBank(Bank& bank, Tick pre_at, bool trace)
 
     if (trace) {
 
-        rankPower[bank.rank].powerlib.doCommand(MemCommand::PRE, bank.bank,
-                                                divCeil(pre_at, tCK) -
-                                                timeStampOffset);
+        rankPower[bank.rank].doCommand(MemCommand::PRE, bank.bank,
+                                       divCeil(pre_at, tCK) -
+                                       timeStampOffset);
         DPRINTF(DRAMPower, "%llu,PRE,%d,%d\n", divCeil(pre_at, tCK) -
                 timeStampOffset, bank.bank, bank.rank);
     }
@@ -1123,29 +1342,14 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
         // page, but closes it only if there are no row hits in the queue.
         // In this case, only force an auto precharge when there
         // are no same page hits in the queue
-        bool got_more_hits = false;
-        bool got_bank_conflict = false;
-
-        // either look at the read queue or write queue
-        const deque<DRAMPacket*>& queue = dram_pkt->isRead ? readQueue :
-            writeQueue;
-        auto p = queue.begin();
-        // make sure we are not considering the packet that we are
-        // currently dealing with (which is the head of the queue)
-        ++p;
-
-        // keep on looking until we have found required condition or
-        // reached the end
-        while (!(got_more_hits &&
-                 (got_bank_conflict || pageMgmt == Enums::close_adaptive)) &&
-               p != queue.end()) {
-            bool same_rank_bank = (dram_pkt->rank == (*p)->rank) &&
-                (dram_pkt->bank == (*p)->bank);
-            bool same_row = dram_pkt->row == (*p)->row;
-            got_more_hits |= same_rank_bank && same_row;
-            got_bank_conflict |= same_rank_bank && !same_row;
-            ++p;
-        }
+        // either look at the read queue or write queue, note that
+        // the packet we are currently dealing with (the head of the
+        // queue) is still part of the counts
+        const QueueIndex& index = dram_pkt->isRead ? readIndex : writeIndex;
+        uint32_t same_row = index.queuedTo(dram_pkt->bankId, dram_pkt->row);
+        assert(same_row != 0);
+        bool got_more_hits = same_row > 1;
+        bool got_bank_conflict = index.queuedTo(dram_pkt->bankId) > same_row;
 
         // auto pre-charge when either
         // 1) open_adaptive policy, we have not got any more hits, and
@@ -1178,9 +1382,9 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
     DPRINTF(DRAM, "Access to %lld, ready at %lld bus busy until %lld.\n",
             dram_pkt->addr, dram_pkt->readyTime, busBusyUntil);
 
-    rankPower[dram_pkt->rank].powerlib.doCommand(command, dram_pkt->bank,
-                                                 divCeil(cmd_at, tCK) -
-                                                 timeStampOffset);
+    rankPower[dram_pkt->rank].doCommand(command, dram_pkt->bank,
+                                        divCeil(cmd_at, tCK) -
+                                        timeStampOffset);
 
     DPRINTF(DRAMPower, "%llu,%s,%d,%d\n", divCeil(cmd_at, tCK) -
             timeStampOffset, mem_cmd, dram_pkt->bank, dram_pkt->rank);
@@ -1285,7 +1489,7 @@ DRAMCtrl::processNextReqEvent()
         } else {
             // Figure out which read request goes next, and move it to the
             // front of the read queue
-            chooseNext(readQueue, switched_cmd_type);
+            chooseNext(readQueue, readIndex, switched_cmd_type);
 
             DRAMPacket* dram_pkt = readQueue.front();
 
@@ -1299,8 +1503,10 @@ DRAMCtrl::processNextReqEvent()
             }
 
             doDRAMAccess(dram_pkt);
+            updateMasterService(dram_pkt);
 
             // At this point we're done dealing with the request
+            readIndex.remove(dram_pkt);
             readQueue.pop_front();
 
             // sanity check
@@ -1333,7 +1539,7 @@ DRAMCtrl::processNextReqEvent()
             busState = READ_TO_WRITE;
         }
     } else {
-        chooseNext(writeQueue, switched_cmd_type);
+        chooseNext(writeQueue, writeIndex, switched_cmd_type);
         DRAMPacket* dram_pkt = writeQueue.front();
         // sanity check
         assert(dram_pkt->size <= burstSize);
@@ -1347,7 +1553,9 @@ DRAMCtrl::processNextReqEvent()
         }
 
         doDRAMAccess(dram_pkt);
+        updateMasterService(dram_pkt);
 
+        writeIndex.remove(dram_pkt);
         writeQueue.pop_front();
         delete dram_pkt;
 
@@ -1382,7 +1590,7 @@ DRAMCtrl::processNextReqEvent()
 }
 
 uint64_t
-DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
+DRAMCtrl::minBankPrep(const QueueIndex& index,
                       bool switched_cmd_type) const
 {
     uint64_t bank_mask = 0;
@@ -1394,20 +1602,13 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
     // Give precedence to commands that access same rank as previous command
     bool same_rank_match = false;
 
-    // determine if we have queued transactions targetting the
-    // bank in question
-    vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (auto p = queue.begin(); p != queue.end(); ++p) {
-        got_waiting[(*p)->bankId] = true;
-    }
-
     for (int i = 0; i < ranksPerChannel; i++) {
         for (int j = 0; j < banksPerRank; j++) {
             uint8_t bank_id = i * banksPerRank + j;
 
             // if we have waiting requests for the bank, and it is
             // amongst the first available, update the mask
-            if (got_waiting[bank_id]) {
+            if (index.queuedTo(bank_id) != 0) {
                 // simplistic approximation of when the bank can issue
                 // an activate, ignoring any rank-to-rank switching
                 // cost in this calculation
@@ -1536,9 +1737,9 @@ DRAMCtrl::processRefreshEvent()
                 }
 
                 // at the moment this affects all ranks
-                rankPower[i].powerlib.doCommand(MemCommand::PREA, 0,
-                                                divCeil(pre_at, tCK) -
-                                                timeStampOffset);
+                rankPower[i].doCommand(MemCommand::PREA, 0,
+                                       divCeil(pre_at, tCK) -
+                                       timeStampOffset);
 
                 DPRINTF(DRAMPower, "%llu,PREA,0,%d\n", divCeil(pre_at, tCK) -
                         timeStampOffset, i);
@@ -1575,30 +1776,16 @@ DRAMCtrl::processRefreshEvent()
             }
 
             // at the moment this affects all ranks
-            rankPower[i].powerlib.doCommand(MemCommand::REF, 0,
-                                            divCeil(curTick(), tCK) -
-                                            timeStampOffset);
-
-            // at the moment sort the list of commands and update the counters
-            // for DRAMPower libray when doing a refresh
-            sort(rankPower[i].powerlib.cmdList.begin(),
-                 rankPower[i].powerlib.cmdList.end(), DRAMCtrl::sortTime);
-
-            // update the counters for DRAMPower, passing false to
-            // indicate that this is not the last command in the
-            // list. DRAMPower requires this information for the
-            // correct calculation of the background energy at the end
-            // of the simulation. Ideally we would want to call this
-            // function with true once at the end of the
-            // simulation. However, the discarded energy is extremly
-            // small and does not effect the final results.
-            rankPower[i].powerlib.updateCounters(false);
-
-            // call the energy function
-            rankPower[i].powerlib.calcEnergy();
-
-            // Update the stats
-            updatePowerStats(i);
+            rankPower[i].doCommand(MemCommand::REF, 0,
+                                   divCeil(curTick(), tCK) -
+                                   timeStampOffset);
+
+            // all banks are precharged at this point, and nothing
+            // can be issued before the refresh, so this is a safe
+            // point to hand a batch of commands to DRAMPower, the
+            // energy is only calculated when the stats are dumped
+            if (rankPower[i].pendingCommands() >= powerBatchSize)
+                rankPower[i].flushCommands();
 
             DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(curTick(), tCK) -
                     timeStampOffset, i);
@@ -1701,9 +1888,22 @@ DRAMCtrl::processPowerEvent()
     }
 }
 
+void
+DRAMCtrl::updatePowerStats()
+{
+    for (uint8_t i = 0; i < ranksPerChannel; i++)
+        updatePowerStats(i);
+}
+
 void
 DRAMCtrl::updatePowerStats(uint8_t rank)
 {
+    // commands at or after the current cycle can still be preceded
+    // by commands issued later, so leave those for the next batch
+    rankPower[rank].flushCommands(divCeil(curTick(), tCK) -
+                                  timeStampOffset);
+    rankPower[rank].calcEnergy();
+
     // Get the energy and power from DRAMPower
     Data::MemoryPowerModel::Energy energy =
         rankPower[rank].powerlib.getEnergy();
@@ -2030,6 +2230,10 @@ DRAMCtrl::regStats()
         .init(ranksPerChannel)
         .name(name() + ".averagePower")
         .desc("Core power per rank (mW)");
+
+    // the energy is only calculated when it is needed
+    Stats::registerDumpCallback(
+        new MakeCallback<DRAMCtrl, &DRAMCtrl::updatePowerStats>(this));
 }
 
 void
@@ -51,7 +51,9 @@
 #define __MEM_DRAM_CTRL_HH__
 
 #include <deque>
+#include <vector>
 
+#include "base/hashmap.hh"
 #include "base/statistics.hh"
 #include "enums/AddrMap.hh"
 #include "enums/MemSched.hh"
@@ -248,15 +250,99 @@ class DRAMCtrl : public AbstractMemory
         BurstHelper* burstHelper;
         Bank& bankRef;
 
+        /**
+         * The master that issued the request, kept separately as the
+         * packet of a write is responded to (and gone) long before
+         * the write is scheduled
+         */
+        const MasterID masterId;
+
+        /** Arrival order within its queue, set when it is indexed */
+        uint64_t seqNum;
+
         DRAMPacket(PacketPtr _pkt, bool is_read, uint8_t _rank, uint8_t _bank,
                    uint32_t _row, uint16_t bank_id, Addr _addr,
                    unsigned int _size, Bank& bank_ref)
             : entryTime(curTick()), readyTime(curTick()),
               pkt(_pkt), isRead(is_read), rank(_rank), bank(_bank), row(_row),
               bankId(bank_id), addr(_addr), size(_size), burstHelper(NULL),
-              bankRef(bank_ref)
+              bankRef(bank_ref), masterId(_pkt->req->masterId()),
+              seqNum(0)
+        { }
+
+    };
+
+    /**
+     * A per-bank view of the read or write queue, keeping the packets
+     * waiting for each bank and for each row in arrival order, and
+     * counting how many of the queued packets would hit in the
+     * currently open rows. It is kept up to date as packets are
+     * queued and dequeued, and as rows are opened and closed, so that
+     * the scheduler and the page policy can answer these questions
+     * without walking the queue.
+     */
+    class QueueIndex {
+
+      public:
+
+        QueueIndex(unsigned int num_banks = 0)
+            : bankPkts(num_banks), rows(num_banks), hits(0), nextSeqNum(0)
         { }
 
+        /** Index a packet as the youngest one in the queue */
+        void add(DRAMPacket* dram_pkt);
+
+        void remove(const DRAMPacket* dram_pkt);
+
+        /**
+         * The open row of a bank is changing.
+         *
+         * @param bank_id Bank id across all ranks
+         * @param old_row Row that was open, or Bank::NO_ROW
+         * @param new_row Row that is now open, or Bank::NO_ROW
+         */
+        void rowChanged(uint16_t bank_id, uint32_t old_row, uint32_t new_row);
+
+        /** Number of queued packets to a bank */
+        uint32_t queuedTo(uint16_t bank_id) const
+        { return bankPkts[bank_id].size(); }
+
+        /** Number of queued packets to a specific row of a bank */
+        uint32_t queuedTo(uint16_t bank_id, uint32_t row) const;
+
+        /** Oldest queued packet to a bank, or NULL if there is none */
+        DRAMPacket* oldestTo(uint16_t bank_id) const
+        {
+            return bankPkts[bank_id].empty() ? NULL :
+                bankPkts[bank_id].front();
+        }
+
+        /**
+         * Oldest queued packet to a specific row of a bank, or NULL
+         * if there is none
+         */
+        DRAMPacket* oldestTo(uint16_t bank_id, uint32_t row) const;
+
+        /** Number of queued packets that hit in an open row */
+        uint32_t rowHits() const { return hits; }
+
+      private:
+
+        typedef std::deque<DRAMPacket*> Bucket;
+
+        /** Remove a packet from a bucket, usually from its head */
+        static void removeFrom(Bucket& bucket, const DRAMPacket* dram_pkt);
+
+        /** Queued packets to each bank, oldest first */
+        std::vector<Bucket> bankPkts;
+
+        /** Queued packets to each row of each bank, oldest first */
+        std::vector<m5::hash_map<uint32_t, Bucket> > rows;
+
+        uint32_t hits;
+
+        /** Arrival order to give the next packet */
+        uint64_t nextSeqNum;
     };
 
     /**
@@ -374,9 +460,11 @@ class DRAMCtrl : public AbstractMemory
      * controller is switching command type.
      *
      * @param queue Queued requests to consider
+     * @param index Per-bank view of the queue
      * @param switched_cmd_type Command type is changing
      */
-    void chooseNext(std::deque<DRAMPacket*>& queue, bool switched_cmd_type);
+    void chooseNext(std::deque<DRAMPacket*>& queue, const QueueIndex& index,
+                    bool switched_cmd_type);
 
     /**
      * For FR-FCFS policy reorder the read/write queue depending on row buffer
@@ -385,20 +473,61 @@ class DRAMCtrl : public AbstractMemory
      * controller is switching command type.
      *
      * @param queue Queued requests to consider
+     * @param index Per-bank view of the queue
      * @param switched_cmd_type Command type is changing
      */
-    void reorderQueue(std::deque<DRAMPacket*>& queue, bool switched_cmd_type);
+    void reorderQueue(std::deque<DRAMPacket*>& queue, const QueueIndex& index,
+                      bool switched_cmd_type);
+
+    /**
+     * For the master-aware policies (BLISS and ATLAS) reorder the
+     * read/write queue by the priority of the issuing master first,
+     * then by the FR-FCFS preferences for row hits, the rank of the
+     * previous burst and the earliest banks, and lastly by age.
+     *
+     * @param queue Queued requests to consider
+     * @param index Per-bank view of the queue
+     * @param switched_cmd_type Command type is changing
+     */
+    void reorderQueueByMaster(std::deque<DRAMPacket*>& queue,
+                              const QueueIndex& index,
+                              bool switched_cmd_type);
+
+    /**
+     * Priority class of a master for the master-aware policies, lower
+     * is more important. For BLISS this is whether the master is
+     * blacklisted, and for ATLAS its attained service.
+     *
+     * @param master_id The master to look up
+     * @return Priority of the master
+     */
+    double masterPriority(MasterID master_id) const;
+
+    /**
+     * Account for a burst served on behalf of a master, feeding the
+     * BLISS blacklist and the ATLAS attained service.
+     *
+     * @param dram_pkt The packet that was just scheduled
+     */
+    void updateMasterService(const DRAMPacket* dram_pkt);
+
+    /**
+     * Called at the end of every scheduling quantum to clear the BLISS
+     * blacklist, or to fold the service of the quantum into the ATLAS
+     * attained service.
+     */
+    void endSchedQuantum();
 
     /**
      * Find which are the earliest banks ready to issue an activate
      * for the enqueued requests. Assumes maximum of 64 banks per DIMM
      * Also checks if the bank is already prepped.
      *
-     * @param queue Queued requests to consider
+     * @param index Per-bank view of the queued requests to consider
      * @param switched_cmd_type Command type is changing
      * @return One-hot encoded mask of bank indices
      */
-    uint64_t minBankPrep(const std::deque<DRAMPacket*>& queue,
+    uint64_t minBankPrep(const QueueIndex& index,
                          bool switched_cmd_type) const;
 
     /**
@@ -435,6 +564,12 @@ class DRAMCtrl : public AbstractMemory
     std::deque<DRAMPacket*> readQueue;
     std::deque<DRAMPacket*> writeQueue;
 
+    /**
+     * Per-bank views of the read and write queues
+     */
+    QueueIndex readIndex;
+    QueueIndex writeIndex;
+
     /**
      * Response queue where read packets wait after we're done working
      * with them, but it's not time to send the response yet. The
@@ -513,6 +648,24 @@ class DRAMCtrl : public AbstractMemory
      * values.
      */
     Enums::MemSched memSchedPolicy;
+
+    /**
+     * State of the master-aware scheduling policies. BLISS counts
+     * the consecutive bursts served for the same master and
+     * blacklists a master that exceeds the threshold until the end
+     * of the quantum. ATLAS keeps an exponentially weighted history
+     * of the service attained by each master over past quanta.
+     */
+    const uint32_t blissThreshold;
+    const Tick schedQuantum;
+    const double atlasHistoryWeight;
+    Tick nextQuantumAt;
+    MasterID lastServedMaster;
+    uint32_t servedStreak;
+    std::vector<bool> blacklisted;
+    std::vector<double> attainedService;
+    std::vector<double> quantumService;
+
     Enums::AddrMap addrMapping;
     Enums::PageManage pageMgmt;
 
@@ -713,6 +866,12 @@ class DRAMCtrl : public AbstractMemory
     // One DRAMPower instance per rank
     std::vector<DRAMPower> rankPower;
 
+    /**
+     * Minimum number of logged commands before they are handed to
+     * DRAMPower at a refresh
+     */
+    const uint32_t powerBatchSize;
+
     /**
       * This function increments the energy when called. If stats are
       * dumped periodically, note accumulated energy values will
@@ -725,16 +884,10 @@ class DRAMCtrl : public AbstractMemory
     void updatePowerStats(uint8_t rank);
 
     /**
-     * Function for sorting commands in the command list of DRAMPower.
-     *
-     * @param a Memory Command in command list of DRAMPower library
-     * @param next Memory Command in command list of DRAMPower
-     * @return true if timestamp of Command 1 < timestamp of Command 2
+     * Update the power stats of all ranks, called when the stats are
+     * dumped.
      */
-    static bool sortTime(const Data::MemCommand& m1,
-                         const Data::MemCommand& m2) {
-        return m1.getTime() < m2.getTime();
-    };
+    void updatePowerStats();
 
 
   public:
@@ -37,6 +37,8 @@
  * Authors: Omar Naji
  */
 
+#include <algorithm>
+
 #include "base/intmath.hh"
 #include "mem/drampower.hh"
 #include "sim/core.hh"
@@ -44,8 +46,56 @@
 using namespace Data;
 
 DRAMPower::DRAMPower(const DRAMCtrlParams* p, bool include_io) :
-    powerlib(libDRAMPower(getMemSpec(p), include_io))
+    energyStale(false), powerlib(libDRAMPower(getMemSpec(p), include_io))
+{
+}
+
+void
+DRAMPower::flushCommands(int64_t until)
+{
+    if (cmdLog.empty())
+        return;
+
+    // the commands are logged mostly in order, only commands issued
+    // ahead of time (e.g. precharges) end up out of place, so only
+    // sort if we have to, and keep commands with the same timestamp
+    // in the order they were issued
+    if (!std::is_sorted(cmdLog.begin(), cmdLog.end()))
+        std::stable_sort(cmdLog.begin(), cmdLog.end());
+
+    auto end = cmdLog.end();
+    if (until != INT64_MAX)
+        end = std::lower_bound(cmdLog.begin(), cmdLog.end(),
+                               Command(MemCommand::NOP, 0, until));
+
+    if (end == cmdLog.begin())
+        return;
+
+    assert(powerlib.cmdList.empty());
+    powerlib.cmdList.reserve(end - cmdLog.begin());
+    for (auto c = cmdLog.begin(); c != end; ++c)
+        powerlib.cmdList.emplace_back(MemCommand::cmds(c->type), c->bank,
+                                      c->time);
+    cmdLog.erase(cmdLog.begin(), end);
+
+    // update the counters for DRAMPower, passing false to indicate
+    // that this is not the last command in the list. DRAMPower
+    // requires this information for the correct calculation of the
+    // background energy at the end of the simulation. Ideally we
+    // would want to call this function with true once at the end of
+    // the simulation. However, the discarded energy is extremly small
+    // and does not effect the final results.
+    powerlib.updateCounters(false);
+    energyStale = true;
+}
+
+void
+DRAMPower::calcEnergy()
 {
+    if (energyStale) {
+        powerlib.calcEnergy();
+        energyStale = false;
+    }
 }
 
 Data::MemArchitectureSpec
@@ -45,18 +45,51 @@
 #ifndef __MEM_DRAM_POWER_HH__
 #define __MEM_DRAM_POWER_HH__
 
+#include <cstdint>
+#include <vector>
+
 #include "libdrampower/LibDRAMPower.h"
 #include "params/DRAMCtrl.hh"
 
 /**
  * DRAMPower is a standalone tool which calculates the power consumed by a
  * DRAM in the system. This class wraps the DRAMPower library.
+ *
+ * Commands are appended to a compact log, and only handed to the
+ * library in batches, at which point the command counters of the
+ * library are updated incrementally. The energy itself is only
+ * calculated when it is actually needed, i.e. when the stats are
+ * dumped.
  */
 class DRAMPower
 {
 
  private:
 
+    /**
+     * A logged command, kept as small as possible since there is
+     * one for every burst, activate and precharge.
+     */
+    struct Command
+    {
+        int64_t time;
+        uint8_t type;
+        uint8_t bank;
+
+        Command(Data::MemCommand::cmds _type, uint8_t _bank, int64_t _time)
+            : time(_time), type(_type), bank(_bank)
+        { }
+
+        bool operator<(const Command& other) const
+        { return time < other.time; }
+    };
+
+    /** Commands not yet passed to the library, in issue order */
+    std::vector<Command> cmdLog;
+
+    /** Have the counters changed since the energy was last calculated */
+    bool energyStale;
+
     /**
      * Transform the architechture parameters defined in
      * DRAMCtrlParams to the memSpec of DRAMPower
@@ -97,6 +130,39 @@ class DRAMPower
 
     DRAMPower(const DRAMCtrlParams* p, bool include_io);
 
+    /**
+     * Log a command for the power calculation.
+     *
+     * @param type Command type
+     * @param bank Bank the command targets
+     * @param timestamp Time of the command in DRAM clock cycles
+     */
+    void doCommand(Data::MemCommand::cmds type, uint8_t bank,
+                   int64_t timestamp)
+    { cmdLog.emplace_back(type, bank, timestamp); }
+
+    /**
+     * Number of commands logged but not yet passed to the library.
+     */
+    size_t pendingCommands() const { return cmdLog.size(); }
+
+    /**
+     * Pass the logged commands before a given time to the library in
+     * timestamp order, and update its command counters. Commands at
+     * or after the given time are kept in the log, as commands issued
+     * later may still precede them.
+     *
+     * @param until Time in DRAM clock cycles, exclusive
+     */
+    void flushCommands(int64_t until = INT64_MAX);
+
+    /**
+     * Calculate the energy based on the commands flushed so far, if
+     * anything changed since the last calculation. The results are
+     * available through powerlib.getEnergy() and powerlib.getPower().
+     */
+    void calcEnergy();
+
 };
 
 #endif //__MEM_DRAM_POWER_HH__
@@ -199,6 +199,17 @@ PhysicalMemory::isMemAddr(Addr addr) const
     return true;
 }
 
+uint8_t *
+PhysicalMemory::toHostAddr(Addr addr, AbstractMemory *&mem) const
+{
+    AddrRangeMap<AbstractMemory*>::const_iterator m = addrMap.find(addr);
+    if (m == addrMap.end())
+        return NULL;
+
+    mem = m->second;
+    return mem->toHostAddr(addr);
+}
+
 AddrRangeList
 PhysicalMemory::getConfAddrRanges() const
 {
@@ -165,6 +165,19 @@ class PhysicalMemory : public Serializable
     std::vector<std::pair<AddrRange, uint8_t*> > getBackingStore() const
     { return backingStore; }
 
+    /**
+     * Get the host address backing a physical address, for CPU models
+     * that access memory directly rather than with packets. Accesses
+     * made this way bypass the stats and locked-address tracking of
+     * the memory, so the caller has to check hasLockedAddrs() on the
+     * returned memory before writing.
+     *
+     * @param addr A physical address
+     * @param mem Set to the memory the address maps to
+     * @return Host pointer, or NULL if the address is not in memory
+     */
+    uint8_t *toHostAddr(Addr addr, AbstractMemory *&mem) const;
+
     /**
      * Perform an untimed memory access and update all the state
      * (e.g. locked addresses) and statistics accordingly. The packet
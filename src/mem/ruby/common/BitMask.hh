@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_COMMON_BITMASK_HH__
+#define __MEM_RUBY_COMMON_BITMASK_HH__
+
+#include <cassert>
+#include <cstring>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+
+/**
+ * A bit mask of run-time size whose words are stored inline for up
+ * to InlineBits bits, so that copying one does not allocate. Larger
+ * masks fall back to heap storage. All operations work a word at a
+ * time, and the bits above the size are always zero.
+ */
+template <int InlineBits>
+class BitMask
+{
+  public:
+    BitMask()
+        : m_size(0), m_num_words(0), m_words(m_inline)
+    {
+    }
+
+    explicit BitMask(int size)
+        : m_size(0), m_num_words(0), m_words(m_inline)
+    {
+        setSize(size);
+    }
+
+    BitMask(const BitMask &other)
+        : m_size(0), m_num_words(0), m_words(m_inline)
+    {
+        *this = other;
+    }
+
+    ~BitMask()
+    {
+        if (m_words != m_inline)
+            delete [] m_words;
+    }
+
+    BitMask &
+    operator=(const BitMask &other)
+    {
+        if (this != &other) {
+            if (m_size != other.m_size)
+                setSize(other.m_size);
+            memcpy(m_words, other.m_words, m_num_words * sizeof(uint64_t));
+        }
+        return *this;
+    }
+
+    //! Resize the mask and clear all of its bits
+    void
+    setSize(int size)
+    {
+        if (m_words != m_inline)
+            delete [] m_words;
+
+        m_size = size;
+        m_num_words = (size + WordBits - 1) / WordBits;
+        m_words = m_num_words <= InlineWords ?
+            m_inline : new uint64_t[m_num_words];
+        clearAll();
+    }
+
+    int getSize() const { return m_size; }
+
+    void
+    set(int index)
+    {
+        assert(index < m_size);
+        m_words[index / WordBits] |= bit(index);
+    }
+
+    void
+    clear(int index)
+    {
+        assert(index < m_size);
+        m_words[index / WordBits] &= ~bit(index);
+    }
+
+    bool
+    test(int index) const
+    {
+        assert(index < m_size);
+        return (m_words[index / WordBits] & bit(index)) != 0;
+    }
+
+    //! Set the bits in [first, first + count)
+    void
+    setRange(int first, int count)
+    {
+        for (int i = first; i < first + count; i++)
+            set(i);
+    }
+
+    void
+    clearAll()
+    {
+        memset(m_words, 0, m_num_words * sizeof(uint64_t));
+    }
+
+    void
+    setAll()
+    {
+        memset(m_words, 0xff, m_num_words * sizeof(uint64_t));
+        if (m_size % WordBits != 0)
+            m_words[m_num_words - 1] = mask(m_size % WordBits);
+    }
+
+    int
+    count() const
+    {
+        int counter = 0;
+        for (int i = 0; i < m_num_words; i++)
+            counter += popCount(m_words[i]);
+        return counter;
+    }
+
+    bool
+    none() const
+    {
+        for (int i = 0; i < m_num_words; i++)
+            if (m_words[i] != 0)
+                return false;
+        return true;
+    }
+
+    bool
+    all() const
+    {
+        for (int i = 0; i < m_num_words; i++) {
+            uint64_t full = (i == m_num_words - 1 && m_size % WordBits) ?
+                mask(m_size % WordBits) : ~(uint64_t)0;
+            if (m_words[i] != full)
+                return false;
+        }
+        return true;
+    }
+
+    //! First set bit at or after index, or the size if there is none
+    int
+    findNext(int index) const
+    {
+        int word = index / WordBits;
+        if (word >= m_num_words)
+            return m_size;
+
+        uint64_t bits = m_words[word] & (~(uint64_t)0 << (index % WordBits));
+        while (bits == 0) {
+            if (++word >= m_num_words)
+                return m_size;
+            bits = m_words[word];
+        }
+        return word * WordBits + findLsbSet(bits);
+    }
+
+    void
+    orWith(const BitMask &other)
+    {
+        assert(m_size == other.m_size);
+        for (int i = 0; i < m_num_words; i++)
+            m_words[i] |= other.m_words[i];
+    }
+
+    void
+    andWith(const BitMask &other)
+    {
+        assert(m_size == other.m_size);
+        for (int i = 0; i < m_num_words; i++)
+            m_words[i] &= other.m_words[i];
+    }
+
+    //! Clear the bits that are set in other
+    void
+    andNotWith(const BitMask &other)
+    {
+        assert(m_size == other.m_size);
+        for (int i = 0; i < m_num_words; i++)
+            m_words[i] &= ~other.m_words[i];
+    }
+
+    bool
+    intersects(const BitMask &other) const
+    {
+        assert(m_size == other.m_size);
+        for (int i = 0; i < m_num_words; i++)
+            if (m_words[i] & other.m_words[i])
+                return true;
+        return false;
+    }
+
+    bool
+    isSuperset(const BitMask &test) const
+    {
+        assert(m_size == test.m_size);
+        for (int i = 0; i < m_num_words; i++)
+            if (test.m_words[i] & ~m_words[i])
+                return false;
+        return true;
+    }
+
+    bool
+    operator==(const BitMask &other) const
+    {
+        assert(m_size == other.m_size);
+        return memcmp(m_words, other.m_words,
+                      m_num_words * sizeof(uint64_t)) == 0;
+    }
+
+    int getNumWords() const { return m_num_words; }
+    uint64_t getWord(int i) const { return m_words[i]; }
+
+  private:
+    static const int WordBits = 64;
+    static const int InlineWords = (InlineBits + WordBits - 1) / WordBits;
+
+    static uint64_t
+    bit(int index)
+    {
+        return (uint64_t)1 << (index % WordBits);
+    }
+
+    int m_size;
+    int m_num_words;
+    uint64_t *m_words;
+    uint64_t m_inline[InlineWords];
+};
+
+#endif // __MEM_RUBY_COMMON_BITMASK_HH__
@@ -54,7 +54,9 @@ class Consumer
 
     virtual void wakeup() = 0;
     virtual void print(std::ostream& out) const = 0;
-    virtual void storeEventInfo(int info) {}
+    //! Called on every enqueue with the incoming link and the virtual
+    //! network of the buffer the message was enqueued into
+    virtual void storeEventInfo(int link_id, int vnet) {}
 
     bool
     alreadyScheduled(Tick time)
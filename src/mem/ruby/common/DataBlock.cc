@@ -26,22 +26,43 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <utility>
+
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/system/System.hh"
 
 DataBlock::DataBlock(const DataBlock &cp)
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
+    alloc();
     memcpy(m_data, cp.m_data, RubySystem::getBlockSizeBytes());
-    m_alloc = true;
+}
+
+DataBlock::DataBlock(DataBlock &&mv)
+{
+    if (mv.m_alloc) {
+        m_data = mv.m_data;
+        m_alloc = true;
+        mv.m_data = NULL;
+        mv.m_alloc = false;
+    } else {
+        // Inline data has to be copied, and a block assigned from the
+        // backing store gets a private copy just as with the copy
+        // constructor
+        alloc();
+        memcpy(m_data, mv.m_data, RubySystem::getBlockSizeBytes());
+    }
 }
 
 void
 DataBlock::alloc()
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
-    m_alloc = true;
-    clear();
+    if (RubySystem::getBlockSizeBytes() <= DATABLOCK_INLINE_BYTES) {
+        m_data = (uint8_t *)m_inline;
+        m_alloc = false;
+    } else {
+        m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
+        m_alloc = true;
+    }
 }
 
 void
@@ -87,6 +108,23 @@ DataBlock::setData(uint8_t *data, int offset, int len)
 DataBlock &
 DataBlock::operator=(const DataBlock & obj)
 {
+    if (m_data == NULL)
+        alloc();
     memcpy(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
     return *this;
 }
+
+DataBlock &
+DataBlock::operator=(DataBlock && obj)
+{
+    // Heap storage can be swapped unless this block is assigned from
+    // the backing store, which has to see the new data
+    if (obj.m_alloc && (m_alloc || m_data == NULL)) {
+        std::swap(m_data, obj.m_data);
+        m_alloc = true;
+        obj.m_alloc = (obj.m_data != NULL);
+        return *this;
+    }
+
+    return operator=((const DataBlock &)obj);
+}
@@ -35,15 +35,24 @@
 #include <iomanip>
 #include <iostream>
 
+/*
+ * Blocks of up to this many bytes are stored inside the DataBlock
+ * itself. Larger blocks are allocated on the heap, and are moved
+ * rather than copied when the source is a temporary.
+ */
+const int DATABLOCK_INLINE_BYTES = 64;
+
 class DataBlock
 {
   public:
     DataBlock()
     {
         alloc();
+        clear();
     }
 
     DataBlock(const DataBlock &cp);
+    DataBlock(DataBlock &&mv);
 
     ~DataBlock()
     {
@@ -52,6 +61,7 @@ class DataBlock
     }
 
     DataBlock& operator=(const DataBlock& obj);
+    DataBlock& operator=(DataBlock&& obj);
 
     void assign(uint8_t *data);
 
@@ -66,8 +76,14 @@ class DataBlock
 
   private:
     void alloc();
+
+    // Points at m_inline, at heap storage owned by this block
+    // (m_alloc), or at storage assigned from elsewhere. It is NULL in
+    // a block that has been moved from, which may only be assigned to
+    // or destroyed.
     uint8_t *m_data;
     bool m_alloc;
+    uint64_t m_inline[DATABLOCK_INLINE_BYTES / sizeof(uint64_t)];
 };
 
 inline void
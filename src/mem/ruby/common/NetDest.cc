@@ -28,6 +28,7 @@
 
 #include <algorithm>
 
+#include "base/misc.hh"
 #include "mem/ruby/common/NetDest.hh"
 
 NetDest::NetDest()
@@ -38,67 +39,60 @@ NetDest::NetDest()
 void
 NetDest::add(MachineID newElement)
 {
-    assert(bitIndex(newElement.num) < m_bits[vecIndex(newElement)].getSize());
-    m_bits[vecIndex(newElement)].add(bitIndex(newElement.num));
+    m_bits.set(bitIndex(newElement));
 }
 
 void
 NetDest::addNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].addSet(netDest.m_bits[i]);
-    }
+    m_bits.orWith(netDest.m_bits);
 }
 
 void
 NetDest::setNetDest(MachineType machine, const Set& set)
 {
-    // assure that there is only one set of destinations for this machine
-    assert(MachineType_base_level((MachineType)(machine + 1)) -
-           MachineType_base_level(machine) == 1);
-    m_bits[MachineType_base_level(machine)] = set;
+    int base = MachineType_base_number(machine);
+    int size = MachineType_base_count(machine);
+    assert(set.getSize() == size);
+
+    for (int i = 0; i < size; i++) {
+        if (set.isElement(i)) {
+            m_bits.set(base + i);
+        } else {
+            m_bits.clear(base + i);
+        }
+    }
 }
 
 void
 NetDest::remove(MachineID oldElement)
 {
-    m_bits[vecIndex(oldElement)].remove(bitIndex(oldElement.num));
+    m_bits.clear(bitIndex(oldElement));
 }
 
 void
 NetDest::removeNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].removeSet(netDest.m_bits[i]);
-    }
+    m_bits.andNotWith(netDest.m_bits);
 }
 
 void
 NetDest::clear()
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].clear();
-    }
+    m_bits.clearAll();
 }
 
 void
 NetDest::broadcast()
 {
-    for (MachineType machine = MachineType_FIRST;
-         machine < MachineType_NUM; ++machine) {
-        broadcast(machine);
-    }
+    m_bits.setAll();
 }
 
 void
 NetDest::broadcast(MachineType machineType)
 {
-    for (NodeID i = 0; i < MachineType_base_count(machineType); i++) {
-        MachineID mach = {machineType, i};
-        add(mach);
-    }
+    m_bits.setRange(MachineType_base_number(machineType),
+                    MachineType_base_count(machineType));
 }
 
 //For Princeton Network
@@ -106,14 +100,9 @@ std::vector<NodeID>
 NetDest::getAllDest()
 {
     std::vector<NodeID> dest;
-    dest.clear();
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                int id = MachineType_base_number((MachineType)i) + j;
-                dest.push_back((NodeID)id);
-            }
-        }
+    for (int i = m_bits.findNext(0); i < m_bits.getSize();
+         i = m_bits.findNext(i + 1)) {
+        dest.push_back((NodeID)i);
     }
     return dest;
 }
@@ -121,81 +110,70 @@ NetDest::getAllDest()
 int
 NetDest::count() const
 {
-    int counter = 0;
-    for (int i = 0; i < m_bits.size(); i++) {
-        counter += m_bits[i].count();
-    }
-    return counter;
+    return m_bits.count();
 }
 
 NodeID
 NetDest::elementAt(MachineID index)
 {
-    return m_bits[vecIndex(index)].elementAt(bitIndex(index.num));
+    return isElement(index) ? (NodeID)true : 0;
 }
 
 MachineID
-NetDest::smallestElement() const
+NetDest::machineAt(int index)
 {
-    assert(count() > 0);
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (NodeID j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
+    for (MachineType machine = MachineType_FIRST;
+         machine < MachineType_NUM; ++machine) {
+        int base = MachineType_base_number(machine);
+        if (index < base + MachineType_base_count(machine)) {
+            MachineID mach = {machine, (NodeID)(index - base)};
+            return mach;
         }
     }
-    panic("No smallest element of an empty set.");
+    panic("No machine has NetDest index %d.", index);
+}
+
+MachineID
+NetDest::smallestElement() const
+{
+    int index = m_bits.findNext(0);
+    if (index >= m_bits.getSize())
+        panic("No smallest element of an empty set.");
+    return machineAt(index);
 }
 
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
-    for (NodeID j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
-            MachineID mach = {machine, j};
-            return mach;
-        }
-    }
+    int base = MachineType_base_number(machine);
+    int index = m_bits.findNext(base);
+    if (index >= base + MachineType_base_count(machine))
+        panic("No smallest element of given MachineType.");
 
-    panic("No smallest element of given MachineType.");
+    MachineID mach = {machine, (NodeID)(index - base)};
+    return mach;
 }
 
 // Returns true iff all bits are set
 bool
 NetDest::isBroadcast() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isBroadcast()) {
-            return false;
-        }
-    }
-    return true;
+    return m_bits.all();
 }
 
 // Returns true iff no bits are set
 bool
 NetDest::isEmpty() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isEmpty()) {
-            return false;
-        }
-    }
-    return true;
+    return m_bits.none();
 }
 
 // returns the logical OR of "this" set and orNetDest
 NetDest
 NetDest::OR(const NetDest& orNetDest) const
 {
-    assert(m_bits.size() == orNetDest.getSize());
-    NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].OR(orNetDest.m_bits[i]);
-    }
+    NetDest result(*this);
+    result.m_bits.orWith(orNetDest.m_bits);
     return result;
 }
 
@@ -203,11 +181,8 @@ NetDest::OR(const NetDest& orNetDest) const
 NetDest
 NetDest::AND(const NetDest& andNetDest) const
 {
-    assert(m_bits.size() == andNetDest.getSize());
-    NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].AND(andNetDest.m_bits[i]);
-    }
+    NetDest result(*this);
+    result.m_bits.andWith(andNetDest.m_bits);
     return result;
 }
 
@@ -215,53 +190,44 @@ NetDest::AND(const NetDest& andNetDest) const
 bool
 NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == other_netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].intersectionIsEmpty(other_netDest.m_bits[i])) {
-            return true;
-        }
-    }
-    return false;
+    return m_bits.intersects(other_netDest.m_bits);
 }
 
+// Returns true if the intersection of the two sets is empty
 bool
-NetDest::isSuperset(const NetDest& test) const
+NetDest::intersectionIsEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == test.getSize());
+    return !m_bits.intersects(other_netDest.m_bits);
+}
 
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isSuperset(test.m_bits[i])) {
-            return false;
-        }
-    }
-    return true;
+bool
+NetDest::isSuperset(const NetDest& test) const
+{
+    return m_bits.isSuperset(test.m_bits);
 }
 
 bool
 NetDest::isElement(MachineID element) const
 {
-    return ((m_bits[vecIndex(element)])).isElement(bitIndex(element.num));
+    return m_bits.test(bitIndex(element));
 }
 
 void
 NetDest::resize()
 {
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
-
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].setSize(MachineType_base_count((MachineType)i));
-    }
+    m_bits.setSize(MachineType_base_number(MachineType_NUM));
 }
 
 void
 NetDest::print(std::ostream& out) const
 {
-    out << "[NetDest (" << m_bits.size() << ") ";
+    out << "[NetDest (" << MachineType_NUM << ") ";
 
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            out << (bool) m_bits[i].isElement(j) << " ";
+    for (MachineType machine = MachineType_FIRST;
+         machine < MachineType_NUM; ++machine) {
+        int base = MachineType_base_number(machine);
+        for (int j = 0; j < MachineType_base_count(machine); j++) {
+            out << (bool) m_bits.test(base + j) << " ";
         }
         out << " - ";
     }
@@ -271,10 +237,5 @@ NetDest::print(std::ostream& out) const
 bool
 NetDest::isEqual(const NetDest& n) const
 {
-    assert(m_bits.size() == n.m_bits.size());
-    for (unsigned int i = 0; i < m_bits.size(); ++i) {
-        if (!m_bits[i].isEqual(n.m_bits[i]))
-            return false;
-    }
-    return true;
+    return m_bits == n.m_bits;
 }
@@ -37,9 +37,18 @@
 #include <iostream>
 #include <vector>
 
+#include "mem/ruby/common/BitMask.hh"
 #include "mem/ruby/common/Set.hh"
 #include "mem/ruby/common/MachineID.hh"
 
+/*
+ * This defines the number of machines a NetDest holds without
+ * allocating memory, so that copying the destination of a message is
+ * cheap. Larger systems are still supported, but copying a NetDest
+ * then needs a heap allocation.
+ */
+const int NETDEST_INLINE_MACHINES = 512;
+
 class NetDest
 {
   public:
@@ -89,7 +98,7 @@ class NetDest
     MachineID smallestElement(MachineType machine) const;
 
     void resize();
-    int getSize() const { return m_bits.size(); }
+    int getSize() const { return m_bits.getSize(); }
 
     // get element for a index
     NodeID elementAt(MachineID index);
@@ -97,19 +106,19 @@ class NetDest
     void print(std::ostream& out) const;
 
   private:
-    // returns a value >= MachineType_base_level("this machine")
-    // and < MachineType_base_level("next highest machine")
+    // The machines of each type are numbered consecutively after the
+    // machines of the types before it, as in getAllDest()
     int
-    vecIndex(MachineID m) const
+    bitIndex(MachineID m) const
     {
-        int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
-        return vec_index;
+        assert((int)m.num < MachineType_base_count(m.type));
+        return MachineType_base_number(m.type) + m.num;
     }
 
-    NodeID bitIndex(NodeID index) const { return index; }
+    // The machine with the given bit index
+    static MachineID machineAt(int index);
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    BitMask<NETDEST_INLINE_MACHINES> m_bits; // one bit per machine
 };
 
 inline std::ostream&
@@ -26,87 +26,38 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-// modified by Dan Gibson on 05/20/05 to accomidate FASTER
-// >32 set lengths, using an array of ints w/ 32 bits/int
-
 #ifndef __MEM_RUBY_COMMON_SET_HH__
 #define __MEM_RUBY_COMMON_SET_HH__
 
 #include <iostream>
-#include <limits>
 
+#include "mem/ruby/common/BitMask.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
 /*
- * This defines the number of longs (32-bits on 32 bit machines,
- * 64-bit on 64-bit AMD machines) to use to hold the set...
- * the default is 4, allowing 128 or 256 different members
- * of the set.
- *
- * This should never need to be changed for correctness reasons,
- * though increasing it will increase performance for larger
- * set sizes at the cost of a (much) larger memory footprint
- *
+ * This defines the number of 64-bit words a set holds without
+ * allocating memory. Larger sets are still supported, but copying
+ * them needs a heap allocation.
  */
 const int NUMBER_WORDS_PER_SET = 1;
 
 class Set
 {
   private:
-    int m_nSize;              // the number of bits in this set
-    int m_nArrayLen;          // the number of 32-bit words that are
-                              // held in the array
-
-    // Changed 5/24/05 for static allocation of array
-    // note that "long" corresponds to 32 bits on a 32-bit machine,
-    // 64 bits if the -m64 parameter is passed to g++, which it is
-    // for an AMD opteron under our configuration
-
-    long *m_p_nArray;      // an word array to hold the bits in the set
-    long m_p_nArray_Static[NUMBER_WORDS_PER_SET];
-
-    static const int LONG_BITS = std::numeric_limits<long>::digits + 1;
-    static const int INDEX_SHIFT = LONG_BITS == 64 ? 6 : 5;
-    static const int INDEX_MASK = (1 << INDEX_SHIFT) - 1;
-
-    void clearExcess();
+    BitMask<NUMBER_WORDS_PER_SET * 64> m_bits;
 
   public:
-    Set();
-    Set(int size);
-    Set(const Set& obj);
-    ~Set();
-
-    Set& operator=(const Set& obj);
-
-    void
-    add(NodeID index)
-    {
-        m_p_nArray[index >> INDEX_SHIFT] |=
-            (((unsigned long) 1) << (index & INDEX_MASK));
-    }
-
-    void addSet(const Set& set);
-
-    void
-    remove(NodeID index)
-    {
-        m_p_nArray[index >> INDEX_SHIFT] &=
-            ~(((unsigned long)1) << (index & INDEX_MASK));
-    }
-
-    void removeSet(const Set& set);
-
-    void
-    clear()
-    {
-        for (int i = 0; i < m_nArrayLen; i++)
-            m_p_nArray[i] = 0;
-    }
-
-    void broadcast();
-    int count() const;
-    bool isEqual(const Set& set) const;
+    Set() {}
+    Set(int size) : m_bits(size > 0 ? size : 0) {}
+
+    void add(NodeID index) { m_bits.set(index); }
+    void addSet(const Set& set) { m_bits.orWith(set.m_bits); }
+    void remove(NodeID index) { m_bits.clear(index); }
+    void removeSet(const Set& set) { m_bits.andNotWith(set.m_bits); }
+    void clear() { m_bits.clearAll(); }
+    void broadcast() { m_bits.setAll(); }
+    int count() const { return m_bits.count(); }
+    bool isEqual(const Set& set) const { return m_bits == set.m_bits; }
 
     // return the logical OR of this set and orSet
     Set OR(const Set& orSet) const;
@@ -118,28 +69,24 @@ class Set
     bool
     intersectionIsEmpty(const Set& other_set) const
     {
-        for (int i = 0; i < m_nArrayLen; i++)
-            if (m_p_nArray[i] & other_set.m_p_nArray[i])
-                return false;
-        return true;
+        return !m_bits.intersects(other_set.m_bits);
     }
 
-    bool isSuperset(const Set& test) const;
-    bool isSubset(const Set& test) const { return test.isSuperset(*this); }
-
     bool
-    isElement(NodeID element) const
+    isSuperset(const Set& test) const
     {
-        return (m_p_nArray[element>>INDEX_SHIFT] &
-            (((unsigned long)1) << (element & INDEX_MASK))) != 0;
+        return m_bits.isSuperset(test.m_bits);
     }
 
-    bool isBroadcast() const;
-    bool isEmpty() const;
+    bool isSubset(const Set& test) const { return test.isSuperset(*this); }
+
+    bool isElement(NodeID element) const { return m_bits.test(element); }
+    bool isBroadcast() const { return m_bits.all(); }
+    bool isEmpty() const { return m_bits.none(); }
 
     NodeID smallestElement() const;
 
-    void setSize(int size);
+    void setSize(int size) { m_bits.setSize(size); }
 
     NodeID
     elementAt(int index) const
@@ -150,7 +97,7 @@ class Set
             return 0;
     }
 
-    int getSize() const { return m_nSize; }
+    int getSize() const { return m_bits.getSize(); }
 
     void print(std::ostream& out) const;
 };
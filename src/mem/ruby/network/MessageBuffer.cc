@@ -29,6 +29,7 @@
 #include <cassert>
 
 #include "base/cprintf.hh"
+#include "base/intmath.hh"
 #include "base/misc.hh"
 #include "base/random.hh"
 #include "base/stl_helpers.hh"
@@ -45,6 +46,7 @@ MessageBuffer::MessageBuffer(const string &name)
 {
     m_msg_counter = 0;
     m_consumer = NULL;
+    m_dequeue_waiter = NULL;
     m_sender = NULL;
     m_receiver = NULL;
 
@@ -145,6 +147,7 @@ void
 MessageBuffer::enqueue(MsgPtr message, Cycles delta)
 {
     m_msg_counter++;
+    message->markInflight();
 
     // record current time incase we have a pop that also adjusts my size
     if (m_time_last_time_enqueue < m_sender->curCycle()) {
@@ -217,7 +220,7 @@ MessageBuffer::enqueue(MsgPtr message, Cycles delta)
     // Schedule the wakeup
     assert(m_consumer != NULL);
     m_consumer->scheduleEventAbsolute(arrival_time);
-    m_consumer->storeEventInfo(m_vnet_id);
+    m_consumer->storeEventInfo(m_input_link_id, m_vnet_id);
 }
 
 Cycles
@@ -245,13 +248,42 @@ MessageBuffer::dequeue()
         greater<MessageBufferNode>());
     m_prio_heap.pop_back();
 
+    if (m_dequeue_waiter != NULL) {
+        // The sender sees the free slot from its next cycle on, see
+        // areNSlotsAvailable()
+        Tick when = m_sender->clockEdge();
+        if (when <= m_time_last_time_pop)
+            when = m_sender->clockEdge(Cycles(1));
+        m_dequeue_waiter->scheduleEventAbsolute(when);
+        m_dequeue_waiter = NULL;
+    }
+
     return delayCycles;
 }
 
+void
+MessageBuffer::wakeOnDequeue(Consumer* consumer)
+{
+    // Only the sender waits for free slots
+    assert(m_dequeue_waiter == NULL || m_dequeue_waiter == consumer);
+
+    if (m_time_last_time_pop >= m_sender->clockEdge()) {
+        // A message was dequeued this cycle already, but the sender
+        // only sees its slot from the next cycle on, see
+        // areNSlotsAvailable(). There may be no further dequeue to wait
+        // for.
+        consumer->scheduleEventAbsolute(m_sender->clockEdge(Cycles(1)));
+        return;
+    }
+
+    m_dequeue_waiter = consumer;
+}
+
 void
 MessageBuffer::clear()
 {
     m_prio_heap.clear();
+    m_recycle_times.clear();
 
     m_msg_counter = 0;
     m_time_last_time_enqueue = Cycles(0);
@@ -260,6 +292,11 @@ MessageBuffer::clear()
     m_msgs_this_cycle = 0;
 }
 
+// A recycled message is retried every m_recycle_latency cycles, but it
+// is handled the same way until the receiver changes state. Rather than
+// polling, the message waits at the back of the heap until the receiver
+// calls reanalyzeRecycledMessages(), and is then retried at the first
+// time after the transition that the polling would have retried it.
 void
 MessageBuffer::recycle()
 {
@@ -269,12 +306,44 @@ MessageBuffer::recycle()
     pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
         greater<MessageBufferNode>());
 
-    node.m_time = m_receiver->clockEdge(m_recycle_latency);
+    m_recycle_times[node.m_msgptr.get()] =
+        m_receiver->clockEdge(m_recycle_latency);
+    node.m_time = MaxTick;
     m_prio_heap.back() = node;
     push_heap(m_prio_heap.begin(), m_prio_heap.end(),
         greater<MessageBufferNode>());
-    m_consumer->
-        scheduleEventAbsolute(m_receiver->clockEdge(m_recycle_latency));
+}
+
+void
+MessageBuffer::reanalyzeRecycled()
+{
+    DPRINTF(RubyQueue, "ReanalyzeRecycled\n");
+    Tick now = m_receiver->clockEdge();
+    Tick period = m_receiver->clockPeriod() * m_recycle_latency;
+    Tick next = MaxTick;
+
+    for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
+        MessageBufferNode &node = m_prio_heap[i];
+        if (node.m_time != MaxTick)
+            continue;
+
+        map<const Message*, Tick>::iterator r =
+            m_recycle_times.find(node.m_msgptr.get());
+        assert(r != m_recycle_times.end());
+        // A retry due in the current cycle was made ahead of the
+        // messages arriving in it, and so ahead of the transition
+        // that got us here, and recycled the message once more
+        Tick when = r->second;
+        if (when <= now)
+            when += ((now - when) / period + 1) * period;
+        node.m_time = when;
+        next = min(next, when);
+    }
+    m_recycle_times.clear();
+
+    make_heap(m_prio_heap.begin(), m_prio_heap.end(),
+              greater<MessageBufferNode>());
+    m_consumer->scheduleEventAbsolute(next);
 }
 
 void
@@ -38,6 +38,7 @@
 #include <cassert>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -61,6 +62,19 @@ class MessageBuffer
     void reanalyzeAllMessages();
     void stallMessage(const Address& addr);
 
+    //! Retry the recycled messages, the receiver may handle them
+    //! differently now. See recycle().
+    void
+    reanalyzeRecycledMessages()
+    {
+        if (!m_recycle_times.empty())
+            reanalyzeRecycled();
+    }
+
+    //! Wake the consumer up once a message is dequeued. Senders call
+    //! this when they have to wait for a free slot.
+    void wakeOnDequeue(Consumer* consumer);
+
     // TRUE if head of queue timestamp <= SystemTime
     bool isReady() const;
 
@@ -156,6 +170,7 @@ class MessageBuffer
 
   private:
     void reanalyzeList(std::list<MsgPtr> &, Tick);
+    void reanalyzeRecycled();
 
   private:
     //added by SS
@@ -168,8 +183,15 @@ class MessageBuffer
 
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
+    //! Sender waiting for a free slot, can be NULL
+    Consumer* m_dequeue_waiter;
     std::vector<MessageBufferNode> m_prio_heap;
 
+    //! Recycled messages stay in the heap, but are not ready until they
+    //! are reanalyzed. This maps them to the time they would have been
+    //! retried.
+    std::map<const Message*, Tick> m_recycle_times;
+
     // use a std::map for the stalled messages as this container is
     // sorted and ensures a well-defined iteration order
     typedef std::map< Address, std::list<MsgPtr> > StallMsgMapType;
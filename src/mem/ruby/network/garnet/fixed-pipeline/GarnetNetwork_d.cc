@@ -28,6 +28,7 @@
  * Authors: Niket Agarwal
  */
 
+#include <algorithm>
 #include <cassert>
 
 #include "base/cast.hh"
@@ -39,6 +40,7 @@
 #include "mem/ruby/network/garnet/fixed-pipeline/GarnetNetwork_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/NetworkInterface_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/NetworkLink_d.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/RegionInbox_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/Router_d.hh"
 
 using namespace std;
@@ -83,6 +85,14 @@ GarnetNetwork_d::init()
         m_nis[i]->addNode(m_toNetQueues[i], m_fromNetQueues[i]);
     }
 
+    // Network interfaces are in region 0, an inbox is created for each
+    // region that links lead into
+    int num_regions = 1;
+    for (int i = 0; i < m_routers.size(); i++) {
+        num_regions = max(num_regions, m_routers[i]->get_region() + 1);
+    }
+    m_inboxes.resize(num_regions, NULL);
+
     // The topology pointer should have already been initialized in the
     // parent network constructor
     assert(m_topology_ptr != NULL);
@@ -112,6 +122,51 @@ GarnetNetwork_d::~GarnetNetwork_d()
     deletePointers(m_nis);
     deletePointers(m_links);
     deletePointers(m_creditlinks);
+    deletePointers(m_inboxes);
+}
+
+void
+GarnetNetwork_d::connectRegions(NetworkLink_d *link, ClockedObject *src,
+                                int src_region, ClockedObject *dest,
+                                int dest_region)
+{
+    // The source wakes the link up, so the link runs on its queue
+    link->setEventQueue(src->eventQueue());
+
+    fatal_if(src_region == dest_region &&
+             src->eventQueue() != dest->eventQueue(),
+             "%s and %s are both in region %d but have different "
+             "event queues\n", src->name(), dest->name(), src_region);
+
+    // Links within a region go through its inbox as well, so that
+    // flits are handed over in the same way however the routers are
+    // partitioned
+    link->setInbox(getInbox(dest_region, dest->eventQueue()));
+
+    if (src->eventQueue() != dest->eventQueue()) {
+        // The link latency is the lookahead between the two queues. A
+        // flit arriving exactly at a quantum boundary would be handed
+        // to the inbox only after its consumer had run for that tick,
+        // so the quantum has to be strictly shorter.
+        Tick lookahead = link->clockPeriod() * link->getLatency();
+        fatal_if(simQuantum == 0 || simQuantum >= lookahead,
+                 "%s connects two event queues, the simulation quantum "
+                 "must be non-zero and less than its latency of %d "
+                 "ticks\n", link->name(), lookahead);
+    }
+}
+
+RegionInbox_d *
+GarnetNetwork_d::getInbox(int region, EventQueue *eventq)
+{
+    if (m_inboxes[region] == NULL) {
+        m_inboxes[region] = new RegionInbox_d(eventq);
+    }
+
+    fatal_if(m_inboxes[region]->eventQueue() != eventq,
+             "Region %d of %s is split across event queues\n",
+             region, name());
+    return m_inboxes[region];
 }
 
 /*
@@ -137,6 +192,10 @@ GarnetNetwork_d::makeInLink(NodeID src, SwitchID dest, BasicLink* link,
 
     m_routers[dest]->addInPort(net_link, credit_link);
     m_nis[src]->addOutPort(net_link, credit_link);
+
+    int region = m_routers[dest]->get_region();
+    connectRegions(net_link, m_nis[src], 0, m_routers[dest], region);
+    connectRegions(credit_link, m_routers[dest], region, m_nis[src], 0);
 }
 
 /*
@@ -164,6 +223,10 @@ GarnetNetwork_d::makeOutLink(SwitchID src, NodeID dest, BasicLink* link,
     m_routers[src]->addOutPort(net_link, routing_table_entry,
                                          link->m_weight, credit_link);
     m_nis[dest]->addInPort(net_link, credit_link);
+
+    int region = m_routers[src]->get_region();
+    connectRegions(net_link, m_routers[src], region, m_nis[dest], 0);
+    connectRegions(credit_link, m_nis[dest], 0, m_routers[src], region);
 }
 
 /*
@@ -185,6 +248,13 @@ GarnetNetwork_d::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
     m_routers[dest]->addInPort(net_link, credit_link);
     m_routers[src]->addOutPort(net_link, routing_table_entry,
                                          link->m_weight, credit_link);
+
+    int src_region = m_routers[src]->get_region();
+    int dest_region = m_routers[dest]->get_region();
+    connectRegions(net_link, m_routers[src], src_region,
+                   m_routers[dest], dest_region);
+    connectRegions(credit_link, m_routers[dest], dest_region,
+                   m_routers[src], src_region);
 }
 
 void
@@ -315,5 +385,11 @@ GarnetNetwork_d::functionalWrite(Packet *pkt)
         num_functional_writes += m_links[i]->functionalWrite(pkt);
     }
 
+    for (unsigned int i = 0; i < m_inboxes.size(); ++i) {
+        if (m_inboxes[i] != NULL) {
+            num_functional_writes += m_inboxes[i]->functionalWrite(pkt);
+        }
+    }
+
     return num_functional_writes;
 }
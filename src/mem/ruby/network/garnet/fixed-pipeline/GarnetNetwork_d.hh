@@ -44,6 +44,7 @@ class Router_d;
 class NetDest;
 class NetworkLink_d;
 class CreditLink_d;
+class RegionInbox_d;
 
 class GarnetNetwork_d : public BaseGarnetNetwork
 {
@@ -90,6 +91,13 @@ class GarnetNetwork_d : public BaseGarnetNetwork
     GarnetNetwork_d(const GarnetNetwork_d& obj);
     GarnetNetwork_d& operator=(const GarnetNetwork_d& obj);
 
+    //! Set up a link between objects in the given regions, sending
+    //! its flits through an inbox if the regions differ.
+    void connectRegions(NetworkLink_d *link, ClockedObject *src,
+                        int src_region, ClockedObject *dest,
+                        int dest_region);
+    RegionInbox_d *getInbox(int region, EventQueue *eventq);
+
     void collateLinkStats();
     void collatePowerStats();
     void regLinkStats();
@@ -101,6 +109,7 @@ class GarnetNetwork_d : public BaseGarnetNetwork
     std::vector<NetworkLink_d *> m_links; // All links in the network
     std::vector<CreditLink_d *> m_creditlinks; // All links in net
     std::vector<NetworkInterface_d *> m_nis;   // All NI's in Network
+    std::vector<RegionInbox_d *> m_inboxes; // Inbox of each region
 
     int m_buffers_per_data_vc;
     int m_buffers_per_ctrl_vc;
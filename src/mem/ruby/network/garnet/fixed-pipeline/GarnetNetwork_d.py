@@ -42,6 +42,10 @@ class GarnetRouter_d(BasicRouter):
                               "virtual channels per virtual network")
     virt_nets = Param.UInt32(Parent.number_of_virtual_networks,
                           "number of virtual networks")
+    # Links between regions deliver through the inbox of the receiving
+    # region, so each region can run on its own event queue. Network
+    # interfaces are in region 0.
+    region = Param.UInt32(0, "network region the router belongs to")
 
 class GarnetNetworkInterface_d(ClockedObject):
     type = 'GarnetNetworkInterface_d'
@@ -28,6 +28,7 @@
  * Authors: Niket Agarwal
  */
 
+#include "base/bitfield.hh"
 #include "base/stl_helpers.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/InputUnit_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/Router_d.hh"
@@ -55,6 +56,9 @@ InputUnit_d::InputUnit_d(int id, Router_d *router) : Consumer(router)
     for (int i=0; i < m_num_vcs; i++) {
         m_vcs[i] = new VirtualChannel_d(i);
     }
+
+    m_active_vcs.resize((m_num_vcs + 63) / 64, 0);
+    m_num_active_vcs = 0;
 }
 
 InputUnit_d::~InputUnit_d()
@@ -95,6 +99,40 @@ InputUnit_d::wakeup()
     }
 }
 
+void
+InputUnit_d::set_vc_active(int vc, bool active)
+{
+    uint64_t mask = 1ULL << (vc % 64);
+    uint64_t &word = m_active_vcs[vc / 64];
+    if (active == ((word & mask) != 0))
+        return;
+
+    if (active) {
+        word |= mask;
+        m_num_active_vcs++;
+    } else {
+        word &= ~mask;
+        m_num_active_vcs--;
+    }
+}
+
+int
+InputUnit_d::next_active_vc(int vc) const
+{
+    int word = vc / 64;
+    if (word >= m_active_vcs.size())
+        return m_num_vcs;
+
+    // Mask off the vcs below the one we start from
+    uint64_t bits = m_active_vcs[word] & (~0ULL << (vc % 64));
+    while (bits == 0) {
+        if (++word >= m_active_vcs.size())
+            return m_num_vcs;
+        bits = m_active_vcs[word];
+    }
+    return word * 64 + findLsbSet(bits);
+}
+
 uint32_t
 InputUnit_d::functionalWrite(Packet *pkt)
 {
@@ -59,6 +59,7 @@ class InputUnit_d : public Consumer
     set_vc_state(VC_state_type state, int vc, Cycles curTime)
     {
         m_vcs[vc]->set_state(state, curTime);
+        set_vc_active(vc, state != IDLE_);
     }
 
     inline void
@@ -104,6 +105,7 @@ class InputUnit_d : public Consumer
     {
         m_vcs[vc]->set_outport(outport);
         m_vcs[vc]->set_state(VC_AB_, curTime);
+        set_vc_active(vc, true);
     }
 
     inline void
@@ -161,7 +163,16 @@ class InputUnit_d : public Consumer
 
     uint32_t functionalWrite(Packet *pkt);
 
+    //! Does any vc hold a packet that is being routed, allocated or
+    //! switched?
+    inline bool has_active_vcs() const { return m_num_active_vcs > 0; }
+    //! First non-idle vc at or after vc, or the number of vcs if
+    //! there is none.
+    int next_active_vc(int vc) const;
+
   private:
+    void set_vc_active(int vc, bool active);
+
     int m_id;
     int m_num_vcs;
     int m_vc_per_vnet;
@@ -174,6 +185,11 @@ class InputUnit_d : public Consumer
     // Virtual channels
     std::vector<VirtualChannel_d *> m_vcs;
 
+    // Bitmap of the non-idle virtual channels, so that the allocators
+    // only look at the ones with work to do
+    std::vector<uint64_t> m_active_vcs;
+    int m_num_active_vcs;
+
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
     std::vector<double> m_num_buffer_reads;
@@ -149,7 +149,11 @@ NetworkInterface_d::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         if (vc == -1) {
             return false ;
         }
-        MsgPtr new_msg_ptr = msg_ptr->clone();
+        // A unicast message is dequeued once it is flitisized, so the
+        // flits can carry the message itself rather than a copy
+        MsgPtr new_msg_ptr = msg_ptr;
+        if (dest_nodes.size() > 1)
+            new_msg_ptr = msg_ptr->clone();
         NodeID destID = dest_nodes[ctr];
 
         NetworkMessage *new_net_msg_ptr =
@@ -30,6 +30,7 @@
 
 #include "mem/ruby/network/garnet/fixed-pipeline/CreditLink_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/NetworkLink_d.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/RegionInbox_d.hh"
 
 NetworkLink_d::NetworkLink_d(const Params *p)
     : ClockedObject(p), Consumer(this)
@@ -38,6 +39,8 @@ NetworkLink_d::NetworkLink_d(const Params *p)
     channel_width = p->channel_width;
     m_id = p->link_id;
     linkBuffer = new flitBuffer_d();
+    m_inbox = NULL;
+    m_inbox_index = -1;
     m_link_utilized = 0;
     m_vc_load.resize(p->vcs_per_vnet * p->virt_nets);
 
@@ -63,19 +66,36 @@ NetworkLink_d::setSourceQueue(flitBuffer_d *srcQueue)
     link_srcQueue = srcQueue;
 }
 
+void
+NetworkLink_d::setInbox(RegionInbox_d *inbox)
+{
+    m_inbox = inbox;
+    m_inbox_index = inbox->registerLink(this);
+}
+
 void
 NetworkLink_d::wakeup()
 {
     if (link_srcQueue->isReady(curCycle())) {
         flit_d *t_flit = link_srcQueue->getTopFlit();
         t_flit->set_time(curCycle() + m_latency);
-        linkBuffer->insert(t_flit);
-        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
+
+        // The consumer may be in another region, so the link buffer is
+        // left to the inbox of its region
+        assert(m_inbox != NULL);
+        m_inbox->deliver(m_inbox_index, t_flit, clockEdge(m_latency));
     }
 }
 
+void
+NetworkLink_d::receiveFlit(flit_d *t_flit)
+{
+    linkBuffer->insert(t_flit);
+    link_consumer->scheduleEventAbsolute(curTick());
+}
+
 NetworkLink_d *
 NetworkLink_dParams::create()
 {
@@ -42,6 +42,7 @@
 #include "sim/clocked_object.hh"
 
 class GarnetNetwork_d;
+class RegionInbox_d;
 
 class NetworkLink_d : public ClockedObject, public Consumer
 {
@@ -52,8 +53,16 @@ class NetworkLink_d : public ClockedObject, public Consumer
 
     void setLinkConsumer(Consumer *consumer);
     void setSourceQueue(flitBuffer_d *srcQueue);
+    //! Run the link on the event queue of the router or network
+    //! interface that feeds it.
+    void setEventQueue(EventQueue *eq) { eventq = eq; }
+    //! Send flits through the inbox of the consumer's region.
+    void setInbox(RegionInbox_d *inbox);
+    //! Called by the inbox when a flit sent through it arrives.
+    void receiveFlit(flit_d *t_flit);
     void print(std::ostream& out) const{}
     int get_id(){return m_id;}
+    Cycles getLatency() const { return m_latency; }
     void wakeup();
 
     void calculate_power(double);
@@ -78,6 +87,8 @@ class NetworkLink_d : public ClockedObject, public Consumer
 
     flitBuffer_d *linkBuffer;
     Consumer *link_consumer;
+    RegionInbox_d *m_inbox;
+    int m_inbox_index;
     flitBuffer_d *link_srcQueue;
     int m_flit_width;
 
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include "mem/ruby/network/garnet/fixed-pipeline/NetworkLink_d.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/flit_d.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/RegionInbox_d.hh"
+
+using namespace std;
+
+RegionInbox_d::RegionInbox_d(EventQueue *eventq)
+    : m_eventq(eventq)
+{
+}
+
+int
+RegionInbox_d::registerLink(NetworkLink_d *link)
+{
+    m_links.push_back(link);
+    return m_links.size() - 1;
+}
+
+void
+RegionInbox_d::deliver(int link_index, flit_d *t_flit, Tick when)
+{
+    m_mutex.lock();
+
+    DeliveryList &deliveries = m_pending[when];
+    if (deliveries.empty()) {
+        // The event queue takes care of scheduling from another thread
+        m_eventq->schedule(new ReleaseEvent(this), when);
+    }
+    deliveries.push_back(make_pair(link_index, t_flit));
+
+    m_mutex.unlock();
+}
+
+void
+RegionInbox_d::release(Tick when)
+{
+    m_mutex.lock();
+
+    map<Tick, DeliveryList>::iterator it = m_pending.find(when);
+    assert(it != m_pending.end());
+    DeliveryList deliveries;
+    deliveries.swap(it->second);
+    m_pending.erase(it);
+
+    m_mutex.unlock();
+
+    // Links deliver at most one flit per tick, so sorting on the link
+    // index gives an order that does not depend on the other regions
+    sort(deliveries.begin(), deliveries.end());
+
+    for (int i = 0; i < deliveries.size(); i++) {
+        m_links[deliveries[i].first]->receiveFlit(deliveries[i].second);
+    }
+}
+
+uint32_t
+RegionInbox_d::functionalWrite(Packet *pkt)
+{
+    uint32_t num_functional_writes = 0;
+
+    m_mutex.lock();
+    for (map<Tick, DeliveryList>::iterator it = m_pending.begin();
+         it != m_pending.end(); ++it) {
+        for (int i = 0; i < it->second.size(); i++) {
+            if (it->second[i].second->functionalWrite(pkt)) {
+                num_functional_writes++;
+            }
+        }
+    }
+    m_mutex.unlock();
+
+    return num_functional_writes;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_REGION_INBOX_D_HH__
+#define __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_REGION_INBOX_D_HH__
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "mem/packet.hh"
+#include "sim/eventq.hh"
+
+class NetworkLink_d;
+class flit_d;
+
+/**
+ * The routers of a garnet network can be split into regions that are
+ * simulated on separate event queues. Flits are not written into the
+ * link buffer by the sending side. They are handed to the inbox of the
+ * receiving region, which releases them on its own event queue when
+ * they arrive. The link latency is the lookahead, so it must be longer
+ * than the simulation quantum: every flit then reaches the inbox before
+ * the tick it arrives in starts.
+ *
+ * Flits arriving in the same tick are released in the order the links
+ * were registered, and only then are their consumers woken up. Links
+ * within a region go through the inbox as well, so the order of the
+ * events of a region depends on nothing but the region itself, and a
+ * network gives the same results however it is partitioned, whether
+ * its regions share one event queue or run in parallel.
+ */
+class RegionInbox_d
+{
+  public:
+    RegionInbox_d(EventQueue *eventq);
+
+    EventQueue *eventQueue() const { return m_eventq; }
+
+    //! Register a link whose consumer is in this region, returning the
+    //! index the link passes to deliver().
+    int registerLink(NetworkLink_d *link);
+
+    //! Hand over a flit that arrives at the consumer of a link at the
+    //! given tick. May be called from the thread of another region.
+    void deliver(int link_index, flit_d *t_flit, Tick when);
+
+    //! Write the flits that have yet to arrive, returning the number
+    //! of messages written.
+    uint32_t functionalWrite(Packet *pkt);
+
+  private:
+    class ReleaseEvent : public Event
+    {
+      public:
+        ReleaseEvent(RegionInbox_d *inbox)
+            // Release flits before the consumers woken up in the
+            // same tick look at their links
+            : Event(Default_Pri - 1, AutoDelete), m_inbox(inbox)
+        {
+        }
+
+        void process() { m_inbox->release(when()); }
+        const char *description() const { return "garnet region inbox"; }
+
+      private:
+        RegionInbox_d *m_inbox;
+    };
+
+    void release(Tick when);
+
+    EventQueue *m_eventq;
+    std::vector<NetworkLink_d *> m_links;
+
+    typedef std::vector<std::pair<int, flit_d *> > DeliveryList;
+    //! Flits waiting to arrive, by arrival tick. Protected by m_mutex
+    //! since other regions add to it.
+    std::map<Tick, DeliveryList> m_pending;
+    std::mutex m_mutex;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_REGION_INBOX_D_HH__
@@ -71,6 +71,7 @@ class Router_d : public BasicRouter
     int get_num_inports()   { return m_input_unit.size(); }
     int get_num_outports()  { return m_output_unit.size(); }
     int get_id()            { return m_id; }
+    int get_region() const  { return m_region; }
 
     void init_net_ptr(GarnetNetwork_d* net_ptr) 
     { 
@@ -109,6 +110,7 @@ class Router_d : public BasicRouter
 
   private:
     int m_virtual_networks, m_num_vcs, m_vc_per_vnet;
+    int m_region;
     GarnetNetwork_d *m_network_ptr;
     double sw_local_arbit_count, sw_global_arbit_count;
     double crossbar_count;
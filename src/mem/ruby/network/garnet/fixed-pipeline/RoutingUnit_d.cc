@@ -65,7 +65,9 @@ RoutingUnit_d::RC_stage(flit_d *t_flit, InputUnit_d *in_unit, int invc)
 int
 RoutingUnit_d::routeCompute(flit_d *t_flit)
 {
-    MsgPtr msg_ptr = t_flit->get_msg_ptr();
+    // Don't take a reference, the network interface that owns the
+    // message may be running on another thread
+    const MsgPtr &msg_ptr = t_flit->get_msg_ptr();
     NetworkMessage* net_msg_ptr = safe_cast<NetworkMessage *>(msg_ptr.get());
     NetDest msg_destination = net_msg_ptr->getInternalDestination();
 
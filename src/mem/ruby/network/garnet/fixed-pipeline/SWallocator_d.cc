@@ -53,21 +53,16 @@ SWallocator_d::init()
 
     m_num_inports = m_router->get_num_inports();
     m_num_outports = m_router->get_num_outports();
-    m_round_robin_outport.resize(m_num_outports);
-    m_round_robin_inport.resize(m_num_inports);
+    m_round_robin_outport = 0;
+    m_round_robin_inport = 0;
     m_port_req.resize(m_num_outports);
+    m_outport_req.resize(m_num_outports, false);
     m_vc_winners.resize(m_num_outports);
 
-    for (int i = 0; i < m_num_inports; i++) {
-        m_round_robin_inport[i] = 0;
-    }
-
     for (int i = 0; i < m_num_outports; i++) {
         m_port_req[i].resize(m_num_inports);
         m_vc_winners[i].resize(m_num_inports);
 
-        m_round_robin_outport[i] = 0;
-
         for (int j = 0; j < m_num_inports; j++) {
             m_port_req[i][j] = false; // [outport][inport]
         }
@@ -88,45 +83,65 @@ SWallocator_d::wakeup()
 void
 SWallocator_d::arbitrate_inports()
 {
-    // First do round robin arbitration on a set of input vc requests
-    for (int inport = 0; inport < m_num_inports; inport++) {
-        int invc = m_round_robin_inport[inport];
+    // The round robin vc pointer moves on every cycle whether or not
+    // an inport has requests, so one pointer serves all of them
+    int start_invc = m_round_robin_inport;
 
-        // Select next round robin vc candidate within valid vnet
-        int next_round_robin_invc = invc;
-        do {
-            next_round_robin_invc++;
+    // Select next round robin vc candidate within valid vnet
+    do {
+        m_round_robin_inport++;
 
-            if (next_round_robin_invc >= m_num_vcs)
-                next_round_robin_invc = 0;
-        } while (!((m_router->get_net_ptr())->validVirtualNetwork(
-                    get_vnet(next_round_robin_invc))));
+        if (m_round_robin_inport >= m_num_vcs)
+            m_round_robin_inport = 0;
+    } while (!((m_router->get_net_ptr())->validVirtualNetwork(
+                get_vnet(m_round_robin_inport))));
 
-        m_round_robin_inport[inport] = next_round_robin_invc;
+    start_invc++;
+    if (start_invc >= m_num_vcs)
+        start_invc = 0;
 
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
-            invc++;
-            if (invc >= m_num_vcs)
-                invc = 0;
+    // First do round robin arbitration on a set of input vc requests,
+    // looking only at the vcs that are not idle
+    for (int inport = 0; inport < m_num_inports; inport++) {
+        InputUnit_d *in_unit = m_input_unit[inport];
+        if (!in_unit->has_active_vcs())
+            continue;
+
+        bool found = false;
+        for (int invc = in_unit->next_active_vc(start_invc);
+             !found && invc < m_num_vcs;
+             invc = in_unit->next_active_vc(invc + 1)) {
+            found = select_invc(inport, invc);
+        }
 
-            if (!((m_router->get_net_ptr())->validVirtualNetwork(
-                get_vnet(invc))))
-                continue;
+        for (int invc = in_unit->next_active_vc(0);
+             !found && invc < start_invc;
+             invc = in_unit->next_active_vc(invc + 1)) {
+            found = select_invc(inport, invc);
+        }
+    }
+}
 
-            if (m_input_unit[inport]->need_stage(invc, ACTIVE_, SA_,
-                                                 m_router->curCycle()) &&
-                m_input_unit[inport]->has_credits(invc)) {
-
-                if (is_candidate_inport(inport, invc)) {
-                    int outport = m_input_unit[inport]->get_route(invc);
-                    m_local_arbiter_activity++;
-                    m_port_req[outport][inport] = true;
-                    m_vc_winners[outport][inport]= invc;
-                    break; // got one vc winner for this port
-                }
-            }
+bool
+SWallocator_d::select_invc(int inport, int invc)
+{
+    if (!((m_router->get_net_ptr())->validVirtualNetwork(get_vnet(invc))))
+        return false;
+
+    if (m_input_unit[inport]->need_stage(invc, ACTIVE_, SA_,
+                                         m_router->curCycle()) &&
+        m_input_unit[inport]->has_credits(invc)) {
+
+        if (is_candidate_inport(inport, invc)) {
+            int outport = m_input_unit[inport]->get_route(invc);
+            m_local_arbiter_activity++;
+            m_port_req[outport][inport] = true;
+            m_outport_req[outport] = true;
+            m_vc_winners[outport][inport]= invc;
+            return true; // got one vc winner for this port
         }
     }
+    return false;
 }
 
 bool
@@ -157,14 +172,19 @@ void
 SWallocator_d::arbitrate_outports()
 {
     // Now there are a set of input vc requests for output vcs.
-    // Again do round robin arbitration on these requests
-    for (int outport = 0; outport < m_num_outports; outport++) {
-        int inport = m_round_robin_outport[outport];
-        m_round_robin_outport[outport]++;
+    // Again do round robin arbitration on these requests. As with the
+    // inports, the pointer moves every cycle and is shared.
+    int start_inport = m_round_robin_outport;
+    m_round_robin_outport++;
+
+    if (m_round_robin_outport >= m_num_outports)
+        m_round_robin_outport = 0;
 
-        if (m_round_robin_outport[outport] >= m_num_outports)
-            m_round_robin_outport[outport] = 0;
+    for (int outport = 0; outport < m_num_outports; outport++) {
+        if (!m_outport_req[outport])
+            continue;
 
+        int inport = start_inport;
         for (int inport_iter = 0; inport_iter < m_num_inports; inport_iter++) {
             inport++;
             if (inport >= m_num_inports)
@@ -221,7 +241,11 @@ SWallocator_d::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
+        if (!m_input_unit[i]->has_active_vcs())
+            continue;
+
+        for (int j = m_input_unit[i]->next_active_vc(0); j < m_num_vcs;
+             j = m_input_unit[i]->next_active_vc(j + 1)) {
             if (m_input_unit[i]->need_stage(j, ACTIVE_, SA_, nextCycle)) {
                 scheduleEvent(Cycles(1));
                 return;
@@ -242,6 +266,9 @@ void
 SWallocator_d::clear_request_vector()
 {
     for (int i = 0; i < m_num_outports; i++) {
+        if (!m_outport_req[i])
+            continue;
+        m_outport_req[i] = false;
         for (int j = 0; j < m_num_inports; j++) {
             m_port_req[i][j] = false;
         }
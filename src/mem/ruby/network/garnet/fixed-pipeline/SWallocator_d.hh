@@ -53,6 +53,7 @@ class SWallocator_d : public Consumer
     void print(std::ostream& out) const {};
     void arbitrate_inports();
     void arbitrate_outports();
+    bool select_invc(int inport, int invc);
     bool is_candidate_inport(int inport, int invc);
 
     inline double
@@ -73,9 +74,10 @@ class SWallocator_d : public Consumer
     double m_local_arbiter_activity, m_global_arbiter_activity;
 
     Router_d *m_router;
-    std::vector<int> m_round_robin_outport;
-    std::vector<int> m_round_robin_inport;
+    int m_round_robin_outport;
+    int m_round_robin_inport;
     std::vector<std::vector<bool> > m_port_req;
+    std::vector<bool> m_outport_req; // any inport requests this outport
     std::vector<std::vector<int> > m_vc_winners; // a list for each outport
     std::vector<InputUnit_d *> m_input_unit;
     std::vector<OutputUnit_d *> m_output_unit;
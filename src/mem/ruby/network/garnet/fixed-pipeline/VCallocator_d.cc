@@ -61,6 +61,7 @@ VCallocator_d::init()
     m_round_robin_outvc.resize(m_num_outports);
     m_outvc_req.resize(m_num_outports);
     m_outvc_is_req.resize(m_num_outports);
+    m_outport_is_req.resize(m_num_outports, false);
 
     for (int i = 0; i < m_num_inports; i++) {
         m_round_robin_invc[i].resize(m_num_vcs);
@@ -96,6 +97,9 @@ void
 VCallocator_d::clear_request_vector()
 {
     for (int i = 0; i < m_num_outports; i++) {
+        if (!m_outport_is_req[i])
+            continue;
+        m_outport_is_req[i] = false;
         for (int j = 0; j < m_num_vcs; j++) {
             if (!m_outvc_is_req[i][j])
                 continue;
@@ -169,6 +173,7 @@ VCallocator_d::select_outvc(int inport_iter, int invc_iter)
             m_outvc_req[outport][outvc][inport_iter][invc_iter] = true;
             if (!m_outvc_is_req[outport][outvc])
                 m_outvc_is_req[outport][outvc] = true;
+            m_outport_is_req[outport] = true;
             return; // out vc acquired
         }
     }
@@ -178,7 +183,14 @@ void
 VCallocator_d::arbitrate_invcs()
 {
     for (int inport_iter = 0; inport_iter < m_num_inports; inport_iter++) {
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
+        InputUnit_d *in_unit = m_input_unit[inport_iter];
+        if (!in_unit->has_active_vcs())
+            continue;
+
+        // Only vcs that are not idle can be waiting for an output vc
+        for (int invc_iter = in_unit->next_active_vc(0);
+             invc_iter < m_num_vcs;
+             invc_iter = in_unit->next_active_vc(invc_iter + 1)) {
             if (!((m_router->get_net_ptr())->validVirtualNetwork(
                 get_vnet(invc_iter))))
                 continue;
@@ -198,6 +210,11 @@ void
 VCallocator_d::arbitrate_outvcs()
 {
     for (int outport_iter = 0; outport_iter < m_num_outports; outport_iter++) {
+        if (!m_outport_is_req[outport_iter]) {
+            // No requests for any outvc of this outport in this cycle
+            continue;
+        }
+
         for (int outvc_iter = 0; outvc_iter < m_num_vcs; outvc_iter++) {
             if (!m_outvc_is_req[outport_iter][outvc_iter]) {
                 // No requests for this outvc in this cycle
@@ -259,7 +276,11 @@ VCallocator_d::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
+        if (!m_input_unit[i]->has_active_vcs())
+            continue;
+
+        for (int j = m_input_unit[i]->next_active_vc(0); j < m_num_vcs;
+             j = m_input_unit[i]->next_active_vc(j + 1)) {
             if (m_input_unit[i]->need_stage(j, VC_AB_, VA_, nextCycle)) {
                 scheduleEvent(Cycles(1));
                 return;
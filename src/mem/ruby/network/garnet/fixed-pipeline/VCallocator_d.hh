@@ -82,6 +82,8 @@ class VCallocator_d : public Consumer
     std::vector<std::vector<std::vector<std::vector<bool> > > > m_outvc_req;
 
     std::vector<std::vector<bool> > m_outvc_is_req;
+    // Set if any outvc of an outport has a request this cycle
+    std::vector<bool> m_outport_is_req;
 
     std::vector<InputUnit_d *> m_input_unit;
     std::vector<OutputUnit_d *> m_output_unit;
@@ -140,7 +140,11 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
             // did not find a free output vc
             return false ;
         }
-        MsgPtr new_msg_ptr = msg_ptr->clone();
+        // A unicast message is dequeued once it is flitisized, so the
+        // flits can carry the message itself rather than a copy
+        MsgPtr new_msg_ptr = msg_ptr;
+        if (dest_nodes.size() > 1)
+            new_msg_ptr = msg_ptr->clone();
         NodeID destID = dest_nodes[ctr];
 
         NetworkMessage *new_net_msg_ptr =
@@ -28,6 +28,7 @@
 
 #include <algorithm>
 
+#include "base/bitfield.hh"
 #include "base/cast.hh"
 #include "base/random.hh"
 #include "debug/RubyNetwork.hh"
@@ -55,6 +56,7 @@ PerfectSwitch::PerfectSwitch(SwitchID sid, Switch *sw, uint32_t virt_nets)
     m_round_robin_start = 0;
     m_wakeups_wo_switch = 0;
     m_virtual_networks = virt_nets;
+    m_active_in.resize(virt_nets);
 }
 
 void
@@ -73,6 +75,12 @@ PerfectSwitch::addInPort(const vector<MessageBuffer*>& in)
     NodeID port = m_in.size();
     m_in.push_back(in);
 
+    if (port % 64 == 0) {
+        for (int v = 0; v < m_virtual_networks; ++v) {
+            m_active_in[v].push_back(0);
+        }
+    }
+
     for (int i = 0; i < in.size(); ++i) {
         if (in[i] != nullptr) {
             in[i]->setConsumer(this);
@@ -111,9 +119,6 @@ PerfectSwitch::~PerfectSwitch()
 void
 PerfectSwitch::operateVnet(int vnet)
 {
-    MsgPtr msg_ptr;
-    NetworkMessage* net_msg_ptr = NULL;
-
     // This is for round-robin scheduling
     int incoming = m_round_robin_start;
     m_round_robin_start++;
@@ -122,162 +127,204 @@ PerfectSwitch::operateVnet(int vnet)
     }
 
     if(m_pending_message_count[vnet] > 0) {
-        // for all input ports, use round robin scheduling
-        for (int counter = 0; counter < m_in.size(); counter++) {
-            // Round robin scheduling
-            incoming++;
-            if (incoming >= m_in.size()) {
-                incoming = 0;
-            }
+        // Visit only the input ports with messages, in the same
+        // round-robin order as a walk over all of them
+        int start = incoming + 1;
+        if (start >= m_in.size()) {
+            start = 0;
+        }
 
-            // temporary vectors to store the routing results
-            vector<LinkID> output_links;
-            vector<NetDest> output_link_destinations;
+        for (incoming = nextActiveInPort(vnet, start);
+             incoming < m_in.size();
+             incoming = nextActiveInPort(vnet, incoming + 1)) {
+            operateMessageBuffer(incoming, vnet);
+        }
 
-            // Is there a message waiting?
-            if (m_in[incoming].size() <= vnet) {
-                continue;
-            }
+        for (incoming = nextActiveInPort(vnet, 0);
+             incoming < start;
+             incoming = nextActiveInPort(vnet, incoming + 1)) {
+            operateMessageBuffer(incoming, vnet);
+        }
+    }
+}
 
-            MessageBuffer *buffer = m_in[incoming][vnet];
-            if (buffer == nullptr) {
-                continue;
-            }
+int
+PerfectSwitch::nextActiveInPort(int vnet, int port) const
+{
+    const vector<uint64_t> &active = m_active_in[vnet];
+    int word = port / 64;
+    if (word >= active.size()) {
+        return m_in.size();
+    }
 
-            while (buffer->isReady()) {
-                DPRINTF(RubyNetwork, "incoming: %d\n", incoming);
-
-                // Peek at message
-                msg_ptr = buffer->peekMsgPtr();
-                net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
-                DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
-
-                output_links.clear();
-                output_link_destinations.clear();
-                NetDest msg_dsts = net_msg_ptr->getInternalDestination();
-
-                // Unfortunately, the token-protocol sends some
-                // zero-destination messages, so this assert isn't valid
-                // assert(msg_dsts.count() > 0);
-
-                assert(m_link_order.size() == m_routing_table.size());
-                assert(m_link_order.size() == m_out.size());
-
-                if (m_network_ptr->getAdaptiveRouting()) {
-                    if (m_network_ptr->isVNetOrdered(vnet)) {
-                        // Don't adaptively route
-                        for (int out = 0; out < m_out.size(); out++) {
-                            m_link_order[out].m_link = out;
-                            m_link_order[out].m_value = 0;
-                        }
-                    } else {
-                        // Find how clogged each link is
-                        for (int out = 0; out < m_out.size(); out++) {
-                            int out_queue_length = 0;
-                            for (int v = 0; v < m_virtual_networks; v++) {
-                                out_queue_length += m_out[out][v]->getSize();
-                            }
-                            int value =
-                                (out_queue_length << 8) |
-                                random_mt.random(0, 0xff);
-                            m_link_order[out].m_link = out;
-                            m_link_order[out].m_value = value;
-                        }
-
-                        // Look at the most empty link first
-                        sort(m_link_order.begin(), m_link_order.end());
-                    }
-                }
+    // Mask off the ports below the one we start from
+    uint64_t bits = active[word] & (~0ULL << (port % 64));
+    while (bits == 0) {
+        if (++word >= active.size()) {
+            return m_in.size();
+        }
+        bits = active[word];
+    }
+    return word * 64 + findLsbSet(bits);
+}
+
+void
+PerfectSwitch::operateMessageBuffer(int incoming, int vnet)
+{
+    MsgPtr msg_ptr;
+    NetworkMessage* net_msg_ptr = NULL;
+
+    // temporary vectors to store the routing results
+    vector<LinkID> output_links;
+    vector<NetDest> output_link_destinations;
+
+    MessageBuffer *buffer = m_in[incoming][vnet];
+    assert(buffer != nullptr);
+
+    while (buffer->isReady()) {
+        DPRINTF(RubyNetwork, "incoming: %d\n", incoming);
 
-                for (int i = 0; i < m_routing_table.size(); i++) {
-                    // pick the next link to look at
-                    int link = m_link_order[i].m_link;
-                    NetDest dst = m_routing_table[link];
-                    DPRINTF(RubyNetwork, "dst: %s\n", dst);
+        // Peek at message
+        msg_ptr = buffer->peekMsgPtr();
+        net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
+        DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
 
-                    if (!msg_dsts.intersectionIsNotEmpty(dst))
-                        continue;
+        output_links.clear();
+        output_link_destinations.clear();
+        NetDest msg_dsts = net_msg_ptr->getInternalDestination();
 
-                    // Remember what link we're using
-                    output_links.push_back(link);
+        // Unfortunately, the token-protocol sends some
+        // zero-destination messages, so this assert isn't valid
+        // assert(msg_dsts.count() > 0);
 
-                    // Need to remember which destinations need this message in
-                    // another vector.  This Set is the intersection of the
-                    // routing_table entry and the current destination set.  The
-                    // intersection must not be empty, since we are inside "if"
-                    output_link_destinations.push_back(msg_dsts.AND(dst));
+        assert(m_link_order.size() == m_routing_table.size());
+        assert(m_link_order.size() == m_out.size());
 
-                    // Next, we update the msg_destination not to include
-                    // those nodes that were already handled by this link
-                    msg_dsts.removeNetDest(dst);
+        if (m_network_ptr->getAdaptiveRouting()) {
+            if (m_network_ptr->isVNetOrdered(vnet)) {
+                // Don't adaptively route
+                for (int out = 0; out < m_out.size(); out++) {
+                    m_link_order[out].m_link = out;
+                    m_link_order[out].m_value = 0;
+                }
+            } else {
+                // Find how clogged each link is
+                for (int out = 0; out < m_out.size(); out++) {
+                    int out_queue_length = 0;
+                    for (int v = 0; v < m_virtual_networks; v++) {
+                        out_queue_length += m_out[out][v]->getSize();
+                    }
+                    int value =
+                        (out_queue_length << 8) |
+                        random_mt.random(0, 0xff);
+                    m_link_order[out].m_link = out;
+                    m_link_order[out].m_value = value;
                 }
 
-                assert(msg_dsts.count() == 0);
+                // Look at the most empty link first
+                sort(m_link_order.begin(), m_link_order.end());
+            }
+        }
 
-                // Check for resources - for all outgoing queues
-                bool enough = true;
-                for (int i = 0; i < output_links.size(); i++) {
-                    int outgoing = output_links[i];
+        for (int i = 0; i < m_routing_table.size(); i++) {
+            // pick the next link to look at
+            int link = m_link_order[i].m_link;
+            const NetDest &dst = m_routing_table[link];
+            DPRINTF(RubyNetwork, "dst: %s\n", dst);
 
-                    if (!m_out[outgoing][vnet]->areNSlotsAvailable(1))
-                        enough = false;
+            if (!msg_dsts.intersectionIsNotEmpty(dst))
+                continue;
 
-                    DPRINTF(RubyNetwork, "Checking if node is blocked ..."
-                            "outgoing: %d, vnet: %d, enough: %d\n",
-                            outgoing, vnet, enough);
-                }
+            // Remember what link we're using
+            output_links.push_back(link);
 
-                // There were not enough resources
-                if (!enough) {
-                    scheduleEvent(Cycles(1));
-                    DPRINTF(RubyNetwork, "Can't deliver message since a node "
-                            "is blocked\n");
-                    DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
-                    break; // go to next incoming port
-                }
+            // Need to remember which destinations need this message in
+            // another vector.  This Set is the intersection of the
+            // routing_table entry and the current destination set.  The
+            // intersection must not be empty, since we are inside "if"
+            output_link_destinations.push_back(msg_dsts.AND(dst));
 
-                MsgPtr unmodified_msg_ptr;
+            // Next, we update the msg_destination not to include
+            // those nodes that were already handled by this link
+            msg_dsts.removeNetDest(dst);
+        }
 
-                if (output_links.size() > 1) {
-                    // If we are sending this message down more than one link
-                    // (size>1), we need to make a copy of the message so each
-                    // branch can have a different internal destination we need
-                    // to create an unmodified MsgPtr because the MessageBuffer
-                    // enqueue func will modify the message
+        assert(msg_dsts.count() == 0);
 
-                    // This magic line creates a private copy of the message
-                    unmodified_msg_ptr = msg_ptr->clone();
-                }
+        // Check for resources - for all outgoing queues
+        bool enough = true;
+        for (int i = 0; i < output_links.size(); i++) {
+            int outgoing = output_links[i];
 
-                // Dequeue msg
-                buffer->dequeue();
-                m_pending_message_count[vnet]--;
+            if (!m_out[outgoing][vnet]->areNSlotsAvailable(1)) {
+                // Retry once the full queue drains rather than
+                // polling it every cycle
+                m_out[outgoing][vnet]->wakeOnDequeue(this);
+                enough = false;
+            }
 
-                // Enqueue it - for all outgoing queues
-                for (int i=0; i<output_links.size(); i++) {
-                    int outgoing = output_links[i];
+            DPRINTF(RubyNetwork, "Checking if node is blocked ..."
+                    "outgoing: %d, vnet: %d, enough: %d\n",
+                    outgoing, vnet, enough);
+        }
 
-                    if (i > 0) {
-                        // create a private copy of the unmodified message
-                        msg_ptr = unmodified_msg_ptr->clone();
-                    }
+        // There were not enough resources
+        if (!enough) {
+            DPRINTF(RubyNetwork, "Can't deliver message since a node "
+                    "is blocked\n");
+            DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
+            return; // go to next incoming port
+        }
 
-                    // Change the internal destination set of the message so it
-                    // knows which destinations this link is responsible for.
-                    net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
-                    net_msg_ptr->getInternalDestination() =
-                        output_link_destinations[i];
+        MsgPtr unmodified_msg_ptr;
 
-                    // Enqeue msg
-                    DPRINTF(RubyNetwork, "Enqueuing net msg from "
-                            "inport[%d][%d] to outport [%d][%d].\n",
-                            incoming, vnet, outgoing, vnet);
+        if (output_links.size() > 1) {
+            // If we are sending this message down more than one link
+            // (size>1), we need to make a copy of the message so each
+            // branch can have a different internal destination we need
+            // to create an unmodified MsgPtr because the MessageBuffer
+            // enqueue func will modify the message
 
-                    m_out[outgoing][vnet]->enqueue(msg_ptr);
-                }
+            // This magic line creates a private copy of the message
+            unmodified_msg_ptr = msg_ptr->clone();
+        }
+
+        // Dequeue msg
+        buffer->dequeue();
+        m_pending_message_count[vnet]--;
+
+        // Enqueue it - for all outgoing queues
+        for (int i=0; i<output_links.size(); i++) {
+            int outgoing = output_links[i];
+
+            if (i == output_links.size() - 1 && i > 0) {
+                // the last link can take the unmodified message itself
+                msg_ptr = unmodified_msg_ptr;
+            } else if (i > 0) {
+                // create a private copy of the unmodified message
+                msg_ptr = unmodified_msg_ptr->clone();
             }
+
+            // Change the internal destination set of the message so it
+            // knows which destinations this link is responsible for.
+            net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
+            net_msg_ptr->getInternalDestination() =
+                output_link_destinations[i];
+
+            // Enqeue msg
+            DPRINTF(RubyNetwork, "Enqueuing net msg from "
+                    "inport[%d][%d] to outport [%d][%d].\n",
+                    incoming, vnet, outgoing, vnet);
+
+            m_out[outgoing][vnet]->enqueue(msg_ptr);
         }
     }
+
+    // Drop the port from the active set once it has nothing left to
+    // deliver, including messages that have yet to arrive
+    if (buffer->isEmpty()) {
+        m_active_in[vnet][incoming / 64] &= ~(1ULL << (incoming % 64));
+    }
 }
 
 void
@@ -306,9 +353,10 @@ PerfectSwitch::wakeup()
 }
 
 void
-PerfectSwitch::storeEventInfo(int info)
+PerfectSwitch::storeEventInfo(int link_id, int vnet)
 {
-    m_pending_message_count[info]++;
+    m_pending_message_count[vnet]++;
+    m_active_in[vnet][link_id / 64] |= 1ULL << (link_id % 64);
 }
 
 void
@@ -73,7 +73,7 @@ class PerfectSwitch : public Consumer
     int getOutLinks() const { return m_out.size(); }
 
     void wakeup();
-    void storeEventInfo(int info);
+    void storeEventInfo(int link_id, int vnet);
 
     void clearStats();
     void collateStats();
@@ -85,6 +85,10 @@ class PerfectSwitch : public Consumer
     PerfectSwitch& operator=(const PerfectSwitch& obj);
 
     void operateVnet(int vnet);
+    void operateMessageBuffer(int incoming, int vnet);
+    //! First input port at or after port with messages for vnet,
+    //! or the number of input ports if there is none.
+    int nextActiveInPort(int vnet, int port) const;
 
     SwitchID m_switch_id;
 
@@ -101,6 +105,9 @@ class PerfectSwitch : public Consumer
 
     SimpleNetwork* m_network_ptr;
     std::vector<int> m_pending_message_count;
+    //! Per virtual network bitmap of the input ports whose buffers
+    //! hold messages, set on enqueue and cleared once a buffer drains
+    std::vector<std::vector<uint64_t> > m_active_in;
 };
 
 inline std::ostream&
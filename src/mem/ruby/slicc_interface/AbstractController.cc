@@ -39,6 +39,7 @@ AbstractController::AbstractController(const Params *p)
     m_transitions_per_cycle = p->transitions_per_cycle;
     m_buffer_size = p->buffer_size;
     m_recycle_latency = p->recycle_latency;
+    m_profile_transitions = p->profile_transitions;
     m_number_of_TBEs = p->number_of_TBEs;
     m_is_blocking = false;
 
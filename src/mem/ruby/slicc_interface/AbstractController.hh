@@ -86,6 +86,22 @@ class AbstractController : public ClockedObject, public Consumer
     //! data from the packet.
     virtual uint32_t functionalWriteBuffers(PacketPtr&) = 0;
 
+    //! Controllers with a directory are the home nodes of the lines it
+    //! maps. A home node can hold a line it never made a transition
+    //! for, so functional accesses always consult it.
+    virtual bool hasDirectory() const { return false; }
+    virtual bool isHomeNode(const Address& addr) { return false; }
+
+    //! Install a line in a stable state without making a transition,
+    //! to warm up the caches. The requestor is the controller whose
+    //! cache takes the line, and its home node records that. SLICC
+    //! generates this for machines that define installBlock().
+    //! The return value indicates if the line was installed.
+    virtual bool functionalInstall(const Address& addr, RubyRequestType type,
+                                   const MachineID& requestor,
+                                   const DataBlock& data)
+    { return false; }
+
     //! Function for enqueuing a prefetch request
     virtual void enqueuePrefetch(const Address&, const RubyRequestType&)
     { fatal("Prefetches not implemented!");}
@@ -136,6 +152,8 @@ class AbstractController : public ClockedObject, public Consumer
     int m_transitions_per_cycle;
     unsigned int m_buffer_size;
     Cycles m_recycle_latency;
+    //! Whether to record the host time spent in each transition
+    bool m_profile_transitions;
 
     //! Counter for the number of cycles when the transitions carried out
     //! were equal to the maximum allowed
@@ -43,6 +43,8 @@ class RubyController(ClockedObject):
     buffer_size = Param.UInt32(0, "max buffer size 0 means infinite")
 
     recycle_latency = Param.Cycles(10, "")
+    profile_transitions = Param.Bool(False,
+        "record the host time spent in each transition")
     number_of_TBEs = Param.Int(256, "")
     ruby_system = Param.RubySystem("")
 
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/slicc_interface/Message.hh"
+#include "mem/ruby/system/System.hh"
+
+Message::Message(const Message &other)
+    : m_time(other.m_time),
+      m_LastEnqueueTime(other.m_LastEnqueueTime),
+      m_DelayedTicks(other.m_DelayedTicks),
+      m_inflight(other.m_inflight),
+      m_inflight_line(other.m_inflight_line)
+{
+    // A copy, e.g. of a multicast message, holds the same data as the
+    // original, so it is in flight for the same line
+    if (m_inflight)
+        g_system_ptr->incInflightMessages(m_inflight_line);
+}
+
+Message::~Message()
+{
+    if (m_inflight)
+        g_system_ptr->decInflightMessages(m_inflight_line);
+}
+
+void
+Message::markInflight()
+{
+    if (m_inflight || !getFunctionalAddress(m_inflight_line))
+        return;
+
+    m_inflight = true;
+    g_system_ptr->incInflightMessages(m_inflight_line);
+}
@@ -33,6 +33,7 @@
 
 #include "base/refcnt.hh"
 #include "mem/packet.hh"
+#include "mem/ruby/common/Address.hh"
 
 class Message;
 typedef RefCountingPtr<Message> MsgPtr;
@@ -43,16 +44,13 @@ class Message : public RefCounted
     Message(Tick curTime)
         : m_time(curTime),
           m_LastEnqueueTime(curTime),
-          m_DelayedTicks(0)
+          m_DelayedTicks(0),
+          m_inflight(false)
     { }
 
-    Message(const Message &other)
-        : m_time(other.m_time),
-          m_LastEnqueueTime(other.m_LastEnqueueTime),
-          m_DelayedTicks(other.m_DelayedTicks)
-    { }
+    Message(const Message &other);
 
-    virtual ~Message() { }
+    virtual ~Message();
 
     virtual Message* clone() const = 0;
     virtual void print(std::ostream& out) const = 0;
@@ -71,6 +69,23 @@ class Message : public RefCounted
     virtual bool functionalWrite(Packet *pkt) = 0;
     //{ fatal("Write functional access not implemented!"); }
 
+    /**
+     * Get the line the message may carry data for, the one its
+     * functionalRead() and functionalWrite() methods test. Message
+     * classes that can hold data for a line need to implement this, as
+     * functional writes skip the message buffers when no message is in
+     * flight for the line.
+     * @return false if the message is not associated with a line.
+     */
+    virtual bool getFunctionalAddress(Address& addr) const { return false; }
+
+    /**
+     * Count the message as in flight for its line until it is
+     * destroyed. Called when the message is first enqueued, by which
+     * time all its fields are set.
+     */
+    void markInflight();
+
     //! Update the delay this message has experienced so far.
     void updateDelayedTicks(Tick curTime)
     {
@@ -90,6 +105,10 @@ class Message : public RefCounted
     Tick m_time;
     Tick m_LastEnqueueTime; // my last enqueue time
     Tick m_DelayedTicks; // my delayed cycles
+
+    //! Whether the message is counted as in flight for m_inflight_line
+    bool m_inflight;
+    Address m_inflight_line;
 };
 
 inline std::ostream&
@@ -84,6 +84,13 @@ class RubyRequest : public Message
     void print(std::ostream& out) const;
     bool functionalRead(Packet *pkt);
     bool functionalWrite(Packet *pkt);
+
+    bool
+    getFunctionalAddress(Address& addr) const
+    {
+        addr = m_LineAddress;
+        return true;
+    }
 };
 
 inline std::ostream&
@@ -26,6 +26,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "debug/RubyCache.hh"
 #include "debug/RubyStats.hh"
@@ -61,9 +62,8 @@ DirectoryMemory::init()
         m_sparseMemory = new SparseMemory(m_map_levels);
         g_system_ptr->registerSparseMemory(m_sparseMemory);
     } else {
-        m_entries = new AbstractEntry*[m_num_entries];
-        for (int i = 0; i < m_num_entries; i++)
-            m_entries[i] = NULL;
+        uint64 num_pages = divCeil(m_num_entries, 1ULL << ENTRY_PAGE_BITS);
+        m_entry_pages.resize(num_pages, NULL);
         m_ram = g_system_ptr->getMemoryVector();
     }
 
@@ -80,14 +80,17 @@ DirectoryMemory::init()
 DirectoryMemory::~DirectoryMemory()
 {
     // free up all the directory entries
-    if (m_entries != NULL) {
-        for (uint64 i = 0; i < m_num_entries; i++) {
-            if (m_entries[i] != NULL) {
-                delete m_entries[i];
-            }
+    for (uint64 i = 0; i < m_entry_pages.size(); i++) {
+        AbstractEntry **page = m_entry_pages[i];
+        if (page == NULL)
+            continue;
+        for (uint64 j = 0; j < (1ULL << ENTRY_PAGE_BITS); j++) {
+            delete page[j];
         }
-        delete [] m_entries;
-    } else if (m_use_map) {
+        delete [] page;
+    }
+
+    if (m_use_map) {
         delete m_sparseMemory;
     }
 }
@@ -135,7 +138,10 @@ DirectoryMemory::lookup(PhysAddress address)
     } else {
         uint64_t idx = mapAddressToLocalIdx(address);
         assert(idx < m_num_entries);
-        return m_entries[idx];
+        AbstractEntry **page = m_entry_pages[idx >> ENTRY_PAGE_BITS];
+        if (page == NULL)
+            return NULL;
+        return page[idx & mask(ENTRY_PAGE_BITS)];
     }
 }
 
@@ -152,9 +158,15 @@ DirectoryMemory::allocate(const PhysAddress& address, AbstractEntry* entry)
     } else {
         idx = mapAddressToLocalIdx(address);
         assert(idx < m_num_entries);
+        AbstractEntry **&page = m_entry_pages[idx >> ENTRY_PAGE_BITS];
+        if (page == NULL) {
+            DPRINTF(RubyCache, "Allocating entry page %d\n",
+                    idx >> ENTRY_PAGE_BITS);
+            page = new AbstractEntry*[1ULL << ENTRY_PAGE_BITS]();
+        }
         entry->getDataBlk().assign(m_ram->getBlockPtr(address));
         entry->changePermission(AccessPermission_Read_Only);
-        m_entries[idx] = entry;
+        page[idx & mask(ENTRY_PAGE_BITS)] = entry;
     }
 
     return entry;
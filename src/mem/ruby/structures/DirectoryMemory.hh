@@ -31,6 +31,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "mem/protocol/DirectoryRequestType.hh"
 #include "mem/ruby/common/Address.hh"
@@ -74,7 +75,12 @@ class DirectoryMemory : public SimObject
 
   private:
     const std::string m_name;
-    AbstractEntry **m_entries;
+
+    // The entries are kept in pages of 2^ENTRY_PAGE_BITS pointers.
+    // A page is only allocated when one of its entries is, so memory
+    // the workload never touches costs one NULL page pointer per page.
+    static const int ENTRY_PAGE_BITS = 12;
+    std::vector<AbstractEntry **> m_entry_pages;
     // int m_size;  // # of memory module blocks this directory is
                     // responsible for
     uint64 m_size_bytes;
@@ -278,6 +278,7 @@ void
 RubyMemoryControl::enqueue(const MsgPtr& message, Cycles latency)
 {
     Cycles arrival_time = curCycle() + latency;
+    message->markInflight();
     const MemoryMsg* memMess = safe_cast<const MemoryMsg*>(message.get());
     physical_address_t addr = memMess->getAddr().getAddress();
     MemoryRequestType type = memMess->getType();
@@ -384,7 +384,7 @@ SparseMemory::recordBlocks(int cntrl_id, CacheRecorder* tr) const
                     // If at the last level, add a trace record
                     temp_address = address | (curAddress.getAddress()
                                                                    << lowBit);
-                    DataBlock block = ((AbstractEntry*)entry)->getDataBlk();
+                    DataBlock &block = ((AbstractEntry*)entry)->getDataBlk();
                     tr->addRecord(cntrl_id, temp_address, 0, RubyRequestType_ST, 0,
                                   block);
                 }
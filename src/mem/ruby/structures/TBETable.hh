@@ -93,7 +93,9 @@ TBETable<ENTRY>::allocate(const Address& address)
 {
     assert(!isPresent(address));
     assert(m_map.size() < m_number_of_TBEs);
-    m_map[address] = ENTRY();
+    // Default construct the entry in place rather than copying a
+    // temporary into it
+    m_map[address];
 }
 
 template<class ENTRY>
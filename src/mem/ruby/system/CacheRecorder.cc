@@ -27,13 +27,29 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+
+#include "config/have_protobuf.hh"
 #include "debug/RubyCacheTrace.hh"
 #include "mem/ruby/system/CacheRecorder.hh"
 #include "mem/ruby/system/Sequencer.hh"
 #include "mem/ruby/system/System.hh"
 
+#if HAVE_PROTOBUF
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#endif
+
 using namespace std;
 
+#if HAVE_PROTOBUF
+static bool
+olderTraceRecord(const TraceRecord* n1, const TraceRecord* n2)
+{
+    return n1->m_time < n2->m_time;
+}
+#endif
+
 void
 TraceRecord::print(ostream& out) const
 {
@@ -99,45 +115,193 @@ CacheRecorder::enqueueNextFlushRequest()
 }
 
 void
-CacheRecorder::enqueueNextFetchRequest()
+CacheRecorder::enqueueNextFetchRequest(Sequencer *done_seq)
 {
-    if (m_bytes_read < m_uncompressed_trace_size) {
+    if (done_seq != NULL) {
+        assert(m_fetches_outstanding[done_seq] > 0);
+        if (--m_fetches_outstanding[done_seq] == 0)
+            issueFetchRequest(done_seq);
+        return;
+    }
+
+    // Split the trace into the records of each sequencer, so that a busy
+    // sequencer does not hold up the others
+    while (m_bytes_read < m_uncompressed_trace_size) {
         TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
                                                                 m_bytes_read);
 
-        DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
-
-        for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
-                rec_bytes_read += RubySystem::getBlockSizeBytes()) {
-            Request* req = new Request();
-            MemCmd::Command requestType;
-
-            if (traceRecord->m_type == RubyRequestType_LD) {
-                requestType = MemCmd::ReadReq;
-                req->setPhys(traceRecord->m_data_address + rec_bytes_read,
-                    RubySystem::getBlockSizeBytes(), 0, Request::funcMasterId);
-            }   else if (traceRecord->m_type == RubyRequestType_IFETCH) {
-                requestType = MemCmd::ReadReq;
-                req->setPhys(traceRecord->m_data_address + rec_bytes_read,
-                        RubySystem::getBlockSizeBytes(),
-                        Request::INST_FETCH, Request::funcMasterId);
-            }   else {
-                requestType = MemCmd::WriteReq;
-                req->setPhys(traceRecord->m_data_address + rec_bytes_read,
-                    RubySystem::getBlockSizeBytes(), 0, Request::funcMasterId);
+        if (installRecord(traceRecord)) {
+            m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
+            continue;
+        }
+
+        Sequencer* m_sequencer_ptr = m_seq_map[traceRecord->m_cntrl_id];
+        assert(m_sequencer_ptr != NULL);
+        m_fetch_queues[m_sequencer_ptr].push_back(m_bytes_read);
+
+        m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
+    }
+
+    // Start the sequencers in controller order
+    for (int cntrl = 0; cntrl < m_seq_map.size(); cntrl++) {
+        Sequencer* m_sequencer_ptr = m_seq_map[cntrl];
+        if (m_sequencer_ptr != NULL &&
+            m_fetches_outstanding[m_sequencer_ptr] == 0) {
+            issueFetchRequest(m_sequencer_ptr);
+        }
+    }
+}
+
+bool
+CacheRecorder::installRecord(TraceRecord* rec)
+{
+    // Records of larger blocks are fetched one block at a time
+    if (m_block_size_bytes != RubySystem::getBlockSizeBytes())
+        return false;
+
+    DataBlock data;
+    data.setData(rec->m_data, 0, m_block_size_bytes);
+    if (!g_system_ptr->functionalInstall(rec->m_cntrl_id,
+                                         Address(rec->m_data_address),
+                                         rec->m_type, data))
+        return false;
+
+    DPRINTF(RubyCacheTrace, "Installed %s\n", *rec);
+    m_records_read++;
+    return true;
+}
+
+void
+CacheRecorder::issueFetchRequest(Sequencer *seq)
+{
+    std::deque<uint64_t> &queue = m_fetch_queues[seq];
+    if (queue.empty())
+        return;
+
+    TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
+                                               queue.front());
+    queue.pop_front();
+
+    DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
+
+    for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
+            rec_bytes_read += RubySystem::getBlockSizeBytes()) {
+        Request* req = new Request();
+        MemCmd::Command requestType;
+
+        if (traceRecord->m_type == RubyRequestType_LD) {
+            requestType = MemCmd::ReadReq;
+            req->setPhys(traceRecord->m_data_address + rec_bytes_read,
+                RubySystem::getBlockSizeBytes(), 0, Request::funcMasterId);
+        }   else if (traceRecord->m_type == RubyRequestType_IFETCH) {
+            requestType = MemCmd::ReadReq;
+            req->setPhys(traceRecord->m_data_address + rec_bytes_read,
+                    RubySystem::getBlockSizeBytes(),
+                    Request::INST_FETCH, Request::funcMasterId);
+        }   else {
+            requestType = MemCmd::WriteReq;
+            req->setPhys(traceRecord->m_data_address + rec_bytes_read,
+                RubySystem::getBlockSizeBytes(), 0, Request::funcMasterId);
+        }
+
+        Packet *pkt = new Packet(req, requestType);
+        pkt->dataStatic(traceRecord->m_data + rec_bytes_read);
+
+        m_fetches_outstanding[seq]++;
+        seq->makeRequest(pkt);
+    }
+
+    m_records_read++;
+}
+
+void
+CacheRecorder::readPacketTraces(const vector<string>& filenames)
+{
+    assert(m_uncompressed_trace == NULL);
+    assert(m_block_size_bytes == RubySystem::getBlockSizeBytes());
+
+#if HAVE_PROTOBUF
+    // Keep one record per block and controller, with the time and type
+    // of its last access
+    vector<TraceRecord*> records;
+    for (int cntrl = 0; cntrl < filenames.size(); cntrl++) {
+        if (filenames[cntrl].empty())
+            continue;
+
+        ProtoInputStream trace(filenames[cntrl]);
+        ProtoMessage::PacketHeader header_msg;
+        if (!trace.read(header_msg))
+            fatal("Failed to read packet header from %s\n", filenames[cntrl]);
+        if (header_msg.tick_freq() != SimClock::Frequency)
+            fatal("Trace %s was recorded with a different tick frequency "
+                  "%d\n", filenames[cntrl], header_msg.tick_freq());
+
+        m5::hash_map<physical_address_t, TraceRecord*> blocks;
+        ProtoMessage::Packet pkt_msg;
+        while (trace.read(pkt_msg)) {
+            MemCmd cmd(pkt_msg.cmd());
+            if (!cmd.isRead() && !cmd.isWrite())
+                continue;
+
+            physical_address_t addr =
+                pkt_msg.addr() & ~(physical_address_t)(m_block_size_bytes - 1);
+            TraceRecord*& rec = blocks[addr];
+            if (rec == NULL) {
+                rec = (TraceRecord*)malloc(sizeof(TraceRecord) +
+                                           m_block_size_bytes);
+                rec->m_cntrl_id = cntrl;
+                rec->m_data_address = addr;
+                rec->m_pc_address = 0;
+                records.push_back(rec);
             }
 
-            Packet *pkt = new Packet(req, requestType);
-            pkt->dataStatic(traceRecord->m_data + rec_bytes_read);
+            Request::FlagsType flags =
+                pkt_msg.has_flags() ? pkt_msg.flags() : 0;
+            rec->m_time = pkt_msg.tick();
+            if (cmd.isWrite()) {
+                rec->m_type = RubyRequestType_ST;
+            } else if (flags & Request::INST_FETCH) {
+                rec->m_type = RubyRequestType_IFETCH;
+            } else {
+                rec->m_type = RubyRequestType_LD;
+            }
+        }
 
-            Sequencer* m_sequencer_ptr = m_seq_map[traceRecord->m_cntrl_id];
-            assert(m_sequencer_ptr != NULL);
-            m_sequencer_ptr->makeRequest(pkt);
+        DPRINTF(RubyCacheTrace, "Read %d blocks for controller %d from %s\n",
+                blocks.size(), cntrl, filenames[cntrl]);
+    }
+
+    // Issue the blocks the sequencers accessed last after the others,
+    // so that they are the ones left in the caches, keeping records of
+    // the same time in controller order
+    std::stable_sort(records.begin(), records.end(), olderTraceRecord);
+
+    int record_size = sizeof(TraceRecord) + m_block_size_bytes;
+    m_uncompressed_trace = new uint8_t[records.size() * record_size];
+    m_uncompressed_trace_size = 0;
+
+    for (int i = 0; i < records.size(); i++) {
+        TraceRecord* rec = records[i];
+
+        // The trace only has the addresses, so the data of the block is
+        // read from the memory system
+        Request req(rec->m_data_address, m_block_size_bytes, 0,
+                    Request::funcMasterId);
+        Packet pkt(&req, MemCmd::ReadReq);
+        pkt.dataStatic(rec->m_data);
+        if (!g_system_ptr->functionalRead(&pkt)) {
+            fatal("Unable to read the data of %#x to warm up the caches\n",
+                  rec->m_data_address);
         }
 
-        m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
-        m_records_read++;
+        memcpy(m_uncompressed_trace + m_uncompressed_trace_size, rec,
+               record_size);
+        m_uncompressed_trace_size += record_size;
+        free(rec);
     }
+#else
+    fatal("Reading packet traces to warm up the caches needs protobuf\n");
+#endif
 }
 
 void
@@ -35,6 +35,9 @@
 #ifndef __MEM_RUBY_RECORDER_CACHERECORDER_HH__
 #define __MEM_RUBY_RECORDER_CACHERECORDER_HH__
 
+#include <deque>
+#include <map>
+#include <string>
 #include <vector>
 
 #include "base/hashmap.hh"
@@ -93,17 +96,43 @@ class CacheRecorder
     /*!
      * Function for fetching warming up the memory and the caches. It goes
      * through the recorded contents of the caches, as available in the
-     * checkpoint and issues fetch requests. Except for the first one, a
-     * fetch request is issued only after the previous one has completed.
-     * It should be possible to use this with any protocol.
+     * checkpoint and issues fetch requests. Lines the protocol can
+     * install directly, see AbstractController::functionalInstall, are
+     * put in the caches straight away instead. Each sequencer issues
+     * the remaining records in the order of the trace, one after the
+     * other, but independently of the other sequencers, so they warm
+     * up their caches in parallel. It should be possible to use this
+     * with any protocol. The sequencer that completed a request is
+     * passed, or NULL when starting the warmup.
      */
-    void enqueueNextFetchRequest();
+    void enqueueNextFetchRequest(Sequencer *done_seq);
+
+    /*!
+     * Function for creating the trace to warm up the caches with from
+     * packet traces, such as those a CommMonitor captures in an
+     * atomic-mode run. There is one trace per controller, indexed like
+     * the sequencer map, and an empty name means no trace. Only the last
+     * access to each block is kept, and the data of the block is read
+     * functionally from the memory system, so this should be done
+     * before the simulation starts.
+     */
+    void readPacketTraces(const std::vector<std::string>& filenames);
+
+    bool hasRecords() const { return m_uncompressed_trace_size > 0; }
 
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
     CacheRecorder& operator=(const CacheRecorder& obj);
 
+    //! Issue the next record of the trace that a sequencer fetches
+    void issueFetchRequest(Sequencer *seq);
+
+    //! Install a record directly in the cache of its controller, if
+    //! the protocol supports that. The return value indicates if the
+    //! record was installed.
+    bool installRecord(TraceRecord* rec);
+
     std::vector<TraceRecord*> m_records;
     uint8_t* m_uncompressed_trace;
     uint64_t m_uncompressed_trace_size;
@@ -112,6 +141,11 @@ class CacheRecorder
     uint64_t m_records_read;
     uint64_t m_records_flushed;
     uint64_t m_block_size_bytes;
+    //! Number of fetch requests each sequencer has outstanding
+    std::map<Sequencer*, int> m_fetches_outstanding;
+    //! Offsets in the trace of the records each sequencer has yet to
+    //! fetch, in the order of the trace
+    std::map<Sequencer*, std::deque<uint64_t> > m_fetch_queues;
 };
 
 inline bool
@@ -55,9 +55,11 @@ RubySequencerParams::create()
 }
 
 Sequencer::Sequencer(const Params *p)
-    : RubyPort(p), m_IncompleteTimes(MachineType_NUM), deadlockCheckEvent(this)
+    : RubyPort(p), m_IncompleteTimes(MachineType_NUM),
+      deadlockCheckEvent(this), m_instHitEvent(this), m_dataHitEvent(this)
 {
     m_outstanding_count = 0;
+    m_coalesced_count = 0;
 
     m_instCache_ptr = p->icache;
     m_dataCache_ptr = p->dcache;
@@ -70,6 +72,9 @@ Sequencer::Sequencer(const Params *p)
     assert(m_dataCache_ptr != NULL);
 
     m_usingNetworkTester = p->using_network_tester;
+    m_fast_load_hits = p->fast_load_hits;
+    m_fast_store_hits = p->fast_store_hits;
+    m_warmup_trace = p->warmup_trace;
 }
 
 Sequencer::~Sequencer()
@@ -207,8 +212,24 @@ Sequencer::printProgress(ostream& out) const
 #endif
 }
 
-// Insert the request on the correct request table.  Return true if
-// the entry was already present.
+// Requests that can be completed with the callback for an outstanding
+// request to the same line, after it: the callback of a load grants read
+// permission and that of a store write permission.
+static bool
+canCoalesce(RubyRequestType outstanding, RubyRequestType type)
+{
+    if (outstanding == RubyRequestType_ST)
+        return type == RubyRequestType_ST || type == RubyRequestType_LD;
+    if (outstanding == RubyRequestType_LD ||
+        outstanding == RubyRequestType_IFETCH)
+        return type == outstanding;
+    return false;
+}
+
+// Insert the request on the correct request table.  Return Ready if the
+// request has to be issued, Issued if it was coalesced with an
+// outstanding request to the same line and Aliased if it has to be
+// retried.
 RequestStatus
 Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
 {
@@ -253,14 +274,21 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
         } else {
           // There is an outstanding write request for the cache line
           m_store_waiting_on_store++;
-          return RequestStatus_Aliased;
+          if (!canCoalesce(r.first->second->m_type, request_type))
+              return RequestStatus_Aliased;
+          coalesceRequest(pkt, request_type, line_addr);
+          return RequestStatus_Issued;
         }
     } else {
         // Check if there is any outstanding write request for the same
         // cache line.
-        if (m_writeRequestTable.count(line_addr) > 0) {
+        RequestTable::iterator w = m_writeRequestTable.find(line_addr);
+        if (w != m_writeRequestTable.end()) {
             m_load_waiting_on_store++;
-            return RequestStatus_Aliased;
+            if (!canCoalesce(w->second->m_type, request_type))
+                return RequestStatus_Aliased;
+            coalesceRequest(pkt, request_type, line_addr);
+            return RequestStatus_Issued;
         }
 
         pair<RequestTable::iterator, bool> r =
@@ -273,7 +301,10 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
         } else {
             // There is an outstanding read request for the cache line
             m_load_waiting_on_load++;
-            return RequestStatus_Aliased;
+            if (!canCoalesce(r.first->second->m_type, request_type))
+                return RequestStatus_Aliased;
+            coalesceRequest(pkt, request_type, line_addr);
+            return RequestStatus_Issued;
         }
     }
 
@@ -284,6 +315,58 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
     return RequestStatus_Ready;
 }
 
+void
+Sequencer::coalesceRequest(PacketPtr pkt, RubyRequestType request_type,
+                           const Address& line_addr)
+{
+    DPRINTF(RubySequencer, "Coalescing %s request for %s\n",
+            RubyRequestType_to_string(request_type), line_addr);
+
+    m_coalescedRequests[line_addr].push_back(
+        new SequencerRequest(pkt, request_type, curCycle()));
+    m_coalesced_count++;
+    m_coalesced_requests++;
+}
+
+// Remove the requests coalesced with the one for the given line, before
+// any of them completes: the callbacks may issue new requests for the
+// line.
+void
+Sequencer::takeCoalescedRequests(const Address& line_addr,
+                                 RequestQueue& requests)
+{
+    m5::hash_map<Address, RequestQueue>::iterator i =
+        m_coalescedRequests.find(line_addr);
+    if (i == m_coalescedRequests.end())
+        return;
+
+    requests.swap(i->second);
+    m_coalescedRequests.erase(i);
+    m_coalesced_count -= requests.size();
+    assert(m_coalesced_count >= 0);
+}
+
+void
+Sequencer::hitCoalescedRequests(const Address& address,
+                                RequestQueue& requests, DataBlock& data,
+                                const MachineType mach,
+                                const bool externalHit,
+                                const Cycles initialRequestTime,
+                                const Cycles forwardRequestTime,
+                                const Cycles firstResponseTime)
+{
+    for (RequestQueue::iterator i = requests.begin(); i != requests.end();
+         ++i) {
+        SequencerRequest* request = *i;
+        bool success = true;
+        if (request->m_type == RubyRequestType_ST && !m_usingNetworkTester)
+            success = handleLlsc(address, request);
+        hitCallback(request, data, success, mach, externalHit,
+                    initialRequestTime, forwardRequestTime,
+                    firstResponseTime);
+    }
+}
+
 void
 Sequencer::markRemoved()
 {
@@ -437,6 +520,9 @@ Sequencer::writeCallback(const Address& address, DataBlock& data,
     m_writeRequestTable.erase(i);
     markRemoved();
 
+    RequestQueue coalesced;
+    takeCoalescedRequests(address, coalesced);
+
     assert((request->m_type == RubyRequestType_ST) ||
            (request->m_type == RubyRequestType_ATOMIC) ||
            (request->m_type == RubyRequestType_RMW_Read) ||
@@ -465,6 +551,9 @@ Sequencer::writeCallback(const Address& address, DataBlock& data,
 
     hitCallback(request, data, success, mach, externalHit,
                 initialRequestTime, forwardRequestTime, firstResponseTime);
+    hitCoalescedRequests(address, coalesced, data, mach, externalHit,
+                         initialRequestTime, forwardRequestTime,
+                         firstResponseTime);
 }
 
 void
@@ -484,11 +573,17 @@ Sequencer::readCallback(const Address& address, DataBlock& data,
     m_readRequestTable.erase(i);
     markRemoved();
 
+    RequestQueue coalesced;
+    takeCoalescedRequests(address, coalesced);
+
     assert((request->m_type == RubyRequestType_LD) ||
            (request->m_type == RubyRequestType_IFETCH));
 
     hitCallback(request, data, true, mach, externalHit,
                 initialRequestTime, forwardRequestTime, firstResponseTime);
+    hitCoalescedRequests(address, coalesced, data, mach, externalHit,
+                         initialRequestTime, forwardRequestTime,
+                         firstResponseTime);
 }
 
 void
@@ -566,7 +661,7 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
         assert(pkt->req);
         delete pkt->req;
         delete pkt;
-        g_system_ptr->m_cache_recorder->enqueueNextFetchRequest();
+        g_system_ptr->m_cache_recorder->enqueueNextFetchRequest(this);
     } else if (g_system_ptr->m_cooldown_enabled) {
         delete pkt;
         g_system_ptr->m_cache_recorder->enqueueNextFlushRequest();
@@ -584,7 +679,7 @@ Sequencer::empty() const
 RequestStatus
 Sequencer::makeRequest(PacketPtr pkt)
 {
-    if (m_outstanding_count >= m_max_outstanding_requests) {
+    if (outstandingCount() >= m_max_outstanding_requests) {
         return RequestStatus_BufferFull;
     }
 
@@ -660,7 +755,14 @@ Sequencer::makeRequest(PacketPtr pkt)
     if (status != RequestStatus_Ready)
         return status;
 
-    issueRequest(pkt, secondary_type);
+    // Only plain loads, instruction fetches and stores may complete in
+    // the sequencer. RMW and locked accesses rely on the side effects
+    // of their transitions, such as blocking the mandatory queue.
+    bool plain_access = primary_type == RubyRequestType_LD ||
+                        primary_type == RubyRequestType_IFETCH ||
+                        primary_type == RubyRequestType_ST;
+    if (!plain_access || !issueFastHit(pkt, secondary_type))
+        issueRequest(pkt, secondary_type);
 
     // TODO: issue hardware prefetches here
     return RequestStatus_Issued;
@@ -706,6 +808,116 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, latency);
 }
 
+// Protocols whose L1 hits to lines with the permission for the access
+// do nothing but call back the sequencer and count the hit can let the
+// sequencer complete those hits itself, saving the message and the
+// transition. The hit completes after the cache latency, when the
+// controller would have seen the request.
+bool
+Sequencer::issueFastHit(PacketPtr pkt, RubyRequestType type)
+{
+    if (!(type == RubyRequestType_ST ? m_fast_store_hits :
+          m_fast_load_hits)) {
+        return false;
+    }
+
+    Address line_addr(pkt->getAddr());
+    line_addr.makeLineAddress();
+    if (lookupFastHit(line_addr, type) == NULL)
+        return false;
+
+    DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %s %s\n",
+             curTick(), m_version, "Seq", "Begin", "", "",
+             Address(pkt->getAddr()), RubyRequestType_to_string(type));
+
+    FastHit hit;
+    hit.line = line_addr;
+    hit.type = type;
+    FastHitEvent *event;
+    if (type == RubyRequestType_IFETCH) {
+        hit.when = clockEdge(m_instCache_ptr->getLatency());
+        event = &m_instHitEvent;
+    } else {
+        hit.when = clockEdge(m_dataCache_ptr->getLatency());
+        event = &m_dataHitEvent;
+    }
+
+    // Each cache has a fixed latency, so its hits complete in order
+    assert(event->hits.empty() || event->hits.back().when <= hit.when);
+    event->hits.push_back(hit);
+    if (!event->scheduled())
+        schedule(event, hit.when);
+    return true;
+}
+
+// Return the L1 entry for the line if a fast hit is possible for the
+// request type, NULL otherwise.
+AbstractCacheEntry*
+Sequencer::lookupFastHit(const Address& line, RubyRequestType type)
+{
+    AbstractCacheEntry *entry;
+    switch (type) {
+      case RubyRequestType_IFETCH:
+        entry = m_instCache_ptr->lookup(line);
+        break;
+      case RubyRequestType_LD:
+      case RubyRequestType_ST:
+        entry = m_dataCache_ptr->lookup(line);
+        break;
+      default:
+        return NULL;
+    }
+
+    if (entry == NULL)
+        return NULL;
+
+    AccessPermission perm = entry->getPermission();
+    if (perm == AccessPermission_Read_Write ||
+        (perm == AccessPermission_Read_Only &&
+         type != RubyRequestType_ST)) {
+        return entry;
+    }
+    return NULL;
+}
+
+void
+Sequencer::completeFastHits(FastHitEvent *event)
+{
+    while (!event->hits.empty() && event->hits.front().when <= curTick()) {
+        FastHit hit = event->hits.front();
+        event->hits.pop_front();
+
+        // The line may have lost its permission while the access was in
+        // flight, in which case the controller handles it after all.
+        AbstractCacheEntry *entry = lookupFastHit(hit.line, hit.type);
+        if (entry == NULL) {
+            RequestTable &table = (hit.type == RubyRequestType_ST) ?
+                m_writeRequestTable : m_readRequestTable;
+            RequestTable::iterator i = table.find(hit.line);
+            assert(i != table.end());
+            issueRequest(i->second->pkt, hit.type);
+            continue;
+        }
+
+        m_fast_hits++;
+        if (hit.type == RubyRequestType_IFETCH) {
+            m_instCache_ptr->m_demand_hits++;
+        } else {
+            m_dataCache_ptr->m_demand_hits++;
+        }
+
+        if (hit.type == RubyRequestType_ST) {
+            writeCallback(hit.line, entry->getDataBlk());
+        } else {
+            readCallback(hit.line, entry->getDataBlk());
+        }
+    }
+
+    // The callbacks may have issued further hits and scheduled the event
+    if (!event->hits.empty() && !event->scheduled())
+        schedule(event, event->hits.front().when);
+}
+
 template <class KEY, class VALUE>
 std::ostream &
 operator<<(ostream &out, const m5::hash_map<KEY, VALUE> &map)
@@ -726,6 +938,7 @@ Sequencer::print(ostream& out) const
 {
     out << "[Sequencer: " << m_version
         << ", outstanding requests: " << m_outstanding_count
+        << ", coalesced requests: " << m_coalesced_count
         << ", read request table: " << m_readRequestTable
         << ", write request table: " << m_writeRequestTable
         << "]";
@@ -774,6 +987,15 @@ Sequencer::regStats()
         .name(name() + ".load_waiting_on_store")
         .desc("Number of times a load aliased with a pending store")
         .flags(Stats::nozero);
+    m_coalesced_requests
+        .name(name() + ".coalesced_requests")
+        .desc("Number of requests completed along with a pending request "
+              "to the same line")
+        .flags(Stats::nozero);
+    m_fast_hits
+        .name(name() + ".fast_hits")
+        .desc("Number of L1 hits completed by the sequencer")
+        .flags(Stats::nozero);
 
     // These statistical variables are not for display.
     // The profiler will collate these across different
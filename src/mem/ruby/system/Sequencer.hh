@@ -29,7 +29,9 @@
 #ifndef __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 #define __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 
+#include <deque>
 #include <iostream>
+#include <string>
 
 #include "base/hashmap.hh"
 #include "mem/protocol/MachineType.hh"
@@ -86,7 +88,8 @@ class Sequencer : public RubyPort
 
     RequestStatus makeRequest(PacketPtr pkt);
     bool empty() const;
-    int outstandingCount() const { return m_outstanding_count; }
+    int outstandingCount() const
+    { return m_outstanding_count + m_coalesced_count; }
 
     bool isDeadlockEventScheduled() const
     { return deadlockCheckEvent.scheduled(); }
@@ -149,8 +152,38 @@ class Sequencer : public RubyPort
     Stats::Counter getIncompleteTimes(const MachineType t) const
     { return m_IncompleteTimes[t]; }
 
+    const std::string& getWarmupTrace() const { return m_warmup_trace; }
+
   private:
+    //! An L1 hit completed by the sequencer, see issueFastHit()
+    struct FastHit
+    {
+        Tick when;
+        Address line;
+        RubyRequestType type;
+    };
+
+    class FastHitEvent : public Event
+    {
+      private:
+        Sequencer *m_sequencer_ptr;
+
+      public:
+        //! Pending hits in the order they complete
+        std::deque<FastHit> hits;
+
+        FastHitEvent(Sequencer *_seq) : m_sequencer_ptr(_seq) {}
+        void process() { m_sequencer_ptr->completeFastHits(this); }
+        const char *description() const { return "Sequencer L1 hit"; }
+    };
+
+    typedef std::deque<SequencerRequest*> RequestQueue;
+
     void issueRequest(PacketPtr pkt, RubyRequestType type);
+    bool issueFastHit(PacketPtr pkt, RubyRequestType type);
+    AbstractCacheEntry* lookupFastHit(const Address& line,
+                                      RubyRequestType type);
+    void completeFastHits(FastHitEvent *event);
 
     void hitCallback(SequencerRequest* request, DataBlock& data,
                      bool llscSuccess,
@@ -167,6 +200,16 @@ class Sequencer : public RubyPort
                            Cycles completionTime);
 
     RequestStatus insertRequest(PacketPtr pkt, RubyRequestType request_type);
+    void coalesceRequest(PacketPtr pkt, RubyRequestType request_type,
+                         const Address& line_addr);
+    void takeCoalescedRequests(const Address& line_addr,
+                               RequestQueue& requests);
+    void hitCoalescedRequests(const Address& address,
+                              RequestQueue& requests, DataBlock& data,
+                              const MachineType mach, const bool externalHit,
+                              const Cycles initialRequestTime,
+                              const Cycles forwardRequestTime,
+                              const Cycles firstResponseTime);
     bool handleLlsc(const Address& address, SequencerRequest* request);
 
     // Private copy constructor and assignment operator
@@ -185,6 +228,10 @@ class Sequencer : public RubyPort
     RequestTable m_readRequestTable;
     // Global outstanding request count, across all request tables
     int m_outstanding_count;
+    //! Requests waiting for the outstanding request to the same line
+    //! to complete, and then completed with the same callback
+    m5::hash_map<Address, RequestQueue> m_coalescedRequests;
+    int m_coalesced_count;
     bool m_deadlock_check_scheduled;
 
     //! Counters for recording aliasing information.
@@ -192,8 +239,19 @@ class Sequencer : public RubyPort
     Stats::Scalar m_store_waiting_on_store;
     Stats::Scalar m_load_waiting_on_store;
     Stats::Scalar m_load_waiting_on_load;
+    //! Number of requests completed with the callback of another
+    Stats::Scalar m_coalesced_requests;
+    //! Number of L1 hits completed by the sequencer
+    Stats::Scalar m_fast_hits;
 
     bool m_usingNetworkTester;
+    //! Whether the protocol lets the sequencer complete loads and
+    //! stores to lines the L1 has permission for, see issueFastHit()
+    bool m_fast_load_hits;
+    bool m_fast_store_hits;
+
+    //! Packet trace to warm up the caches with at startup
+    std::string m_warmup_trace;
 
     //! Histogram for number of outstanding requests per cycle.
     Stats::Histogram m_outstandReqHist;
@@ -242,6 +300,8 @@ class Sequencer : public RubyPort
     };
 
     SequencerWakeupEvent deadlockCheckEvent;
+    FastHitEvent m_instHitEvent;
+    FastHitEvent m_dataHitEvent;
 };
 
 inline std::ostream&
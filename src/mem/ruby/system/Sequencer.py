@@ -70,6 +70,12 @@ class RubySequencer(RubyPort):
     deadlock_threshold = Param.Cycles(500000,
         "max outstanding cycles for a request before deadlock/livelock declared")
     using_network_tester = Param.Bool(False, "")
+    warmup_trace = Param.String("", "packet trace, e.g. from a CommMonitor "
+        "in an atomic-mode run, to warm up the caches with at startup")
+    fast_load_hits = Param.Bool(False, "complete loads that hit in the L1 "
+        "in the sequencer, for protocols that do nothing else on such hits")
+    fast_store_hits = Param.Bool(False, "complete stores that hit in the "
+        "L1 in the sequencer, for protocols that do nothing else on such hits")
 
 class DMASequencer(RubyPort):
     type = 'DMASequencer'
@@ -29,6 +29,7 @@
 #include <fcntl.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <cstdio>
 
 #include "base/intmath.hh"
@@ -37,6 +38,7 @@
 #include "debug/RubySystem.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/network/Network.hh"
+#include "mem/ruby/system/Sequencer.hh"
 #include "mem/ruby/system/System.hh"
 #include "sim/eventq.hh"
 #include "sim/simulate.hh"
@@ -103,11 +105,102 @@ void
 RubySystem::registerAbstractController(AbstractController* cntrl)
 {
   m_abs_cntrl_vec.push_back(cntrl);
+  if (cntrl->hasDirectory())
+      m_home_cntrl_vec.push_back(cntrl);
 
   MachineID id = cntrl->getMachineID();
   g_abs_controls[id.getType()][id.getNum()] = cntrl;
 }
 
+void
+RubySystem::updateLineOwner(const Address& line, AbstractController* cntrl,
+                            AccessPermission perm)
+{
+    // Home nodes are consulted for all their lines anyway
+    if (cntrl->hasDirectory())
+        return;
+
+    if (perm != AccessPermission_Invalid &&
+        perm != AccessPermission_NotPresent) {
+        ControllerList& owners = m_line_owners[line];
+        if (std::find(owners.begin(), owners.end(), cntrl) == owners.end())
+            owners.push_back(cntrl);
+        return;
+    }
+
+    m5::hash_map<Address, ControllerList>::iterator it =
+        m_line_owners.find(line);
+    if (it == m_line_owners.end())
+        return;
+
+    ControllerList& owners = it->second;
+    ControllerList::iterator owner =
+        std::find(owners.begin(), owners.end(), cntrl);
+    if (owner != owners.end()) {
+        *owner = owners.back();
+        owners.pop_back();
+        if (owners.empty())
+            m_line_owners.erase(it);
+    }
+}
+
+bool
+RubySystem::functionalInstall(int cntrl, const Address& line,
+                              RubyRequestType type, const DataBlock& data)
+{
+    // Installing a line another cache holds would take a transition of
+    // that cache to give it up
+    if (m_line_owners.find(line) != m_line_owners.end())
+        return false;
+
+    // Records of controllers without a sequencer, such as the lower
+    // level caches in a checkpoint trace, are only fetched through
+    // another controller
+    AbstractController* requestor = m_abs_cntrl_vec[cntrl];
+    if (requestor->getSequencer() == NULL)
+        return false;
+
+    MachineID id = requestor->getMachineID();
+    if (!requestor->functionalInstall(line, type, id, data))
+        return false;
+
+    // The line is cached nowhere else, so its home node has no reason
+    // to refuse it
+    for (unsigned int i = 0; i < m_home_cntrl_vec.size(); ++i) {
+        AbstractController* home = m_home_cntrl_vec[i];
+        if (home->isHomeNode(line) &&
+            !home->functionalInstall(line, type, id, data)) {
+            panic("%s installed %s, but its home node %s did not\n",
+                  requestor->name(), line, home->name());
+        }
+    }
+
+    return true;
+}
+
+void
+RubySystem::decInflightMessages(const Address& line)
+{
+    m5::hash_map<Address, unsigned>::iterator it = m_inflight_msgs.find(line);
+    assert(it != m_inflight_msgs.end() && it->second > 0);
+    if (--it->second == 0)
+        m_inflight_msgs.erase(it);
+}
+
+void
+RubySystem::getLineControllers(const Address& line, ControllerList& cntrls)
+{
+    for (unsigned int i = 0; i < m_home_cntrl_vec.size(); ++i) {
+        if (m_home_cntrl_vec[i]->isHomeNode(line))
+            cntrls.push_back(m_home_cntrl_vec[i]);
+    }
+
+    m5::hash_map<Address, ControllerList>::const_iterator it =
+        m_line_owners.find(line);
+    if (it != m_line_owners.end())
+        cntrls.insert(cntrls.end(), it->second.begin(), it->second.end());
+}
+
 void
 RubySystem::registerSparseMemory(SparseMemory* s)
 {
@@ -356,6 +449,13 @@ RubySystem::startup()
     // Ruby finishes restoring the state is less than the time when the
     // state was checkpointed.
 
+    // Without a cache trace from a checkpoint, e.g. when restoring a
+    // checkpoint taken with the classic memory system, the caches can be
+    // warmed up from the packet traces of the sequencers instead.
+    if (!m_warmup_enabled) {
+        readWarmupTraces();
+    }
+
     if (m_warmup_enabled) {
         // save the current tick value
         Tick curtick_original = curTick();
@@ -389,11 +489,48 @@ RubySystem::startup()
     resetStats();
 }
 
+void
+RubySystem::readWarmupTraces()
+{
+    vector<Sequencer*> sequencer_map;
+    vector<string> trace_files;
+    Sequencer* t = NULL;
+    bool have_traces = false;
+    for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
+        Sequencer* seq = m_abs_cntrl_vec[cntrl]->getSequencer();
+        sequencer_map.push_back(seq);
+        trace_files.push_back(seq == NULL ? "" : seq->getWarmupTrace());
+        if (!trace_files[cntrl].empty()) have_traces = true;
+        if (t == NULL) t = seq;
+    }
+
+    if (!have_traces)
+        return;
+
+    for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
+        if (sequencer_map[cntrl] == NULL) {
+            sequencer_map[cntrl] = t;
+        }
+    }
+
+    DPRINTF(RubyCacheTrace, "Reading the warmup packet traces\n");
+    m_cache_recorder = new CacheRecorder(NULL, 0, sequencer_map,
+                                         getBlockSizeBytes());
+    m_cache_recorder->readPacketTraces(trace_files);
+
+    if (m_cache_recorder->hasRecords()) {
+        m_warmup_enabled = true;
+    } else {
+        delete m_cache_recorder;
+        m_cache_recorder = NULL;
+    }
+}
+
 void
 RubySystem::RubyEvent::process()
 {
     if (ruby_system->m_warmup_enabled) {
-        ruby_system->m_cache_recorder->enqueueNextFetchRequest();
+        ruby_system->m_cache_recorder->enqueueNextFetchRequest(NULL);
     }  else if (ruby_system->m_cooldown_enabled) {
         ruby_system->m_cache_recorder->enqueueNextFlushRequest();
     }
@@ -413,9 +550,16 @@ RubySystem::functionalRead(PacketPtr pkt)
     line_address.makeLineAddress();
 
     AccessPermission access_perm = AccessPermission_NotPresent;
-    int num_controllers = m_abs_cntrl_vec.size();
 
-    DPRINTF(RubySystem, "Functional Read request for %s\n",address);
+    // Only the home nodes and the controllers that made a transition
+    // to a valid state for the line can have a copy of it, all the
+    // other controllers are known to be invalid.
+    ControllerList cntrls;
+    getLineControllers(line_address, cntrls);
+    int num_controllers = cntrls.size();
+
+    DPRINTF(RubySystem, "Functional Read request for %s, %d controllers\n",
+            address, num_controllers);
 
     unsigned int num_ro = 0;
     unsigned int num_rw = 0;
@@ -426,7 +570,7 @@ RubySystem::functionalRead(PacketPtr pkt)
     // In this loop we count the number of controllers that have the given
     // address in read only, read write and busy states.
     for (unsigned int i = 0; i < num_controllers; ++i) {
-        access_perm = m_abs_cntrl_vec[i]-> getAccessPermission(line_address);
+        access_perm = cntrls[i]->getAccessPermission(line_address);
         if (access_perm == AccessPermission_Read_Only)
             num_ro++;
         else if (access_perm == AccessPermission_Read_Write)
@@ -461,13 +605,12 @@ RubySystem::functionalRead(PacketPtr pkt)
             num_backing_store == 1) {
         DPRINTF(RubySystem, "only copy in Backing_Store memory, read from it\n");
         for (unsigned int i = 0; i < num_controllers; ++i) {
-            access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_address);
+            access_perm = cntrls[i]->getAccessPermission(line_address);
             if (access_perm == AccessPermission_Backing_Store) {
-                DataBlock& block = m_abs_cntrl_vec[i]->
-                    getDataBlock(line_address);
+                DataBlock& block = cntrls[i]->getDataBlock(line_address);
 
                 DPRINTF(RubySystem, "reading from %s block %s\n",
-                        m_abs_cntrl_vec[i]->name(), block);
+                        cntrls[i]->name(), block);
                 for (unsigned j = 0; j < size_in_bytes; ++j) {
                     data[j] = block.getByte(j + startByte);
                 }
@@ -485,14 +628,13 @@ RubySystem::functionalRead(PacketPtr pkt)
         // a read write copy of the given address. Any valid copy would suffice
         // for a functional read.
         for (unsigned int i = 0;i < num_controllers;++i) {
-            access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_address);
+            access_perm = cntrls[i]->getAccessPermission(line_address);
             if (access_perm == AccessPermission_Read_Only ||
                 access_perm == AccessPermission_Read_Write) {
-                DataBlock& block = m_abs_cntrl_vec[i]->
-                    getDataBlock(line_address);
+                DataBlock& block = cntrls[i]->getDataBlock(line_address);
 
                 DPRINTF(RubySystem, "reading from %s block %s\n",
-                        m_abs_cntrl_vec[i]->name(), block);
+                        cntrls[i]->name(), block);
                 for (unsigned j = 0; j < size_in_bytes; ++j) {
                     data[j] = block.getByte(j + startByte);
                 }
@@ -504,19 +646,23 @@ RubySystem::functionalRead(PacketPtr pkt)
     return false;
 }
 
-// The function searches through all the buffers that exist in different
-// cache, directory and memory controllers, and in the network components
-// and writes the data portion of those that hold the address specified
-// in the packet.
+// The function writes the data blocks of the controllers that may hold
+// the address specified in the packet and, if any message for the line
+// is in flight, the data portion of the messages in the buffers of the
+// cache, directory and memory controllers and of the network.
 bool
 RubySystem::functionalWrite(PacketPtr pkt)
 {
     Address addr(pkt->getAddr());
     Address line_addr = line_address(addr);
     AccessPermission access_perm = AccessPermission_NotPresent;
-    int num_controllers = m_abs_cntrl_vec.size();
 
-    DPRINTF(RubySystem, "Functional Write request for %s\n",addr);
+    ControllerList cntrls;
+    getLineControllers(line_addr, cntrls);
+    int num_controllers = cntrls.size();
+
+    DPRINTF(RubySystem, "Functional Write request for %s, %d controllers\n",
+            addr, num_controllers);
 
     uint8_t *data = pkt->getPtr<uint8_t>(true);
     unsigned int size_in_bytes = pkt->getSize();
@@ -525,16 +671,13 @@ RubySystem::functionalWrite(PacketPtr pkt)
     uint32_t M5_VAR_USED num_functional_writes = 0;
 
     for (unsigned int i = 0; i < num_controllers;++i) {
-        num_functional_writes +=
-            m_abs_cntrl_vec[i]->functionalWriteBuffers(pkt);
-
-        access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_addr);
+        access_perm = cntrls[i]->getAccessPermission(line_addr);
         if (access_perm != AccessPermission_Invalid &&
             access_perm != AccessPermission_NotPresent) {
 
             num_functional_writes++;
 
-            DataBlock& block = m_abs_cntrl_vec[i]->getDataBlock(line_addr);
+            DataBlock& block = cntrls[i]->getDataBlock(line_addr);
             DPRINTF(RubySystem, "%s\n",block);
             for (unsigned j = 0; j < size_in_bytes; ++j) {
               block.setByte(j + startByte, data[j]);
@@ -543,12 +686,21 @@ RubySystem::functionalWrite(PacketPtr pkt)
         }
     }
 
-    for (unsigned int i = 0; i < m_memory_controller_vec.size() ;++i) {
-        num_functional_writes +=
-            m_memory_controller_vec[i]->functionalWriteBuffers(pkt);
-    }
+    // The buffers only need to be searched if a message that may carry
+    // data for the line exists
+    if (m_inflight_msgs.find(line_addr) != m_inflight_msgs.end()) {
+        for (unsigned int i = 0; i < m_abs_cntrl_vec.size(); ++i) {
+            num_functional_writes +=
+                m_abs_cntrl_vec[i]->functionalWriteBuffers(pkt);
+        }
 
-    num_functional_writes += m_network->functionalWrite(pkt);
+        for (unsigned int i = 0; i < m_memory_controller_vec.size() ;++i) {
+            num_functional_writes +=
+                m_memory_controller_vec[i]->functionalWriteBuffers(pkt);
+        }
+
+        num_functional_writes += m_network->functionalWrite(pkt);
+    }
     DPRINTF(RubySystem, "Messages written = %u\n", num_functional_writes);
 
     return true;
@@ -36,6 +36,7 @@
 #define __MEM_RUBY_SYSTEM_SYSTEM_HH__
 
 #include "base/callback.hh"
+#include "base/hashmap.hh"
 #include "base/output.hh"
 #include "mem/ruby/profiler/Profiler.hh"
 #include "mem/ruby/slicc_interface/AbstractController.hh"
@@ -110,6 +111,23 @@ class RubySystem : public ClockedObject
     void registerSparseMemory(SparseMemory*);
     void registerMemController(MemoryControl *mc);
 
+    //! Record the permission a controller has for a line after a
+    //! transition, keeping the functional access index up to date.
+    void updateLineOwner(const Address& line, AbstractController* cntrl,
+                         AccessPermission perm);
+    //! Install a line in the cache of a controller to warm it up, see
+    //! AbstractController::functionalInstall. The return value
+    //! indicates if the line was installed.
+    bool functionalInstall(int cntrl, const Address& line,
+                           RubyRequestType type, const DataBlock& data);
+    //! Count the messages that may carry data for a line.
+    void
+    incInflightMessages(const Address& line)
+    {
+        m_inflight_msgs[line]++;
+    }
+    void decInflightMessages(const Address& line);
+
     bool eventQueueEmpty() { return eventq->empty(); }
     void enqueueRubyEvent(Tick tick)
     {
@@ -127,6 +145,12 @@ class RubySystem : public ClockedObject
                              uint64& uncompressed_trace_size);
     void writeCompressedTrace(uint8_t *raw_data, std::string file,
                               uint64 uncompressed_trace_size);
+    //! Set up the warmup from the packet traces of the sequencers.
+    void readWarmupTraces();
+
+    typedef std::vector<AbstractController *> ControllerList;
+    //! Get the controllers that may have a copy of a line.
+    void getLineControllers(const Address& line, ControllerList& cntrls);
 
   private:
     // configuration parameters
@@ -141,6 +165,14 @@ class RubySystem : public ClockedObject
     std::vector<MemoryControl *> m_memory_controller_vec;
     std::vector<AbstractController *> m_abs_cntrl_vec;
 
+    //! Controllers with a directory, see AbstractController::isHomeNode
+    ControllerList m_home_cntrl_vec;
+    //! Controllers other than the home nodes that have a valid, busy or
+    //! backing store copy of each line
+    m5::hash_map<Address, ControllerList> m_line_owners;
+    //! Number of messages that may carry data for each line
+    m5::hash_map<Address, unsigned> m_inflight_msgs;
+
   public:
     Profiler* m_profiler;
     MemoryVector* m_mem_vec;
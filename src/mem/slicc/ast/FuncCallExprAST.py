@@ -141,11 +141,9 @@ class FuncCallExprAST(ExprAST):
         continue; // Check the first port again
     }
 
-    if (result == TransitionResult_ResourceStall) {
-        scheduleEvent(Cycles(1));
-
-        // Cannot do anything with this transition, go check next doable transition (mostly likely of next port)
-    }
+    // On a resource stall, the transition has arranged to be woken up
+    // once the resource may be available. Go check the next doable
+    // transition (most likely of the next port).
 }
 ''')
         elif self.proc_name == "error":
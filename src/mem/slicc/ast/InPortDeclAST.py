@@ -60,6 +60,7 @@ class InPortDeclAST(DeclAST):
         type = self.queue_type.type
         in_port = Var(self.symtab, self.ident, self.location, type, str(code),
                       self.pairs)
+        in_port.queue_type = queue_type
         symtab.newSymbol(in_port)
 
         symtab.pushFrame()
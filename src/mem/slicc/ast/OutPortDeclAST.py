@@ -57,4 +57,5 @@ class OutPortDeclAST(DeclAST):
 
         var = Var(self.symtab, self.ident, self.location, self.queue_type.type,
                   str(code), self.pairs)
+        var.queue_type = queue_type
         self.symtab.newSymbol(var)
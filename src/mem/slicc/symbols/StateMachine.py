@@ -59,6 +59,7 @@ class StateMachine(Symbol):
         self.config_parameters = config_parameters
 
         self.prefetchers = []
+        self.directories = []
 
         for param in config_parameters:
             if param.pointer:
@@ -73,6 +74,9 @@ class StateMachine(Symbol):
             if str(param.type_ast.type) == "Prefetcher":
                 self.prefetchers.append(var)
 
+            if str(param.type_ast.type) == "DirectoryMemory":
+                self.directories.append(param)
+
         self.states = orderdict()
         self.events = orderdict()
         self.actions = orderdict()
@@ -88,6 +92,11 @@ class StateMachine(Symbol):
         self.TBEType   = None
         self.EntryType = None
 
+    @property
+    def installsBlocks(self):
+        '''Machines that define installBlock() get functionalInstall()'''
+        return any(func.ident == "installBlock" for func in self.functions)
+
     def __repr__(self):
         return "[StateMachine: %s]" % self.ident
 
@@ -184,7 +193,7 @@ class StateMachine(Symbol):
         self.printControllerPython(path)
         self.printControllerHH(path)
         self.printControllerCC(path, includes)
-        self.printCSwitch(path)
+        self.printCSwitch(path, includes)
         self.printCWakeup(path, includes)
 
     def printControllerPython(self, path):
@@ -288,12 +297,30 @@ class $c_ident : public AbstractController
 
     bool functionalReadBuffers(PacketPtr&);
     uint32_t functionalWriteBuffers(PacketPtr&);
+''')
+
+        # Controllers with a directory are the home nodes of the lines
+        # their directory maps
+        if self.directories:
+            code('''
+    bool hasDirectory() const { return true; }
+    bool isHomeNode(const Address& addr);
+''')
 
+        if self.installsBlocks:
+            code('''
+    bool functionalInstall(const Address& addr, RubyRequestType type,
+                           const MachineID& requestor, const DataBlock& data);
+''')
+
+        code('''
     void countTransition(${ident}_State state, ${ident}_Event event);
     void possibleTransition(${ident}_State state, ${ident}_Event event);
     uint64 getEventCount(${ident}_Event event);
     bool isPossible(${ident}_State state, ${ident}_Event event);
     uint64 getTransitionCount(${ident}_State state, ${ident}_Event event);
+    double getTransitionHostSeconds(${ident}_State state,
+                                    ${ident}_Event event);
 
 private:
 ''')
@@ -339,12 +366,16 @@ TransitionResult doTransitionWorker(${ident}_Event event,
         code('''
                                     const Address& addr);
 
+void wakeUpRecycledMessages();
+
 int m_counters[${ident}_State_NUM][${ident}_Event_NUM];
 int m_event_counters[${ident}_Event_NUM];
 bool m_possible[${ident}_State_NUM][${ident}_Event_NUM];
+double m_host_seconds[${ident}_State_NUM][${ident}_Event_NUM];
 
 static std::vector<Stats::Vector *> eventVec;
 static std::vector<std::vector<Stats::Vector *> > transVec;
+static std::vector<std::vector<Stats::Vector *> > hostSecondsVec;
 static int m_num_controllers;
 
 // Internal functions
@@ -470,6 +501,7 @@ ${c_ident}Params::create()
 int $c_ident::m_num_controllers = 0;
 std::vector<Stats::Vector *>  $c_ident::eventVec;
 std::vector<std::vector<Stats::Vector *> >  $c_ident::transVec;
+std::vector<std::vector<Stats::Vector *> >  $c_ident::hostSecondsVec;
 
 // for adding information to the protocol debug trace
 stringstream ${ident}_transitionComment;
@@ -525,6 +557,7 @@ for (int state = 0; state < ${ident}_State_NUM; state++) {
     for (int event = 0; event < ${ident}_Event_NUM; event++) {
         m_possible[state][event] = false;
         m_counters[state][event] = 0;
+        m_host_seconds[state][event] = 0;
     }
 }
 for (int event = 0; event < ${ident}_Event_NUM; event++) {
@@ -764,6 +797,39 @@ $c_ident::regStats()
                 transVec[state].push_back(t);
             }
         }
+
+        // The stats are shared by all controllers of this type, so they
+        // are registered if any of them profiles its transitions
+        bool profile_transitions = false;
+        std::map<uint32_t, AbstractController *>::iterator it;
+        for (it = g_abs_controls[MachineType_${ident}].begin();
+             it != g_abs_controls[MachineType_${ident}].end(); ++it) {
+            if ((($c_ident *)(*it).second)->m_profile_transitions)
+                profile_transitions = true;
+        }
+
+        if (profile_transitions) {
+            for (${ident}_State state = ${ident}_State_FIRST;
+                 state < ${ident}_State_NUM; ++state) {
+
+                hostSecondsVec.push_back(std::vector<Stats::Vector *>());
+
+                for (${ident}_Event event = ${ident}_Event_FIRST;
+                     event < ${ident}_Event_NUM; ++event) {
+
+                    Stats::Vector *t = new Stats::Vector();
+                    t->init(m_num_controllers);
+                    t->name(g_system_ptr->name() + ".${c_ident}." +
+                            "host_seconds." +
+                            ${ident}_State_to_string(state) +
+                            "." + ${ident}_Event_to_string(event));
+                    t->desc("Host seconds spent in this transition");
+
+                    t->flags(Stats::total | Stats::oneline | Stats::nozero);
+                    hostSecondsVec[state].push_back(t);
+                }
+            }
+        }
     }
 }
 
@@ -796,6 +862,19 @@ $c_ident::collateStats()
             }
         }
     }
+
+    for (int state = 0; state < hostSecondsVec.size(); ++state) {
+        for (int event = 0; event < hostSecondsVec[state].size(); ++event) {
+            for (unsigned int i = 0; i < m_num_controllers; ++i) {
+                std::map<uint32_t, AbstractController *>::iterator it =
+                                g_abs_controls[MachineType_${ident}].find(i);
+                assert(it != g_abs_controls[MachineType_${ident}].end());
+                (*hostSecondsVec[state][event])[i] =
+                    (($c_ident *)(*it).second)->getTransitionHostSeconds(
+                        (${ident}_State)state, (${ident}_Event)event);
+            }
+        }
+    }
 }
 
 void
@@ -831,6 +910,13 @@ $c_ident::getTransitionCount(${ident}_State state,
     return m_counters[state][event];
 }
 
+double
+$c_ident::getTransitionHostSeconds(${ident}_State state,
+                                   ${ident}_Event event)
+{
+    return m_host_seconds[state][event];
+}
+
 int
 $c_ident::getNumControllers()
 {
@@ -860,6 +946,7 @@ void $c_ident::resetStats()
     for (int state = 0; state < ${ident}_State_NUM; state++) {
         for (int event = 0; event < ${ident}_Event_NUM; event++) {
             m_counters[state][event] = 0;
+            m_host_seconds[state][event] = 0;
         }
     }
 
@@ -924,68 +1011,29 @@ $c_ident::recordCacheTrace(int cntrl, CacheRecorder* tr)
         code('''
 }
 
-// Actions
-''')
-        if self.TBEType != None and self.EntryType != None:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, ${{self.EntryType.c_ident}}*& m_cache_entry_ptr, const Address& addr)
-{
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
-}
-
-''')
-        elif self.TBEType != None:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
+// Recycled messages are handled the same way until a transition changes
+// the state of this controller, so they wait for one
 void
-$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, const Address& addr)
+$c_ident::wakeUpRecycledMessages()
 {
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
-}
-
 ''')
-        elif self.EntryType != None:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(${{self.EntryType.c_ident}}*& m_cache_entry_ptr, const Address& addr)
-{
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
+        code.indent()
+        port_codes = []
+        for port in self.in_ports:
+            if port.queue_type.isBuffer and port.code not in port_codes:
+                port_codes.append(port.code)
+                code('${{port.code}}.reanalyzeRecycledMessages();')
+        code.dedent()
+        code('''
 }
 
+// Actions
 ''')
-        else:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(const Address& addr)
-{
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
-}
+        # With direct dispatch, the actions are defined along with the
+        # transitions so that they can be inlined into them
+        if not self.symtab.slicc.direct_dispatch:
+            self.printActions(code, "")
 
-''')
         for func in self.functions:
             code(func.generateCode())
 
@@ -1034,10 +1082,65 @@ $c_ident::functionalWriteBuffers(PacketPtr& pkt)
         code('''
     return num_functional_writes;
 }
+''')
+
+        if self.directories:
+            homes = " ||\n           ".join(["m_%s_ptr->isPresent(addr)" %
+                                            param.ident
+                                            for param in self.directories])
+            code('''
+bool
+$c_ident::isHomeNode(const Address& addr)
+{
+    return $homes;
+}
+''')
+
+        if self.installsBlocks:
+            code('''
+bool
+$c_ident::functionalInstall(const Address& addr, RubyRequestType type,
+                            const MachineID& requestor, const DataBlock& data)
+{
+    if (!installBlock(addr, type, requestor, data))
+        return false;
+
+    // Installing a line changes its permission like a transition would
+    g_system_ptr->updateLineOwner(addr, this, getAccessPermission(addr));
+    return true;
+}
 ''')
 
         code.write(path, "%s.cc" % c_ident)
 
+    def printActions(self, code, qualifier):
+        '''Output the definitions of the actions'''
+
+        c_ident = "%s_Controller" % self.ident
+
+        params = []
+        if self.TBEType != None:
+            params.append('%s*& m_tbe_ptr' % self.TBEType.c_ident)
+        if self.EntryType != None:
+            params.append('%s*& m_cache_entry_ptr' % self.EntryType.c_ident)
+        params.append('const Address& addr')
+        params = ', '.join(params)
+
+        for action in self.actions.itervalues():
+            if "c_code" not in action:
+                continue
+
+            code('''
+/** \\brief ${{action.desc}} */
+${qualifier}void
+$c_ident::${{action.ident}}($params)
+{
+    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
+    ${{action["c_code"]}}
+}
+
+''')
+
     def printCWakeup(self, path, includes):
         '''Output the wakeup loop for the events'''
 
@@ -1125,11 +1228,12 @@ ${ident}_Controller::wakeup()
 
         code.write(path, "%s_Wakeup.cc" % self.ident)
 
-    def printCSwitch(self, path):
+    def printCSwitch(self, path, includes):
         '''Output switch statement for transition table'''
 
         code = self.symtab.codeFormatter()
         ident = self.ident
+        direct_dispatch = self.symtab.slicc.direct_dispatch
 
         code('''
 // Auto generated C++ code started by $__file__:$__line__
@@ -1138,6 +1242,7 @@ ${ident}_Controller::wakeup()
 #include <cassert>
 
 #include "base/misc.hh"
+#include "base/time.hh"
 #include "base/trace.hh"
 #include "debug/ProtocolTrace.hh"
 #include "debug/RubyGenerated.hh"
@@ -1147,11 +1252,47 @@ ${ident}_Controller::wakeup()
 #include "mem/protocol/Types.hh"
 #include "mem/ruby/common/Global.hh"
 #include "mem/ruby/system/System.hh"
+''')
+
+        # With direct dispatch the actions are defined here, so this
+        # needs everything the actions in the controller file need
+        if direct_dispatch:
+            for include_path in includes:
+                code('#include "${{include_path}}"')
+
+            seen_types = set()
+            for var in self.objects:
+                if var.type.ident not in seen_types and \
+                   not var.type.isPrimitive:
+                    code('#include "mem/protocol/${{var.type.c_ident}}.hh"')
+                seen_types.add(var.type.ident)
+
+            code('''
+
+using namespace std;
 
+#ifndef NDEBUG
+#define APPEND_TRANSITION_COMMENT(str) (${ident}_transitionComment << str)
+#else
+#define APPEND_TRANSITION_COMMENT(str) do {} while (0)
+#endif
+''')
+
+        code('''
 #define HASH_FUN(state, event)  ((int(state)*${ident}_Event_NUM)+int(event))
 
 #define GET_TRANSITION_COMMENT() (${ident}_transitionComment.str())
 #define CLEAR_TRANSITION_COMMENT() (${ident}_transitionComment.str(""))
+''')
+
+        if direct_dispatch:
+            code('''
+
+// Actions
+''')
+            self.printActions(code, "inline ")
+
+        code('''
 
 TransitionResult
 ${ident}_Controller::doTransition(${ident}_Event event,
@@ -1186,6 +1327,10 @@ DPRINTF(RubyGenerated, "%s, Time: %lld, state: %s, event: %s, addr: %s\\n",
         *this, curCycle(), ${ident}_State_to_string(state),
         ${ident}_Event_to_string(event), addr);
 
+Time start_time;
+if (m_profile_transitions)
+    start_time.setTimer();
+
 TransitionResult result =
 ''')
         if self.TBEType != None and self.EntryType != None:
@@ -1204,6 +1349,12 @@ if (result == TransitionResult_Valid) {
             ${ident}_State_to_string(next_state));
     countTransition(state, event);
 
+    if (m_profile_transitions) {
+        Time end_time;
+        end_time.setTimer();
+        m_host_seconds[state][event] += end_time - start_time;
+    }
+
     DPRINTFR(ProtocolTrace, "%15d %3s %10s%20s %6s>%-6s %s %s\\n",
              curTick(), m_version, "${ident}",
              ${ident}_Event_to_string(event),
@@ -1226,7 +1377,11 @@ if (result == TransitionResult_Valid) {
             code('setState(addr, next_state);')
             code('setAccessPermission(addr, next_state);')
 
+        # Permissions only change with transitions, so this keeps the
+        # functional access index of the RubySystem up to date
         code('''
+g_system_ptr->updateLineOwner(addr, this,
+                              ${ident}_State_to_permission(next_state));
 } else if (result == TransitionResult_ResourceStall) {
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %s %s\\n",
              curTick(), m_version, "${ident}",
@@ -1267,12 +1422,17 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
         code('''
                                         const Address& addr)
 {
-    switch(HASH_FUN(state, event)) {
 ''')
 
         # This map will allow suppress generating duplicate code
         cases = orderdict()
 
+        # Actions that recycle the message at the head of an in port
+        recycle_actions = set()
+        for action in self.actions.itervalues():
+            if ".recycle()" in action.get("c_code", ""):
+                recycle_actions.add(action)
+
         for trans in self.transitions:
             case_string = "%s_State_%s, %s_Event_%s" % \
                 (self.ident, trans.state.ident, self.ident, trans.event.ident)
@@ -1290,16 +1450,30 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
             case_sorter = []
             res = trans.resources
             for key,val in res.iteritems():
-                val = '''
+                # A full message buffer frees up when its receiver
+                # dequeues a message. Other resources are freed by
+                # transitions, which are only triggered by messages that
+                # wake us up anyway.
+                if key.type.ident == "OutPort" and key.queue_type.isBuffer:
+                    val = '''
+if (!%s.areNSlotsAvailable(%s)) {
+    %s.wakeOnDequeue(this);
+    return TransitionResult_ResourceStall;
+}
+''' % (key.code, val, key.code)
+                else:
+                    val = '''
 if (!%s.areNSlotsAvailable(%s))
     return TransitionResult_ResourceStall;
 ''' % (key.code, val)
                 case_sorter.append(val)
 
             # Check all of the request_types for resource constraints
+            # A busy cache bank frees up by itself, so try again next cycle
             for request_type in request_types:
                 val = '''
 if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
+    scheduleEvent(Cycles(1));
     return TransitionResult_ResourceStall;
 }
 ''' % (self.ident, request_type.ident)
@@ -1337,6 +1511,13 @@ if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
                 else:
                     for action in actions:
                         case('${{action.ident}}(addr);')
+
+                # Only a transition that does more than recycle messages
+                # can change how the recycled messages are handled
+                if recycle_actions and \
+                   (trans.state != trans.nextState or
+                    not set(actions) <= recycle_actions):
+                    case('wakeUpRecycledMessages();')
                 case('return TransitionResult_Valid;')
 
             case = str(case)
@@ -1347,14 +1528,48 @@ if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
 
             cases[case].append(case_string)
 
-        # Walk through all of the unique code blocks and spit out the
-        # corresponding case statement elements
-        for case,transitions in cases.iteritems():
-            # Iterative over all the multiple transitions that share
-            # the same code
-            for trans in transitions:
-                code('  case HASH_FUN($trans):')
-            code('    $case\n')
+        if direct_dispatch:
+            # Number the unique code blocks and look the number up in a
+            # dense state x event table, so that the switch below becomes
+            # a jump table
+            index = {}
+            for i,(case,transitions) in enumerate(cases.iteritems()):
+                for trans in transitions:
+                    index[trans] = i
+
+            code('''
+    // The code block of each transition, or -1 if it is invalid
+    static const int transition_code[${ident}_State_NUM][${ident}_Event_NUM] = {
+''')
+            code.indent()
+            for state in self.states.itervalues():
+                row = []
+                for event in self.events.itervalues():
+                    trans = "%s_State_%s, %s_Event_%s" % \
+                        (ident, state.ident, ident, event.ident)
+                    row.append(str(index.get(trans, -1)))
+                code('    { $0 }, // $1', ', '.join(row), state.ident)
+            code.dedent()
+            code('''
+    };
+
+    switch(transition_code[state][event]) {
+''')
+            for i,(case,transitions) in enumerate(cases.iteritems()):
+                code('  case $i:')
+                code('    $case\n')
+        else:
+            code('''
+    switch(HASH_FUN(state, event)) {
+''')
+            # Walk through all of the unique code blocks and spit out the
+            # corresponding case statement elements
+            for case,transitions in cases.iteritems():
+                # Iterative over all the multiple transitions that share
+                # the same code
+                for trans in transitions:
+                    code('  case HASH_FUN($trans):')
+                code('    $case\n')
 
         code('''
       default:
@@ -241,20 +241,25 @@ $klass ${{self.c_ident}}$parent
         code('}')
 
         # ******** Copy constructor ********
+        # The members are copy constructed rather than default
+        # constructed and then assigned, so that members such as
+        # DataBlock are initialized only once.
         if not self.isGlobal:
             code('${{self.c_ident}}(const ${{self.c_ident}}&other)')
 
             # Call superclass constructor
+            inits = []
             if "interface" in self:
-                code('    : ${{self["interface"]}}(other)')
-
-            code('{')
-            code.indent()
+                inits.append('%s(other)' % self["interface"])
 
             for dm in self.data_members.values():
-                code('m_${{dm.ident}} = other.m_${{dm.ident}};')
+                if "abstract" not in dm:
+                    inits.append('m_%s(other.m_%s)' % (dm.ident, dm.ident))
 
-            code.dedent()
+            if inits:
+                code('    : $0', ', '.join(inits))
+
+            code('{')
             code('}')
 
         # ******** Full init constructor ********
@@ -294,6 +299,33 @@ clone() const
 }
 ''')
 
+        # Messages report the line they may hold data for, so that
+        # RubySystem can tell whether functional accesses need to scan
+        # the message buffers. The field tried first is the one the
+        # functionalWrite() methods of the protocols test.
+        if self.isMessage:
+            for field in ("LineAddress", "Addr", "PhysicalAddress"):
+                if field in self.data_members and \
+                   self.data_members[field].type.c_ident == "Address":
+                    code('''
+bool
+getFunctionalAddress(Address& addr) const
+{
+    addr = line_address(m_$field);
+    return true;
+}
+''')
+                    break
+            else:
+                # Functional accesses would never look at the data such
+                # a message carries
+                for dm in self.data_members.values():
+                    if dm.type.c_ident == "DataBlock":
+                        self.error("Message type %s carries data in %s " \
+                                   "but has no LineAddress, Addr or " \
+                                   "PhysicalAddress field", self.ident,
+                                   dm.ident)
+
         if not self.isGlobal:
             # const Get methods for each field
             code('// Const accessors methods for each field')
@@ -42,12 +42,194 @@
  * Definition of a snoop filter.
  */
 
+#include "base/intmath.hh"
 #include "base/misc.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
 #include "mem/snoop_filter.hh"
 #include "sim/system.hh"
 
+SnoopFilter::SnoopFilter(const SnoopFilterParams *p)
+    : SimObject(p), assoc(p->assoc), numSets(0), useCounter(0),
+      bloom(p->bloom_entries, p->bloom_hashes),
+      linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency)
+{
+    if (p->entries != 0) {
+        fatal_if(assoc == 0 || p->entries % assoc != 0,
+                 "%s: entries (%d) must be a multiple of assoc (%d)\n",
+                 name(), p->entries, assoc);
+        numSets = p->entries / assoc;
+        entries.resize(p->entries);
+    }
+}
+
+SnoopFilter::CountingBloomFilter::CountingBloomFilter(unsigned num_counters,
+                                                      unsigned num_hashes)
+    : counters(num_counters, 0), numHashes(num_hashes), indexBits(0)
+{
+    if (num_counters != 0) {
+        fatal_if(!isPow2(num_counters) || num_counters < 2,
+                 "Snoop filter Bloom size %d is not a power of 2\n",
+                 num_counters);
+        fatal_if(num_hashes == 0 || num_hashes > 4,
+                 "Snoop filter Bloom needs 1 to 4 hash functions\n");
+        indexBits = floorLog2(num_counters);
+    }
+}
+
+size_t
+SnoopFilter::CountingBloomFilter::index(Addr line_num, unsigned hash) const
+{
+    // multiplicative hashing with a different odd constant per
+    // function, using the high-order bits of the product
+    static const uint64_t mult[] = {
+        ULL(0x9e3779b97f4a7c15), ULL(0xc2b2ae3d27d4eb4f),
+        ULL(0x165667b19e3779f9), ULL(0xd6e8feb86659fd93)
+    };
+    return (line_num * mult[hash]) >> (64 - indexBits);
+}
+
+bool
+SnoopFilter::CountingBloomFilter::mayContain(Addr line_num) const
+{
+    for (unsigned h = 0; h < numHashes; ++h)
+        if (counters[index(line_num, h)] == 0)
+            return false;
+    return true;
+}
+
+void
+SnoopFilter::CountingBloomFilter::insert(Addr line_num)
+{
+    if (!enabled())
+        return;
+    for (unsigned h = 0; h < numHashes; ++h) {
+        uint8_t& counter = counters[index(line_num, h)];
+        if (counter != UINT8_MAX)
+            ++counter;
+    }
+}
+
+void
+SnoopFilter::CountingBloomFilter::remove(Addr line_num)
+{
+    if (!enabled())
+        return;
+    for (unsigned h = 0; h < numHashes; ++h) {
+        uint8_t& counter = counters[index(line_num, h)];
+        assert(counter != 0);
+        // a saturated counter has lost track of its population
+        if (counter != UINT8_MAX)
+            --counter;
+    }
+}
+
+SnoopFilter::SnoopItem*
+SnoopFilter::findItem(Addr line_addr)
+{
+    if (bloom.enabled() && !bloom.mayContain(line_addr / linesize)) {
+        bloomRejects++;
+        return NULL;
+    }
+
+    if (bounded()) {
+        unsigned set = (line_addr / linesize) % numSets;
+        for (unsigned way = 0; way < assoc; ++way) {
+            SnoopEntry& entry = entries[set * assoc + way];
+            if (entry.valid && entry.addr == line_addr) {
+                entry.lastUse = ++useCounter;
+                return &entry.item;
+            }
+        }
+        if (cachedLocations.empty())
+            return NULL;
+    }
+
+    auto sf_it = cachedLocations.find(line_addr);
+    return sf_it == cachedLocations.end() ? NULL : &sf_it->second;
+}
+
+SnoopFilter::SnoopItem&
+SnoopFilter::allocateItem(Addr line_addr, bool is_secure)
+{
+    bloom.insert(line_addr / linesize);
+
+    if (bounded()) {
+        unsigned set = (line_addr / linesize) % numSets;
+        SnoopEntry* victim = NULL;
+        for (unsigned way = 0; way < assoc; ++way) {
+            SnoopEntry& entry = entries[set * assoc + way];
+            if (!entry.valid) {
+                victim = &entry;
+                break;
+            }
+            // lines with in-flight requests cannot be replaced
+            if (!entry.item.requested &&
+                (!victim || entry.lastUse < victim->lastUse))
+                victim = &entry;
+        }
+
+        if (victim) {
+            if (victim->valid) {
+                replacements++;
+                bloom.remove(victim->addr / linesize);
+                if (victim->item.holder) {
+                    DPRINTF(SnoopFilter, "%s: replacing 0x%x, holders %x "
+                            "need invalidating\n", __func__, victim->addr,
+                            victim->item.holder);
+                    backInvalidations++;
+                    victims.push_back(Victim(victim->addr, victim->isSecure,
+                                      maskToPortList(victim->item.holder)));
+                }
+            }
+            victim->addr = line_addr;
+            victim->valid = true;
+            victim->isSecure = is_secure;
+            victim->lastUse = ++useCounter;
+            victim->item.requested = 0;
+            victim->item.holder = 0;
+            return victim->item;
+        }
+
+        // every way has a request in flight, spill the line
+        DPRINTF(SnoopFilter, "%s: set %d busy, 0x%x overflows\n",
+                __func__, set, line_addr);
+        overflows++;
+    }
+
+    // Create a new element through operator[]
+    return cachedLocations[line_addr];
+}
+
+SnoopFilter::SnoopItem*
+SnoopFilter::touchItem(Addr line_addr, bool is_secure)
+{
+    SnoopItem* sf_it = findItem(line_addr);
+    if (!sf_it && !bounded())
+        sf_it = &allocateItem(line_addr, is_secure);
+    return sf_it;
+}
+
+void
+SnoopFilter::releaseItem(Addr line_addr, const SnoopItem& item)
+{
+    if (!bounded() || item.requested || item.holder)
+        return;
+
+    bloom.remove(line_addr / linesize);
+
+    unsigned set = (line_addr / linesize) % numSets;
+    for (unsigned way = 0; way < assoc; ++way) {
+        SnoopEntry& entry = entries[set * assoc + way];
+        if (entry.valid && entry.addr == line_addr) {
+            entry.valid = false;
+            return;
+        }
+    }
+
+    cachedLocations.erase(line_addr);
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 {
@@ -56,11 +238,9 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
     SnoopMask req_port = portToMask(slave_port);
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
-    // Create a new element through operator[] and modify in-place
-    SnoopItem& sf_item = is_hit ? sf_it->second : cachedLocations[line_addr];
-    SnoopMask interested = sf_item.holder | sf_item.requested;
+    SnoopItem* sf_it = findItem(line_addr);
+    bool is_hit = (sf_it != NULL);
+    SnoopMask interested = is_hit ? (sf_it->holder | sf_it->requested) : 0;
 
     totRequests++;
     if (is_hit) {
@@ -69,30 +249,38 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
             hitSingleRequests++;
         else
             hitMultiRequests++;
-    }
 
-    DPRINTF(SnoopFilter, "%s:   SF value %x.%x\n",
-            __func__, sf_item.requested, sf_item.holder);
+        DPRINTF(SnoopFilter, "%s:   SF value %x.%x\n",
+                __func__, sf_it->requested, sf_it->holder);
+    } else if (!bounded()) {
+        // the unbounded filter tracks every line it sees
+        sf_it = &allocateItem(line_addr, cpkt->isSecure());
+    }
 
     if (cpkt->needsResponse()) {
         if (!cpkt->memInhibitAsserted()) {
+            // Allocate a new element if needed and modify in-place
+            SnoopItem& sf_item = sf_it ? *sf_it :
+                allocateItem(line_addr, cpkt->isSecure());
+
             // Max one request per address per port
             panic_if(sf_item.requested & req_port, "double request :( "\
                      "SF value %x.%x\n", sf_item.requested, sf_item.holder);
 
             // Mark in-flight requests to distinguish later on
             sf_item.requested |= req_port;
+            DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
+                    __func__,  sf_item.requested, sf_item.holder);
         } else {
             // NOTE: The memInhibit might have been asserted by a cache closer
             // to the CPU, already -> the response will not be seen by this
             // filter -> we do not need to keep the in-flight request, but make
             // sure that we know that that cluster has a copy
-            panic_if(!(sf_item.holder & req_port), "Need to hold the value!");
+            panic_if(!sf_it || !(sf_it->holder & req_port),
+                     "Need to hold the value!");
             DPRINTF(SnoopFilter, "%s:   not marking request. SF value %x.%x\n",
-                    __func__,  sf_item.requested, sf_item.holder);
+                    __func__,  sf_it->requested, sf_it->holder);
         }
-        DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
-                __func__,  sf_item.requested, sf_item.holder);
     }
     return snoopSelected(maskToPortList(interested & ~req_port), lookupLatency);
 }
@@ -106,7 +294,18 @@ SnoopFilter::updateRequest(const Packet* cpkt, const SlavePort& slave_port,
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
     SnoopMask req_port = portToMask(slave_port);
-    SnoopItem& sf_item  = cachedLocations[line_addr];
+    SnoopItem* sf_it = touchItem(line_addr, cpkt->isSecure());
+
+    if (!sf_it) {
+        // Nothing is tracked for this line: either a request that
+        // did not allocate, or a writeback of a line that a bounded
+        // filter has replaced, and thereby already invalidated
+        panic_if(!will_retry && cpkt->cmd == MemCmd::Writeback &&
+                 !bounded(), "requester %x is not a holder :( "\
+                 "SF value 0.0\n", req_port);
+        return;
+    }
+    SnoopItem& sf_item = *sf_it;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x retry: %i\n",
             __func__, sf_item.requested, sf_item.holder, will_retry);
@@ -114,6 +313,7 @@ SnoopFilter::updateRequest(const Packet* cpkt, const SlavePort& slave_port,
     if (will_retry) {
         // Unmark a request that will come again.
         sf_item.requested &= ~req_port;
+        releaseItem(line_addr, sf_item);
         return;
     }
 
@@ -125,9 +325,9 @@ SnoopFilter::updateRequest(const Packet* cpkt, const SlavePort& slave_port,
             // make sure that the sender actually had the line
             panic_if(sf_item.requested & req_port, "double request :( "\
                      "SF value %x.%x\n", sf_item.requested, sf_item.holder);
-            panic_if(!(sf_item.holder & req_port), "requester %x is not a "\
-                     "holder :( SF value %x.%x\n", req_port,
-                     sf_item.requested, sf_item.holder);
+            panic_if(!(sf_item.holder & req_port) && !bounded(),
+                     "requester %x is not a holder :( SF value %x.%x\n",
+                     req_port, sf_item.requested, sf_item.holder);
             // Writebacks -> the sender does not have the line anymore
             sf_item.holder &= ~req_port;
         } else {
@@ -135,6 +335,7 @@ SnoopFilter::updateRequest(const Packet* cpkt, const SlavePort& slave_port,
         }
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__,  sf_item.requested, sf_item.holder);
+        releaseItem(line_addr, sf_item);
     }
 }
 
@@ -153,26 +354,31 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         return snoopAll(lookupLatency);
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
-    // Create a new element through operator[] and modify in-place
-    SnoopItem& sf_item = is_hit ? sf_it->second : cachedLocations[line_addr];
+    SnoopItem* sf_it = findItem(line_addr);
+
+    totSnoops++;
+    assert(cpkt->isInvalidate() == cpkt->needsExclusive());
+
+    if (!sf_it) {
+        // Nobody above has or requested the line
+        DPRINTF(SnoopFilter, "%s:   SF miss\n", __func__);
+        if (!bounded())
+            allocateItem(line_addr, cpkt->isSecure());
+        return snoopDown(lookupLatency);
+    }
+    SnoopItem& sf_item = *sf_it;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
-    totSnoops++;
-    if (is_hit) {
-        // Single bit set -> value is a power of two
-        if (isPow2(interested))
-            hitSingleSnoops++;
-        else
-            hitMultiSnoops++;
-    }
+    // Single bit set -> value is a power of two
+    if (isPow2(interested))
+        hitSingleSnoops++;
+    else
+        hitMultiSnoops++;
 
-    assert(cpkt->isInvalidate() == cpkt->needsExclusive());
     if (cpkt->isInvalidate() && !sf_item.requested) {
         // Early clear of the holder, if no other request is currently going on
         // @todo: This should possibly be updated even though we do not filter
@@ -183,6 +389,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x interest: %x \n",
             __func__, sf_item.requested, sf_item.holder, interested);
 
+    releaseItem(line_addr, sf_item);
     return snoopSelected(maskToPortList(interested), lookupLatency);
 }
 
@@ -198,11 +405,16 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem* sf_it = findItem(line_addr);
 
     assert(cpkt->isResponse());
     assert(cpkt->memInhibitAsserted());
 
+    // The original request marked the line, so it must be tracked
+    panic_if(!sf_it, "SF missing line 0x%x of the original request\n",
+             line_addr);
+    SnoopItem& sf_item = *sf_it;
+
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
 
@@ -243,12 +455,17 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
             cpkt->cmdString());
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem* sf_it = touchItem(line_addr, cpkt->isSecure());
     SnoopMask rsp_mask M5_VAR_USED = portToMask(rsp_port);
 
     assert(cpkt->isResponse());
     assert(cpkt->memInhibitAsserted());
 
+    // Nothing to update if the line is not tracked
+    if (!sf_it)
+        return;
+    SnoopItem& sf_item = *sf_it;
+
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
 
@@ -262,6 +479,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     }
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
+    releaseItem(line_addr, sf_item);
 }
 
 void
@@ -272,14 +490,18 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
     SnoopMask slave_mask = portToMask(slave_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem* sf_it = findItem(line_addr);
 
     assert(cpkt->isResponse());
 
+    // Make sure we have seen the actual request, too
+    panic_if(!sf_it, "SF missing line 0x%x of the original request\n",
+             line_addr);
+    SnoopItem& sf_item = *sf_it;
+
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
 
-    // Make sure we have seen the actual request, too
     panic_if(!(sf_item.requested & slave_mask), "SF value %x.%x missing "\
              "request bit\n", sf_item.requested, sf_item.holder);
 
@@ -322,6 +544,24 @@ SnoopFilter::regStats()
         .name(name() + ".hit_multi_snoops")
         .desc("Number of snoops hitting in the snoop filter with multiple "\
               "(>1) holders of the requested data.");
+
+    bloomRejects
+        .name(name() + ".bloom_rejects")
+        .desc("Number of lookups rejected by the Bloom filter.");
+
+    replacements
+        .name(name() + ".replacements")
+        .desc("Number of tracked lines replaced in the bounded filter.");
+
+    backInvalidations
+        .name(name() + ".back_invalidations")
+        .desc("Number of replaced lines that required invalidating their "\
+              "holders.");
+
+    overflows
+        .name(name() + ".overflows")
+        .desc("Number of lines that did not fit in their set because all "\
+              "ways had requests in flight.");
 }
 
 SnoopFilter *
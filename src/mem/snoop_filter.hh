@@ -46,6 +46,7 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <utility>
+#include <vector>
 
 #include "base/hashmap.hh"
 #include "mem/packet.hh"
@@ -82,15 +83,33 @@
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
  *     requesting MSHRs track order between local requests and remote snoops
+ *
+ * By default the tracking structure is an unbounded hash map. When a
+ * number of entries is configured, lines are instead tracked in a
+ * set-associative array of that size. Replacing a line that still has
+ * holders requires invalidating those holders; the victims are
+ * collected by the filter and the enclosing crossbar performs the
+ * back-invalidations (see takeVictims()). Lines with in-flight
+ * requests are never replaced; if a whole set is busy the line spills
+ * into a small overflow map. Optionally, a counting Bloom filter in
+ * front of the tracking structure cheaply rejects lookups of lines
+ * that are not tracked at all.
  */
 class SnoopFilter : public SimObject {
   public:
     typedef std::vector<SlavePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams *p) : SimObject(p),
-        linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency)
-    {
-    }
+    SnoopFilter (const SnoopFilterParams *p);
+
+    /** A tracked line that was replaced and needs back-invalidating. */
+    struct Victim {
+        Addr addr;
+        bool isSecure;
+        SnoopList holders;
+        Victim(Addr _addr, bool is_secure, const SnoopList& _holders)
+            : addr(_addr), isSecure(is_secure), holders(_holders)
+        {}
+    };
 
     /**
      * Init a new snoop filter and tell it about all the slave ports of the
@@ -188,6 +207,20 @@ class SnoopFilter : public SimObject {
         return std::make_pair(empty , latency);
     }
 
+    /**
+     * Hand over the lines replaced since the last call. The caller is
+     * responsible for invalidating the copies held by the listed
+     * ports. Only a bounded snoop filter ever produces victims.
+     *
+     * @return Vector of the replaced lines and their holders.
+     */
+    std::vector<Victim> takeVictims()
+    {
+        std::vector<Victim> res;
+        res.swap(victims);
+        return res;
+    }
+
     virtual void regStats();
 
   protected:
@@ -221,8 +254,84 @@ class SnoopFilter : public SimObject {
     SnoopList maskToPortList(SnoopMask ports) const;
 
   private:
-    /** Simple hash set of cached addresses. */
+    /** One way of the set-associative tracking array. */
+    struct SnoopEntry {
+        Addr addr;
+        bool valid;
+        bool isSecure;
+        /** Last use, for LRU replacement. */
+        uint64_t lastUse;
+        SnoopItem item;
+        SnoopEntry() : addr(0), valid(false), isSecure(false), lastUse(0)
+        {
+            item.requested = 0;
+            item.holder = 0;
+        }
+    };
+
+    /**
+     * Counting Bloom filter over the tracked line addresses. Counters
+     * saturate, and a saturated counter is never decremented, so the
+     * filter may report false positives but never false negatives.
+     */
+    class CountingBloomFilter {
+      public:
+        CountingBloomFilter(unsigned num_counters, unsigned num_hashes);
+        bool enabled() const { return !counters.empty(); }
+        bool mayContain(Addr line_num) const;
+        void insert(Addr line_num);
+        void remove(Addr line_num);
+      private:
+        size_t index(Addr line_num, unsigned hash) const;
+        std::vector<uint8_t> counters;
+        const unsigned numHashes;
+        unsigned indexBits;
+    };
+
+    /**
+     * Find the tracking information of a line without allocating.
+     * @return Pointer to the item or NULL if the line is not tracked.
+     */
+    SnoopItem* findItem(Addr line_addr);
+
+    /**
+     * Start tracking a line that is not tracked yet, possibly
+     * replacing another line.
+     */
+    SnoopItem& allocateItem(Addr line_addr, bool is_secure);
+
+    /**
+     * Find the tracking information of a line. The unbounded filter
+     * keeps track of every line it has seen, and allocates the line
+     * if needed.
+     * @return Pointer to the item or NULL if the line is not tracked.
+     */
+    SnoopItem* touchItem(Addr line_addr, bool is_secure);
+
+    /**
+     * Stop tracking a line in the bounded filter once nobody requests
+     * or holds it.
+     */
+    void releaseItem(Addr line_addr, const SnoopItem& item);
+
+    /** Is the tracking structure bounded, i.e. set associative? */
+    bool bounded() const { return !entries.empty(); }
+
+    /** Simple hash set of cached addresses. When bounded, only holds
+     * lines that did not fit in their set. */
     m5::hash_map<Addr, SnoopItem> cachedLocations;
+    /** Set-associative tracking array, empty if unbounded. */
+    std::vector<SnoopEntry> entries;
+    /** Associativity of the tracking array. */
+    const unsigned assoc;
+    /** Number of sets in the tracking array. */
+    unsigned numSets;
+    /** Use counter driving LRU replacement. */
+    uint64_t useCounter;
+    /** Fast-reject front end. */
+    CountingBloomFilter bloom;
+    /** Lines replaced since the last call to takeVictims. */
+    std::vector<Victim> victims;
     /** List of all attached slave ports. */
     SnoopList slavePorts;
     /** Cache line size. */
@@ -238,6 +347,11 @@ class SnoopFilter : public SimObject {
     Stats::Scalar totSnoops;
     Stats::Scalar hitSingleSnoops;
     Stats::Scalar hitMultiSnoops;
+
+    Stats::Scalar bloomRejects;
+    Stats::Scalar replacements;
+    Stats::Scalar backInvalidations;
+    Stats::Scalar overflows;
 };
 
 inline SnoopFilter::SnoopMask
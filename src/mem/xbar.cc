@@ -56,7 +56,7 @@
 
 BaseXBar::BaseXBar(const BaseXBarParams *p)
     : MemObject(p),
-      headerCycles(p->header_cycles), width(p->width),
+      headerCycles(p->header_cycles), width(p->width), portDecoder(portMap),
       gotAddrRanges(p->port_default_connection_count +
                           p->port_master_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
@@ -313,18 +313,10 @@ BaseXBar::findPort(Addr addr)
     // ranges of all connected slave modules
     assert(gotAllAddrRanges);
 
-    // Check the cache
-    PortID dest_id = checkPortCache(addr);
-    if (dest_id != InvalidPortID)
-        return dest_id;
-
-    // Check the address map interval tree
-    auto i = portMap.find(addr);
-    if (i != portMap.end()) {
-        dest_id = i->second;
-        updatePortCache(dest_id, i->first);
-        return dest_id;
-    }
+    // Check the address map through its decode table
+    auto i = portDecoder.find(addr);
+    if (i != portMap.end())
+        return i->second;
 
     // Check if this matches the default range
     if (useDefaultRange) {
@@ -416,6 +408,11 @@ BaseXBar::recvRangeChange(PortID master_port_id)
         }
     }
 
+    // the decoder holds iterators into the port map, so rebuild it
+    // before anyone can look up an address again, and in particular
+    // before the range change is passed on to the ports above
+    portDecoder.build();
+
     // if we have received ranges from all our neighbouring slave
     // modules, go ahead and tell our connected master modules in
     // turn, this effectively assumes a tree structure of the system
@@ -503,8 +500,6 @@ BaseXBar::recvRangeChange(PortID master_port_id)
         for (const auto& s: slavePorts)
             s->sendRangeChange();
     }
-
-    clearPortCache();
 }
 
 AddrRangeList
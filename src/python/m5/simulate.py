@@ -170,6 +170,15 @@ def simulate(*args, **kwargs):
 def curTick():
     return internal.core.curTick()
 
+# The configuration hierarchy is fixed once instantiated, so the
+# objects below a root are only collected once. This keeps frequent
+# drains, e.g. when sampling with thousands of CPU switches, cheap.
+_descendants = {}
+def descendants(root):
+    if root not in _descendants:
+        _descendants[root] = list(root.descendants())
+    return _descendants[root]
+
 # Drain the system in preparation of a checkpoint or memory mode
 # switch.
 def drain(root):
@@ -180,7 +189,7 @@ def drain(root):
     def _drain():
         all_drained = False
         dm = internal.drain.createDrainManager()
-        unready_objs = sum(obj.drain(dm) for obj in root.descendants())
+        unready_objs = sum(obj.drain(dm) for obj in descendants(root))
         # If we've got some objects that can't drain immediately, then simulate
         if unready_objs > 0:
             dm.setCount(unready_objs)
@@ -199,15 +208,15 @@ def drain(root):
         all_drained = _drain()
 
 def memWriteback(root):
-    for obj in root.descendants():
+    for obj in descendants(root):
         obj.memWriteback()
 
 def memInvalidate(root):
-    for obj in root.descendants():
+    for obj in descendants(root):
         obj.memInvalidate()
 
 def resume(root):
-    for obj in root.descendants(): obj.drainResume()
+    for obj in descendants(root): obj.drainResume()
 
 def checkpoint(dir):
     root = objects.Root.getInstance()
@@ -219,12 +228,13 @@ def checkpoint(dir):
     internal.core.serializeAll(dir)
     resume(root)
 
-def _changeMemoryMode(system, mode):
+def _changeMemoryMode(system, mode, do_drain=True):
     if not isinstance(system, (objects.Root, objects.System)):
         raise TypeError, "Parameter of type '%s'.  Must be type %s or %s." % \
               (type(system), objects.Root, objects.System)
     if system.getMemoryMode() != mode:
-        drain(system)
+        if do_drain:
+            drain(system)
         system.setMemoryMode(mode)
     else:
         print "System already in target mode. Memory mode unchanged."
@@ -310,7 +320,8 @@ def switchCpus(system, cpuList, do_drain=True, verbose=True):
             memWriteback(system)
             memInvalidate(system)
 
-        _changeMemoryMode(system, memory_mode)
+        # The system has been drained above or by the caller
+        _changeMemoryMode(system, memory_mode, do_drain=False)
 
     for old_cpu, new_cpu in cpuList:
         new_cpu.takeOverFrom(old_cpu)
@@ -265,6 +265,13 @@ class ProbePointArg : public ProbePoint
                         listeners.end());
     }
 
+    /**
+     * @brief checks if there are any listeners, so that call sites can
+     *        skip preparing an argument nobody will look at.
+     * @return true if at least one listener is attached.
+     */
+    bool hasListeners() const { return !listeners.empty(); }
+
     /**
      * @brief called at the ProbePoint call site, passes arg to each listener.
      * @param arg the argument to pass to each listener.
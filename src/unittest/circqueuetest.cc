@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015 The gem5 contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/circular_queue.hh"
+#include "unittest/unittest.hh"
+
+using UnitTest::setCase;
+
+int
+main()
+{
+    setCase("push and pop");
+    CircularQueue<int> q(3);
+    EXPECT_EQ(q.capacity(), 4);
+    EXPECT_TRUE(q.empty());
+    for (int i = 0; i < 4; ++i)
+        q.push_back(i);
+    EXPECT_TRUE(q.full());
+    EXPECT_EQ(q.front(), 0);
+    EXPECT_EQ(q.back(), 3);
+    q.pop_front();
+    q.pop_back();
+    EXPECT_EQ(q.size(), 2);
+    EXPECT_EQ(q.front(), 1);
+    EXPECT_EQ(q.back(), 2);
+
+    setCase("stable iterators");
+    CircularQueue<int>::iterator it = q.begin();
+    ++it;
+    EXPECT_EQ(*it, 2);
+    // wrap around the end of the buffer
+    q.push_back(3);
+    q.push_back(4);
+    q.pop_front();
+    q.push_back(5);
+    EXPECT_EQ(*it, 2);
+    EXPECT_TRUE(q.begin() == it);
+    EXPECT_TRUE(q.full());
+    // and grow the buffer
+    q.push_back(6);
+    EXPECT_EQ(q.capacity(), 8);
+    EXPECT_EQ(*it, 2);
+    int expect = 2;
+    for (auto i = q.begin(); i != q.end(); ++i)
+        EXPECT_EQ(*i, expect++);
+    EXPECT_EQ(expect, 7);
+
+    setCase("truncate");
+    CircularQueue<int>::iterator squash = it;
+    squash++;
+    squash++;
+    q.truncate(squash);
+    EXPECT_EQ(q.size(), 2);
+    EXPECT_EQ(q.back(), 3);
+    EXPECT_TRUE(--q.end() == ++it);
+    EXPECT_FALSE(q.contains(squash.index()));
+    q.clear();
+    EXPECT_TRUE(q.empty());
+    EXPECT_TRUE(q.begin() == q.end());
+
+    return UnitTest::printResults();
+}
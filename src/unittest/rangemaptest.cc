@@ -42,7 +42,10 @@
 
 #include <cassert>
 #include <iostream>
+#include <random>
+#include <vector>
 
+#include "base/addr_range_decoder.hh"
 #include "base/addr_range_map.hh"
 
 using namespace std;
@@ -76,5 +79,88 @@ main()
     assert(i != r.end());
     cout << i->first.to_string() << " " << i->second << endl;
 
+    // the decoder has to agree with the interval tree, including for
+    // interleaved ranges, sub-page ranges and unmapped holes
+    AddrRangeMap<int> m;
+    for (int match = 0; match < 4; ++match)
+        m.insert(AddrRange(ULL(0x80000000), ULL(0xbfffffff), 7, 2, match),
+                 match);
+    m.insert(RangeSize(ULL(0x1c000000), 0x100), 4);
+    m.insert(RangeSize(ULL(0x1c000100), 0x100), 5);
+    m.insert(RangeSize(ULL(0x1c010000), 0x10000), 6);
+    m.insert(RangeSize(ULL(0x100000000), ULL(0x180000000)), 7);
+
+    AddrRangeDecoder<int> d(m);
+    d.build();
+
+    Addr probes[] = {
+        0x0, 0x1c000000, 0x1c0000ff, 0x1c000100, 0x1c000200, 0x1c00ffff,
+        0x1c010000, 0x1c01ffff, 0x1c020000, 0x7fffffff, 0x80000000,
+        0x80000040, 0x80000080, 0x800000c0, 0x80000100, 0xbfffffff,
+        0xc0000000, ULL(0x100000000), ULL(0x27fffffff), ULL(0x280000000)
+    };
+    for (auto a : probes) {
+        AddrRangeMap<int>::const_iterator t = m.find(a);
+        i = d.find(a);
+        assert(i == t);
+        if (i != m.end())
+            cout << hex << a << dec << " -> " << i->second << endl;
+    }
+
+    // random maps with an unaligned interleaved group, ranges smaller
+    // than a page, and ranges beyond the part covered by the root
+    // table, at most one range per 256 MB slot so that they never
+    // overlap; the map only supports a single interleaved group
+    std::mt19937_64 rng(1);
+    for (int iter = 0; iter < 50; ++iter) {
+        AddrRangeMap<int> rm;
+        std::vector<Addr> edges;
+        int value = 0;
+
+        uint8_t intlv_bits = 1 + rng() % 3;
+        uint8_t high_bit = 6 + intlv_bits + rng() % 20;
+        Addr intlv_slot = rng() % 64;
+        for (Addr slot = 0; slot < 64; ++slot) {
+            Addr base = slot < 60 ? slot << 28 : slot << 40;
+            Addr start = base + rng() % (ULL(1) << 27);
+            Addr end;
+            if (slot == intlv_slot) {
+                end = start + (ULL(1) << 24) + rng() % (ULL(1) << 26);
+                for (int m = 0; m < (1 << intlv_bits); ++m)
+                    rm.insert(AddrRange(start, end, high_bit, intlv_bits,
+                                        m), value++);
+            } else if (rng() % 3 == 0) {
+                continue;
+            } else {
+                end = start + rng() % (rng() % 2 ? 0x2000 : ULL(1) << 26);
+                i = rm.insert(AddrRange(start, end), value++);
+                assert(i != rm.end());
+            }
+            edges.push_back(start);
+            edges.push_back(end);
+        }
+
+        AddrRangeDecoder<int> rd(rm);
+        rd.build();
+
+        std::vector<Addr> addrs;
+        for (auto e : edges) {
+            for (Addr o = 0; o < 512; o += 8) {
+                addrs.push_back(e + o);
+                addrs.push_back(e - o);
+            }
+        }
+        for (int n = 0; n < 100000; ++n) {
+            addrs.push_back(rng() % (ULL(1) << 34));
+            addrs.push_back(rng() % (ULL(1) << 46));
+        }
+        for (auto a : addrs) {
+            if (rd.find(a) != rm.find(a)) {
+                cout << "Decoder mismatch at " << hex << a << dec << endl;
+                return 1;
+            }
+        }
+    }
+
     return 0;
 }
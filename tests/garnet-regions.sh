@@ -0,0 +1,84 @@
+#!/bin/sh
+# Copyright (c) 2015 The gem5 contributors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#
+# Runs the same workload on a fixed garnet mesh that is unpartitioned,
+# split into regions on one event queue, and split into regions that
+# run in parallel, and checks that all three runs give the same
+# statistics. Host statistics are left out of the comparison.
+#
+# Usage: garnet-regions.sh <gem5 binary> <test program> [<regions>]
+#
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 <gem5 binary> <test program> [<regions>]"
+    exit 1
+fi
+
+GEM5=$1
+PROG=$2
+REGIONS=${3:-2}
+
+TESTS_DIR=`dirname $0`
+SE_PY=$TESTS_DIR/../configs/example/se.py
+OUT_DIR=`mktemp -d`
+
+run() {
+    name=$1
+    shift
+    $GEM5 -d $OUT_DIR/$name $SE_PY --ruby --garnet-network=fixed \
+        --topology=Mesh --mesh-rows=2 --num-cpus=4 \
+        -c "$PROG;$PROG;$PROG;$PROG" "$@" > $OUT_DIR/$name.log 2>&1 || {
+        echo "$name run failed, see $OUT_DIR/$name.log"
+        exit 1
+    }
+    grep -v '^host_' $OUT_DIR/$name/stats.txt > $OUT_DIR/$name.stats
+}
+
+# A single region always runs on one event queue, but asking for it to
+# run in parallel gives it the same simulation quantum as the other runs
+run unpartitioned --network-regions=1 --network-parallel
+run partitioned --network-regions=$REGIONS
+run parallel --network-regions=$REGIONS --network-parallel
+
+status=0
+for name in partitioned parallel; do
+    if ! diff -q $OUT_DIR/unpartitioned.stats $OUT_DIR/$name.stats \
+        > /dev/null; then
+        echo "$name statistics differ from the unpartitioned run:"
+        diff $OUT_DIR/unpartitioned.stats $OUT_DIR/$name.stats | head -20
+        status=1
+    fi
+done
+
+if [ $status -eq 0 ]; then
+    echo "Statistics match"
+    rm -rf $OUT_DIR
+else
+    echo "Output left in $OUT_DIR"
+fi
+exit $status
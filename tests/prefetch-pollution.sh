@@ -0,0 +1,96 @@
+#!/bin/sh
+# Copyright (c) 2015 The gem5 contributors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#
+# Drives a small cache with a next-line prefetcher of a high degree
+# using random reads over a footprint larger than the cache, so that
+# prefetch fills keep displacing demand blocks that are referenced
+# again, and checks that the prefetcher counts polluting prefetches.
+#
+# Usage: prefetch-pollution.sh <gem5 binary>
+#
+
+if [ $# -lt 1 ]; then
+    echo "Usage: $0 <gem5 binary>"
+    exit 1
+fi
+
+GEM5=$1
+OUT_DIR=`mktemp -d`
+
+# 10 us of random 64 byte reads over 32 kB, one every 1 to 2 ns
+cat > $OUT_DIR/tgen.cfg <<CFG
+STATE 0 10000000 RANDOM 100 0 32768 64 1000 2000 0
+INIT 0
+TRANSITION 0 0 1
+CFG
+
+cat > $OUT_DIR/config.py <<CFG
+import m5
+from m5.objects import *
+
+system = System(membus = NoncoherentXBar(width = 16))
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = VoltageDomain())
+system.mem_ranges = [AddrRange('256MB')]
+
+system.tgen = TrafficGen(config_file = '$OUT_DIR/tgen.cfg')
+system.cache = BaseCache(size = '8kB', assoc = 2, hit_latency = 2,
+                         response_latency = 2, mshrs = 8,
+                         tgts_per_mshr = 8, is_top_level = True,
+                         prefetcher = TaggedPrefetcher(degree = 8))
+system.mem = SimpleMemory(range = system.mem_ranges[0])
+
+system.tgen.port = system.cache.cpu_side
+system.cache.mem_side = system.membus.slave
+system.mem.port = system.membus.master
+system.system_port = system.membus.slave
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+m5.simulate(10000000)
+CFG
+
+$GEM5 -d $OUT_DIR $OUT_DIR/config.py > $OUT_DIR/run.log 2>&1 || {
+    echo "Run failed, see $OUT_DIR/run.log"
+    exit 1
+}
+
+polluting=`awk '$1 == "system.cache.prefetcher.num_hwpf_polluting" \
+    { print $2 }' $OUT_DIR/stats.txt`
+
+if [ -n "$polluting" ] && [ "$polluting" -gt 0 ]; then
+    echo "Counted $polluting polluting prefetches"
+    rm -rf $OUT_DIR
+    exit 0
+fi
+
+echo "No polluting prefetches counted, output left in $OUT_DIR"
+exit 1
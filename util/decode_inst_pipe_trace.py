@@ -0,0 +1,143 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2015 The gem5 contributors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+# This script converts a protobuf instruction pipeline trace, as
+# written by the InstPipeTrace probe listener, to the O3PipeView text
+# format read by util/o3-pipeview.py. It assumes that protoc has been
+# executed and already generated the Python package for the
+# instruction pipeline messages. This can be done manually using:
+# protoc --python_out=. --proto_path=src/proto src/proto/inst_pipe.proto
+#
+# The trace is converted one instruction at a time, so the output can
+# be piped straight into o3-pipeview.py, e.g.:
+# util/decode_inst_pipe_trace.py m5out/system.cpu.trace.trc.gz - | \
+#     util/o3-pipeview.py -c 500 -o pipeview.out /dev/stdin
+
+import protolib
+import sys
+
+# Import the instruction pipeline proto definitions. If they are not
+# found, attempt to generate them automatically. This assumes that the
+# script is executed from the gem5 root.
+try:
+    import inst_pipe_pb2
+except:
+    print >>sys.stderr, \
+        "Did not find inst_pipe proto definitions, attempting to generate"
+    from subprocess import call
+    error = call(['protoc', '--python_out=util', '--proto_path=src/proto',
+                  'src/proto/inst_pipe.proto'])
+    if not error:
+        print >>sys.stderr, "Generated inst_pipe proto definitions"
+
+        try:
+            import google.protobuf
+        except:
+            print >>sys.stderr, "Please install Python protobuf module"
+            exit(-1)
+
+        import inst_pipe_pb2
+    else:
+        print >>sys.stderr, "Failed to import inst_pipe proto definitions"
+        exit(-1)
+
+# Stages in the order o3-pipeview.py expects them, retire and store
+# are printed on the same line
+stages = ['decode', 'rename', 'dispatch', 'issue', 'complete']
+
+def stage_tick(inst, stage):
+    """Returns the absolute tick of a stage, or 0 if never reached."""
+    if inst.HasField(stage):
+        return inst.fetch_tick + getattr(inst, stage)
+    return 0
+
+def main():
+    if len(sys.argv) != 3:
+        print "Usage: ", sys.argv[0], " <protobuf input> <ASCII output>"
+        print "Use - as the output to write to stdout"
+        exit(-1)
+
+    # Open the file in read mode
+    proto_in = protolib.openFileRd(sys.argv[1])
+
+    if sys.argv[2] == '-':
+        ascii_out = sys.stdout
+    else:
+        try:
+            ascii_out = open(sys.argv[2], 'w')
+        except IOError:
+            print "Failed to open ", sys.argv[2], " for writing"
+            exit(-1)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number != "gem5":
+        print >>sys.stderr, "Unrecognized file", sys.argv[1]
+        exit(-1)
+
+    header = inst_pipe_pb2.InstPipeHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print >>sys.stderr, "Object id:", header.obj_id
+    print >>sys.stderr, "Tick frequency:", header.tick_freq
+
+    num_insts = 0
+    inst = inst_pipe_pb2.InstPipe()
+
+    # The disassembly is only in the trace the first time an
+    # instruction is seen, so remember it for the later instances
+    disasm = {}
+
+    # Decode the instruction messages until we hit the end of the file
+    while protolib.decodeMessage(proto_in, inst):
+        num_insts += 1
+        key = (inst.pc, inst.upc)
+        if inst.HasField('disasm'):
+            disasm[key] = inst.disasm
+
+        ascii_out.write('O3PipeView:fetch:%d:0x%08x:%d:%d:%s\n' %
+                        (inst.fetch_tick, inst.pc, inst.upc, inst.seq_num,
+                         disasm.get(key, '(unknown)')))
+        for stage in stages:
+            ascii_out.write('O3PipeView:%s:%d\n' %
+                            (stage, stage_tick(inst, stage)))
+        ascii_out.write('O3PipeView:retire:%d:store:%d\n' %
+                        (stage_tick(inst, 'commit'),
+                         stage_tick(inst, 'store')))
+
+    print >>sys.stderr, "Parsed instructions:", num_insts
+
+    # We're done
+    if ascii_out is not sys.stdout:
+        ascii_out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()
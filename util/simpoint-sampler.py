@@ -0,0 +1,227 @@
+#! /usr/bin/env python
+
+# Copyright (c) 2015 The gem5 contributors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+# Parallel driver for SimPoint-based sampled simulation.
+#
+# Given an M5 command, this script will:
+# 1. Optionally run the command once with the atomic CPU, taking a
+#    checkpoint ahead of each SimPoint (--take).
+# 2. Restore every SimPoint checkpoint in a separate M5 process, with
+#    up to --jobs processes at a time. Each run simulates the warmup,
+#    resets the stats and simulates the SimPoint interval.
+# 3. Merge the stats of the intervals, weighted by the SimPoint
+#    weights, into <directory>/stats.txt and print the CPI estimate.
+#
+# Note that '--' must be used to separate the script options from the
+# M5 command line. The command line is used unchanged for the
+# restored runs, so it should select the detailed CPU and the memory
+# system to measure.
+#
+# This script relies on the SimPoint checkpoint options implemented in
+# configs/common/Simulation.py, so it works with commands based on the
+# se.py and fs.py scripts in configs/example.
+#
+# Example:
+#
+# util/simpoint-sampler.py -j 16 \
+#     -t bench.simpts,bench.weights,10000000,1000000 \
+#     -- build/X86/gem5.opt configs/example/se.py -c bench \
+#     --cpu-type=detailed --caches --l2cache
+#
+
+import os, sys, re
+import subprocess
+import optparse
+import multiprocessing
+
+parser = optparse.OptionParser()
+
+parser.add_option('-d', '--directory', default='simpoint-run',
+                  help='directory to put the runs and the merged stats in')
+parser.add_option('-c', '--checkpoint-dir', default=None,
+                  help='directory holding the SimPoint checkpoints ' \
+                      '(default: <directory>/cpt)')
+parser.add_option('-t', '--take', default=None,
+                  metavar='SIMPOINTS,WEIGHTS,INTERVAL,WARMUP',
+                  help='take the SimPoint checkpoints before restoring them')
+parser.add_option('-j', '--jobs', type='int',
+                  default=multiprocessing.cpu_count(),
+                  help='number of simulations to run in parallel')
+
+cpt_expr = re.compile('cpt\.simpoint_(\d+)_inst_(\d+)_weight_([\d\.e\-]+)' \
+                          '_interval_(\d+)_warmup_(\d+)$')
+
+def find_checkpoints(cptdir):
+    """Returns (index, weight) of the SimPoint checkpoints in cptdir in
+    the order Simulation.py numbers them for --checkpoint-restore."""
+    cpts = []
+    for dir in os.listdir(cptdir):
+        match = cpt_expr.match(dir)
+        if match:
+            cpts.append((int(match.group(1)), float(match.group(3))))
+    cpts.sort()
+    return cpts
+
+def read_stats(filename):
+    """Returns the numeric stats of the last dump in filename."""
+    stats = {}
+    for line in open(filename):
+        if line.startswith('---------- Begin Simulation Statistics'):
+            stats = {}
+            continue
+
+        fields = line.split()
+        if len(fields) < 2:
+            continue
+        try:
+            stats[fields[0]] = float(fields[1])
+        except ValueError:
+            pass
+    return stats
+
+def cpi(stats):
+    """Returns the CPI of the CPUs that committed instructions."""
+    cycles = 0.0
+    insts = 0.0
+    for name, value in stats.iteritems():
+        if not name.endswith('.committedInsts') or value == 0:
+            continue
+        cpu = name[:-len('.committedInsts')]
+        if cpu + '.numCycles' in stats:
+            cycles += stats[cpu + '.numCycles']
+            insts += value
+    return cycles / insts if insts else None
+
+def run_simpoint(job):
+    (m5_binary, m5_args, cptdir, top_dir, cpt_num, index) = job
+    mydir = os.path.join(top_dir, 'simpoint.%02d' % index)
+    restore_args = ['--checkpoint-dir', cptdir,
+                    '--checkpoint-restore', str(cpt_num),
+                    '--restore-simpoint-checkpoint']
+    code = subprocess.call([m5_binary, '-red', mydir] + m5_args +
+                           restore_args)
+
+    stats_file = os.path.join(mydir, 'stats.txt')
+    if code != 0 or not os.path.exists(stats_file):
+        return (index, code, None)
+    return (index, code, read_stats(stats_file))
+
+(options, args) = parser.parse_args()
+
+if len(args) < 2:
+    parser.error('an M5 binary and command line are required after --')
+
+top_dir = options.directory
+if not os.path.exists(top_dir):
+    os.makedirs(top_dir)
+
+cmd_echo = open(os.path.join(top_dir, 'command'), 'w')
+print >>cmd_echo, ' '.join(sys.argv)
+cmd_echo.close()
+
+m5_binary = args[0]
+m5_args = args[1:]
+
+cptdir = options.checkpoint_dir
+if cptdir is None:
+    cptdir = os.path.join(top_dir, 'cpt')
+
+if options.take:
+    print '===> Taking SimPoint checkpoints.'
+    take_args = ['--cpu-type=atomic', '--checkpoint-dir', cptdir,
+                 '--take-simpoint-checkpoints', options.take]
+    if not os.path.exists(cptdir):
+        os.makedirs(cptdir)
+    code = subprocess.call([m5_binary, '-red',
+                            os.path.join(top_dir, 'take')] +
+                           m5_args + take_args)
+    if code != 0:
+        print 'Error: taking the checkpoints failed with code', code
+        sys.exit(1)
+
+cpts = find_checkpoints(cptdir)
+if not cpts:
+    print 'Error: no SimPoint checkpoints found in', cptdir
+    sys.exit(1)
+
+weights = dict(cpts)
+jobs = [(m5_binary, m5_args, cptdir, top_dir, i + 1, index)
+        for i, (index, weight) in enumerate(cpts)]
+
+print '===> Running %d SimPoints, %d at a time.' % (len(jobs), options.jobs)
+pool = multiprocessing.Pool(options.jobs)
+results = {}
+for index, code, stats in pool.imap_unordered(run_simpoint, jobs):
+    if stats is None:
+        print '===> SimPoint %d failed with code %d.' % (index, code)
+    else:
+        print '===> SimPoint %d done.' % index
+        results[index] = stats
+pool.close()
+pool.join()
+
+if not results:
+    print 'Error: all SimPoints failed'
+    sys.exit(1)
+
+# Only the SimPoints that completed are merged, so their weights are
+# renormalised to cover the whole program
+total_weight = sum(weights[index] for index in results)
+missing = len(cpts) - len(results)
+if missing:
+    print 'Warning: %d SimPoints failed, covering %f of the weight' % \
+        (missing, 1.0 - total_weight)
+
+# A stat only makes it into the merged dump if every interval has it
+names = set.intersection(*[set(stats) for stats in results.values()])
+merged = open(os.path.join(top_dir, 'stats.txt'), 'w')
+print >>merged, '---------- Begin Simulation Statistics ----------'
+for name in sorted(names):
+    value = sum(weights[index] * stats[name]
+                for index, stats in results.iteritems()) / total_weight
+    print >>merged, '%-40s %20f   # weighted over %d SimPoints' % \
+        (name, value, len(results))
+print >>merged, '---------- End Simulation Statistics   ----------'
+merged.close()
+
+print '%-10s %-10s %s' % ('simpoint', 'weight', 'cpi')
+estimate = 0.0
+estimate_weight = 0.0
+for index in sorted(results):
+    interval_cpi = cpi(results[index])
+    if interval_cpi is None:
+        print '%-10d %-10f no instructions' % (index, weights[index])
+        continue
+    print '%-10d %-10f %f' % (index, weights[index], interval_cpi)
+    estimate += weights[index] * interval_cpi
+    estimate_weight += weights[index]
+
+if estimate_weight:
+    print 'Estimated CPI: %f' % (estimate / estimate_weight)
+print 'Merged stats written to', os.path.join(top_dir, 'stats.txt')